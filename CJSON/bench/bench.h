@@ -0,0 +1,62 @@
+#ifndef cJSON_bench_h
+#define cJSON_bench_h
+
+/* Each benchmark is a plain program built against the library with
+ * optimization,for example
+ *   cc -O2 -std=gnu99 bench_validate.c ../cJSON..c -lm -pthread
+ * and prints the throughput or time of the variants it compares,the best of
+ * BENCH_RUNS runs each. */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#if defined(_WIN32)
+#include<windows.h>
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS 5
+#endif
+
+//seconds from a monotonic clock
+static inline double bench_now(void){
+#if defined(_WIN32)
+    LARGE_INTEGER now;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&frequency);
+    return (double)now.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC,&now);
+    return (double)now.tv_sec+(double)now.tv_nsec*1e-9;
+#endif
+}
+
+/* An array of count event records of about 200 bytes,one per line with
+ * indented members if formatted. Returned with malloc,length receives the
+ * length without the '\0'. */
+static inline char *bench_records(const size_t count,const int formatted,size_t*const length){
+    const char *const format=formatted?
+        "%s\n\t{\n\t\t\"id\":\t%zu,\n\t\t\"user\":\t\"user%zu\",\n\t\t\"active\":\t%s,\n\t\t\"score\":\t%zu.%02zu,\n\t\t\"tags\":\t[\"alpha\", \"beta\", \"caf\\u00e9\"],\n\t\t\"geo\":\t{\n\t\t\t\"lat\":\t%zu.125,\n\t\t\t\"lon\":\t-%zu.5\n\t\t},\n\t\t\"text\":\t\"line %zu with \\\"quotes\\\" and a tab\\t\"\n\t}":
+        "%s{\"id\":%zu,\"user\":\"user%zu\",\"active\":%s,\"score\":%zu.%02zu,\"tags\":[\"alpha\",\"beta\",\"caf\\u00e9\"],\"geo\":{\"lat\":%zu.125,\"lon\":-%zu.5},\"text\":\"line %zu with \\\"quotes\\\" and a tab\\t\"}";
+    const size_t capacity=count*320+16;
+    char *const json=(char*)malloc(capacity);
+    size_t used=0;
+    size_t i=0;
+
+    if(json==NULL){
+        return NULL;
+    }
+    json[used++]='[';
+    for(i=0;i<count;i++){
+        used+=(size_t)snprintf(json+used,capacity-used,format,(i>0)?",":"",i,i%1000,(i%3)?"true":"false",i%100,i%97,i%90,i%180,i);
+    }
+    used+=(size_t)snprintf(json+used,capacity-used,formatted?"\n]\n":"]");
+    *length=used;
+
+    return json;
+}
+
+#endif
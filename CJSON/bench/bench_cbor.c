@@ -0,0 +1,64 @@
+#include"bench.h"
+#include"../cJSON.h"
+
+//CBOR encode and decode against cJSON_PrintUnformatted and cJSON_Parse on the same tree
+int main(int argc,char**argv){
+    const size_t count=(argc>1)?(size_t)strtoul(argv[1],NULL,10):100000;
+    size_t length=0;
+    char *const json=bench_records(count,0,&length);
+    cJSON *const tree=(json!=NULL)?cJSON_Parse(json):NULL;
+    unsigned char *cbor=NULL;
+    char *text=NULL;
+    size_t cbor_length=0;
+    double encode=1e9;
+    double decode=1e9;
+    double print=1e9;
+    double parse=1e9;
+    int run=0;
+
+    if(tree==NULL){
+        return 1;
+    }
+    for(run=0;run<BENCH_RUNS;run++){
+        cJSON *decoded=NULL;
+        double start=bench_now();
+
+        cbor=cJSON_EncodeCBOR(tree,&cbor_length);
+        start=bench_now()-start;
+        encode=(start<encode)?start:encode;
+
+        start=bench_now();
+        decoded=cJSON_DecodeCBOR(cbor,cbor_length,NULL);
+        start=bench_now()-start;
+        decode=(start<decode)?start:decode;
+        if(!cJSON_Compare(decoded,tree,1)){
+            fprintf(stderr,"the decoded tree differs\n");
+            return 1;
+        }
+        cJSON_Delete(decoded);
+        cJSON_free(cbor);
+
+        start=bench_now();
+        text=cJSON_PrintUnformatted(tree);
+        start=bench_now()-start;
+        print=(start<print)?start:print;
+
+        start=bench_now();
+        decoded=cJSON_Parse(text);
+        start=bench_now()-start;
+        parse=(start<parse)?start:parse;
+        cJSON_Delete(decoded);
+        cJSON_free(text);
+    }
+    printf("%zu records,%zu bytes of JSON,%zu of CBOR\n",count,length,cbor_length);
+    printf("encode CBOR      %8.2f ms\n",encode*1e3);
+    printf("decode CBOR      %8.2f ms\n",decode*1e3);
+    printf("round trip CBOR  %8.2f ms\n",(encode+decode)*1e3);
+    printf("print JSON       %8.2f ms\n",print*1e3);
+    printf("parse JSON       %8.2f ms\n",parse*1e3);
+    printf("round trip JSON  %8.2f ms\n",(print+parse)*1e3);
+
+    cJSON_Delete(tree);
+    free(json);
+    return 0;
+}
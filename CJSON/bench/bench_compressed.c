@@ -0,0 +1,129 @@
+/* Records of a compressed NDJSON file parsed as the blocks are decompressed,
+ * against decompressing the whole file into a buffer first. Built with the
+ * formats it reads,for example
+ *   cc -O2 -std=gnu99 -DCJSON_ZLIB -DCJSON_ZSTD bench_compressed.c ../cJSON_Compressed.c ../cJSON..c -lz -lzstd -lm -pthread
+ * and run from this directory it reads the bundled corpus: data/events.ndjson.gz
+ * and data/events.ndjson.zst hold the same 12000 event records. */
+#include"bench.h"
+#include"../cJSON_Compressed.h"
+
+#include<fcntl.h>
+#if defined(_WIN32)
+#include<io.h>
+#define open(path,flags) _open((path),(flags)|_O_BINARY)
+#define close _close
+#else
+#include<unistd.h>
+#endif
+
+//records of one pass,0 on error
+static size_t count_records(cJSON_ArrayStream*const records){
+    size_t count=0;
+    cJSON *record=NULL;
+
+    while((record=cJSON_ArrayStreamNext(records))!=NULL){
+        cJSON_Delete(record);
+        count++;
+    }
+    if(cJSON_ArrayStreamFailed(records,NULL)){
+        count=0;
+    }
+    cJSON_DeleteArrayStream(records);
+
+    return count;
+}
+
+static size_t streamed(const char*const path){
+    const int fd=open(path,O_RDONLY);
+    cJSON_Decompressor *input=NULL;
+    size_t count=0;
+
+    if(fd<0){
+        return 0;
+    }
+    input=cJSON_CreateDecompressorFd(fd);
+    if(input!=NULL){
+        count=count_records(cJSON_CreateRecordStreamReader(cJSON_DecompressorRead,input,0));
+        cJSON_DeleteDecompressor(input);
+    }
+    close(fd);
+
+    return count;
+}
+
+static size_t buffered(const char*const path,size_t*const length){
+    const int fd=open(path,O_RDONLY);
+    cJSON_Decompressor *input=NULL;
+    char *buffer=NULL;
+    size_t capacity=0;
+    size_t count=0;
+    size_t received=0;
+
+    *length=0;
+    if(fd<0){
+        return 0;
+    }
+    input=cJSON_CreateDecompressorFd(fd);
+    while(input!=NULL){
+        if(*length==capacity){
+            char *const grown=(char*)realloc(buffer,(capacity==0)?65536:capacity*2);
+            if(grown==NULL){
+                break;
+            }
+            buffer=grown;
+            capacity=(capacity==0)?65536:capacity*2;
+        }
+        received=cJSON_DecompressorRead(input,buffer+*length,capacity-*length);
+        if((received==0)||(received==(size_t)-1)){
+            break;
+        }
+        *length+=received;
+    }
+    if((input!=NULL)&&(received==0)){
+        count=count_records(cJSON_CreateRecordStream(buffer,*length,0));
+    }
+    cJSON_DeleteDecompressor(input);
+    free(buffer);
+    close(fd);
+
+    return count;
+}
+
+int main(int argc,char**argv){
+    static const char *const corpus[]={"data/events.ndjson.gz","data/events.ndjson.zst"};
+    const char *const *paths=(argc>1)?(const char*const*)(argv+1):corpus;
+    const int path_count=(argc>1)?argc-1:2;
+    int index=0;
+
+    for(index=0;index<path_count;index++){
+        double stream_time=1e9;
+        double buffer_time=1e9;
+        size_t length=0;
+        size_t count=0;
+        int run=0;
+
+        for(run=0;run<BENCH_RUNS;run++){
+            double start=bench_now();
+
+            count=streamed(paths[index]);
+            start=bench_now()-start;
+            stream_time=(start<stream_time)?start:stream_time;
+
+            start=bench_now();
+            if(buffered(paths[index],&length)!=count){
+                count=0;
+            }
+            start=bench_now()-start;
+            buffer_time=(start<buffer_time)?start:buffer_time;
+        }
+        if(count==0){
+            fprintf(stderr,"%s: cannot be read\n",paths[index]);
+            return 1;
+        }
+        printf("%s: %zu records,%zu bytes decompressed\n",paths[index],count,length);
+        printf("streamed           %8.1f MB/s\n",(double)length/stream_time/1e6);
+        printf("buffer then parse  %8.1f MB/s,holding %zu bytes\n",(double)length/buffer_time/1e6,length);
+    }
+
+    return 0;
+}
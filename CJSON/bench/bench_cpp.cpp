@@ -0,0 +1,63 @@
+#include"bench.h"
+#include"../cJSON.hpp"
+
+/* Parity of the C++ views with the C API: the same walk over 100k parsed
+ * records,reading three members of each,through cJSON_getObjectItemCaseSensitive
+ * and through cjson::value. Build like the C++ tests:
+ *   cc -O2 -std=gnu99 -c ../cJSON..c -o cJSON.o
+ *   c++ -O2 -std=c++17 bench_cpp.cpp cJSON.o -lm -pthread */
+
+static double walk_c(const cJSON*const root){
+    double sum=0;
+    for(const cJSON *record=root->child;record!=NULL;record=record->next){
+        sum+=cJSON_GetNumberValue(cJSON_getObjectItemCaseSensitive(record,"id"));
+        sum+=cJSON_GetNumberValue(cJSON_getObjectItemCaseSensitive(record,"score"));
+        sum+=(double)strlen(cJSON_GetStringValue(cJSON_getObjectItemCaseSensitive(record,"user")));
+    }
+    return sum;
+}
+
+static double walk_cpp(const cjson::value root){
+    double sum=0;
+    for(const cjson::value record:root){
+        sum+=record["id"].as_double();
+        sum+=record["score"].as_double();
+        sum+=(double)record["user"].as_string().size();
+    }
+    return sum;
+}
+
+int main(int argc,char**argv){
+    const size_t count=(argc>1)?(size_t)strtoul(argv[1],NULL,10):100000;
+    size_t length=0;
+    char *const json=bench_records(count,0,&length);
+    double c_time=1e9;
+    double cpp_time=1e9;
+    double c_sum=0;
+    double cpp_sum=0;
+
+    if(json==NULL){
+        return 1;
+    }
+    const cjson::document document=cjson::document::parse(std::string_view(json,length));
+    if(!document){
+        return 1;
+    }
+    for(int run=0;run<BENCH_RUNS;run++){
+        double start=bench_now();
+        c_sum=walk_c(document.get());
+        start=bench_now()-start;
+        c_time=(start<c_time)?start:c_time;
+
+        start=bench_now();
+        cpp_sum=walk_cpp(document.root());
+        start=bench_now()-start;
+        cpp_time=(start<cpp_time)?start:cpp_time;
+    }
+    printf("%zu records\n",count);
+    printf("C API         %8.2f ms\n",c_time*1e3);
+    printf("cjson::value  %8.2f ms\n",cpp_time*1e3);
+
+    free(json);
+    return (c_sum==cpp_sum)?0:1;
+}
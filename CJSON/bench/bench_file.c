@@ -0,0 +1,81 @@
+/* cJSON_ParseFile against reading the whole file with stdio and parsing the
+ * buffer,on a file of records written to the current directory and removed at
+ * the end. The second argument sets the threads given to cJSON_ParseFile. */
+#include"bench.h"
+#include"../cJSON.h"
+
+#define BENCH_FILE "bench_file.json"
+
+//read the file into a buffer,then parse it
+static cJSON *read_then_parse(const char*const path){
+    FILE *const file=fopen(path,"rb");
+    char *buffer=NULL;
+    long length=0;
+    cJSON *item=NULL;
+
+    if(file==NULL){
+        return NULL;
+    }
+    if((fseek(file,0,SEEK_END)==0)&&((length=ftell(file))>0)&&(fseek(file,0,SEEK_SET)==0)){
+        buffer=(char*)malloc((size_t)length);
+        if((buffer!=NULL)&&(fread(buffer,1,(size_t)length,file)==(size_t)length)){
+            item=cJSON_ParseWithFlags(buffer,(size_t)length,NULL,0);
+        }
+    }
+    free(buffer);
+    fclose(file);
+
+    return item;
+}
+
+int main(int argc,char**argv){
+    const size_t count=(argc>1)?(size_t)strtoul(argv[1],NULL,10):100000;
+    const int threads=(argc>2)?atoi(argv[2]):1;
+    size_t length=0;
+    char *const json=bench_records(count,0,&length);
+    FILE *file=NULL;
+    double mapped=1e9;
+    double buffered=1e9;
+    int run=0;
+
+    if(json==NULL){
+        return 1;
+    }
+    file=fopen(BENCH_FILE,"wb");
+    if((file==NULL)||(fwrite(json,1,length,file)!=length)||(fclose(file)!=0)){
+        fprintf(stderr,"cannot write %s\n",BENCH_FILE);
+        return 1;
+    }
+    free(json);
+
+    for(run=0;run<BENCH_RUNS;run++){
+        cJSON *item=NULL;
+        double start=bench_now();
+
+        item=cJSON_ParseFile(BENCH_FILE,0,threads,NULL);
+        start=bench_now()-start;
+        mapped=(start<mapped)?start:mapped;
+        if(cJSON_GetArraySize(item)!=(int)count){
+            fprintf(stderr,"cJSON_ParseFile failed\n");
+            return 1;
+        }
+        cJSON_Delete(item);
+
+        start=bench_now();
+        item=read_then_parse(BENCH_FILE);
+        start=bench_now()-start;
+        buffered=(start<buffered)?start:buffered;
+        if(cJSON_GetArraySize(item)!=(int)count){
+            fprintf(stderr,"reading %s failed\n",BENCH_FILE);
+            return 1;
+        }
+        cJSON_Delete(item);
+    }
+    remove(BENCH_FILE);
+
+    printf("%zu records,%zu bytes\n",count,length);
+    printf("cJSON_ParseFile,%d threads  %8.2f ms\n",threads,mapped*1e3);
+    printf("read then parse            %8.2f ms\n",buffered*1e3);
+
+    return 0;
+}
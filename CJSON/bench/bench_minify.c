@@ -0,0 +1,98 @@
+#include"bench.h"
+#include"../cJSON.h"
+
+//the byte at a time minifier cJSON had before,as the baseline
+static size_t minify_scalar(char*const json,const size_t length){
+    const char *input=json;
+    const char *const end=json+length;
+    char *output=json;
+
+    while(input<end){
+        switch(*input)
+        {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            input++;
+            break;
+        case '/':
+            if(((end-input)>1)&&(input[1]=='/')){
+                while((input<end)&&(*input!='\n')){
+                    input++;
+                }
+            }else if(((end-input)>1)&&(input[1]=='*')){
+                input+=2;
+                while(((end-input)>1)&&!((input[0]=='*')&&(input[1]=='/'))){
+                    input++;
+                }
+                input=((end-input)>1)?input+2:end;
+            }else{
+                *output++=*input++;
+            }
+            break;
+        case '\"':
+            *output++=*input++;
+            while((input<end)&&(*input!='\"')){
+                if((*input=='\\')&&((end-input)>1)){
+                    *output++=*input++;
+                }
+                *output++=*input++;
+            }
+            if(input<end){
+                *output++=*input++;
+            }
+            break;
+        default:
+            *output++=*input++;
+            break;
+        }
+    }
+
+    return (size_t)(output-json);
+}
+
+//cJSON_MinifyWithLength against the scalar loop on formatted records
+int main(int argc,char**argv){
+    const size_t count=(argc>1)?(size_t)strtoul(argv[1],NULL,10):100000;
+    size_t length=0;
+    char *const json=bench_records(count,1,&length);
+    char *const blocks=(char*)malloc(length);
+    char *const scalar=(char*)malloc(length);
+    size_t blocks_length=0;
+    size_t scalar_length=0;
+    double blocks_time=1e9;
+    double scalar_time=1e9;
+    int run=0;
+
+    if((json==NULL)||(blocks==NULL)||(scalar==NULL)){
+        return 1;
+    }
+    for(run=0;run<BENCH_RUNS;run++){
+        double start=0;
+
+        memcpy(blocks,json,length);
+        start=bench_now();
+        blocks_length=cJSON_MinifyWithLength(blocks,length);
+        start=bench_now()-start;
+        blocks_time=(start<blocks_time)?start:blocks_time;
+
+        memcpy(scalar,json,length);
+        start=bench_now();
+        scalar_length=minify_scalar(scalar,length);
+        start=bench_now()-start;
+        scalar_time=(start<scalar_time)?start:scalar_time;
+    }
+    if((blocks_length!=scalar_length)||(memcmp(blocks,scalar,blocks_length)!=0)){
+        fprintf(stderr,"the outputs differ\n");
+        return 1;
+    }
+    printf("%zu bytes,%zu minified\n",length,blocks_length);
+    printf("cJSON_MinifyWithLength  %8.1f MB/s\n",(double)length/blocks_time/1e6);
+    printf("scalar                  %8.1f MB/s\n",(double)length/scalar_time/1e6);
+
+    free(json);
+    free(blocks);
+    free(scalar);
+    return 0;
+}
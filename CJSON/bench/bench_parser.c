@@ -0,0 +1,92 @@
+/* A reused cJSON_Parser against cJSON_ParseWithFlags plus cJSON_Delete on many
+ * small messages,one record each. Allocations are counted through the hooks:
+ * after a first pass the parser is expected to parse every message without one. */
+#include"bench.h"
+#include"../cJSON.h"
+
+static size_t allocations=0;
+
+static void *counting_malloc(size_t size){
+    allocations++;
+    return malloc(size);
+}
+
+int main(int argc,char**argv){
+    const size_t count=(argc>1)?(size_t)strtoul(argv[1],NULL,10):100000;
+    cJSON_Hooks hooks={counting_malloc,free};
+    size_t length=0;
+    char *const json=bench_records(count,0,&length);
+    cJSON *const records=(json!=NULL)?cJSON_Parse(json):NULL;
+    char **messages=NULL;
+    size_t *lengths=NULL;
+    const cJSON *record=NULL;
+    cJSON_Parser *parser=NULL;
+    size_t index=0;
+    size_t once_allocations=0;
+    size_t reused_allocations=0;
+    double once=1e9;
+    double reused=1e9;
+    int run=0;
+
+    messages=(char**)calloc(count,sizeof(char*));
+    lengths=(size_t*)calloc(count,sizeof(size_t));
+    if((records==NULL)||(messages==NULL)||(lengths==NULL)){
+        return 1;
+    }
+    for(record=records->child,index=0;(record!=NULL)&&(index<count);record=record->next,index++){
+        messages[index]=cJSON_PrintUnformatted(record);
+        if(messages[index]==NULL){
+            return 1;
+        }
+        lengths[index]=strlen(messages[index]);
+    }
+    cJSON_Delete(records);
+    free(json);
+
+    cJSON_InitHooks(&hooks);
+    parser=cJSON_CreateParser(0,0);
+    //the first pass grows the parser's storage and interns the keys
+    for(index=0;index<count;index++){
+        if(cJSON_ParserParse(parser,messages[index],lengths[index],NULL)==NULL){
+            return 1;
+        }
+    }
+
+    for(run=0;run<BENCH_RUNS;run++){
+        double start=0;
+
+        allocations=0;
+        start=bench_now();
+        for(index=0;index<count;index++){
+            cJSON_Delete(cJSON_ParseWithFlags(messages[index],lengths[index],NULL,0));
+        }
+        start=bench_now()-start;
+        once=(start<once)?start:once;
+        once_allocations=allocations;
+
+        allocations=0;
+        start=bench_now();
+        for(index=0;index<count;index++){
+            if(cJSON_ParserParse(parser,messages[index],lengths[index],NULL)==NULL){
+                return 1;
+            }
+        }
+        start=bench_now()-start;
+        reused=(start<reused)?start:reused;
+        reused_allocations=allocations;
+    }
+    cJSON_DeleteParser(parser);
+    cJSON_InitHooks(NULL);
+
+    printf("%zu messages\n",count);
+    printf("cJSON_ParseWithFlags  %8.2f ms,%zu allocations\n",once*1e3,once_allocations);
+    printf("cJSON_ParserParse     %8.2f ms,%zu allocations\n",reused*1e3,reused_allocations);
+
+    for(index=0;index<count;index++){
+        cJSON_free(messages[index]);
+    }
+    free(messages);
+    free(lengths);
+    //the steady state is the point of the parser
+    return (reused_allocations==0)?0:1;
+}
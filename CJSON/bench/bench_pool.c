@@ -0,0 +1,66 @@
+#include"bench.h"
+#include"../cJSON.h"
+
+//parse the records,change every one of them and delete the tree,0 on error
+static size_t workload(const char*const json){
+    cJSON *const records=cJSON_Parse(json);
+    cJSON *record=NULL;
+    size_t count=0;
+
+    if(records==NULL){
+        return 0;
+    }
+    for(record=records->child;record!=NULL;record=record->next){
+        cJSON_AddStringToObject(record,"status","seen");
+        cJSON_ReplaceItemInObject(record,"score",cJSON_CreateNumber((double)count));
+        cJSON_DeleteItemFromObject(record,"tags");
+        count++;
+    }
+    cJSON_Delete(records);
+
+    return count;
+}
+
+static double best_time(const char*const json,const size_t count){
+    double best=1e9;
+    int run=0;
+
+    for(run=0;run<BENCH_RUNS;run++){
+        double start=bench_now();
+        if(workload(json)!=count){
+            return 0;
+        }
+        start=bench_now()-start;
+        best=(start<best)?start:best;
+    }
+
+    return best;
+}
+
+//cJSON_InitPooledHooks against malloc for parsing,changing and deleting records
+int main(int argc,char**argv){
+    const size_t count=(argc>1)?(size_t)strtoul(argv[1],NULL,10):100000;
+    size_t length=0;
+    char *const json=bench_records(count,0,&length);
+    double system=0;
+    double pooled=0;
+
+    if(json==NULL){
+        return 1;
+    }
+    system=best_time(json,count);
+    cJSON_InitPooledHooks();
+    pooled=best_time(json,count);
+    cJSON_PoolReleaseThread();
+    cJSON_InitHooks(NULL);
+    if((system==0)||(pooled==0)){
+        fprintf(stderr,"the records cannot be parsed\n");
+        return 1;
+    }
+    printf("%zu records,%zu bytes\n",count,length);
+    printf("malloc  %8.2f ms\n",system*1e3);
+    printf("pooled  %8.2f ms\n",pooled*1e3);
+
+    free(json);
+    return 0;
+}
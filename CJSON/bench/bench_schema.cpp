@@ -0,0 +1,70 @@
+#include"bench.h"
+#include"../cJSON_Schema.hpp"
+
+#include<string>
+#include<string_view>
+#include<vector>
+
+/* The schema parser against the general binder and the tree parser on 100k
+ * records. Build like the C++ tests:
+ *   cc -O2 -std=gnu99 -c ../cJSON..c -o cJSON.o
+ *   c++ -O2 -std=c++17 bench_schema.cpp cJSON.o -lm -pthread */
+
+struct geo{
+    double lat;
+    double lon;
+};
+CJSON_BINDING(geo,CJSON_FIELD(geo,lat),CJSON_FIELD(geo,lon))
+
+struct record{
+    long long id;
+    std::string user;
+    bool active;
+    double score;
+    std::vector<std::string> tags;
+    geo position;
+    std::string text;
+};
+CJSON_BINDING(record,CJSON_REQUIRED(record,id),CJSON_FIELD(record,user),CJSON_FIELD(record,active),CJSON_FIELD(record,score),
+    CJSON_FIELD(record,tags),::cjson::field("geo",&record::position),CJSON_FIELD(record,text))
+
+template<typename Function>
+static double best(Function&&function){
+    double fastest=1e9;
+    for(int run=0;run<BENCH_RUNS;run++){
+        double start=bench_now();
+        if(!function()){
+            return 0;
+        }
+        start=bench_now()-start;
+        fastest=(start<fastest)?start:fastest;
+    }
+    return fastest;
+}
+
+int main(int argc,char**argv){
+    const size_t count=(argc>1)?(size_t)strtoul(argv[1],NULL,10):100000;
+    size_t length=0;
+    char *const json=bench_records(count,0,&length);
+    std::vector<record> records;
+
+    if(json==NULL){
+        return 1;
+    }
+    const std::string_view text(json,length);
+    const double schema=best([&]{ return cjson::parse_with_schema(text,records)&&(records.size()==count); });
+    const double bind=best([&]{ return cjson::from_json(text,records)&&(records.size()==count); });
+    const double tree=best([&]{
+        cJSON *const item=cJSON_ParseWithFlags(json,length,NULL,0);
+        cJSON_Delete(item);
+        return item!=NULL;
+    });
+
+    printf("%zu bytes\n",length);
+    printf("parse_with_schema  %8.1f MB/s\n",(double)length/schema/1e6);
+    printf("from_json          %8.1f MB/s\n",(double)length/bind/1e6);
+    printf("parse+delete       %8.1f MB/s\n",(double)length/tree/1e6);
+
+    free(json);
+    return ((schema>0)&&(bind>0)&&(tree>0))?0:1;
+}
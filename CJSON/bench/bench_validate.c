@@ -0,0 +1,41 @@
+#include"bench.h"
+#include"../cJSON.h"
+
+//cJSON_Validate against cJSON_Parse plus cJSON_Delete on the same records
+int main(int argc,char**argv){
+    const size_t count=(argc>1)?(size_t)strtoul(argv[1],NULL,10):100000;
+    size_t length=0;
+    char *const json=bench_records(count,0,&length);
+    double validate=1e9;
+    double parse=1e9;
+    int run=0;
+
+    if(json==NULL){
+        return 1;
+    }
+    for(run=0;run<BENCH_RUNS;run++){
+        double start=bench_now();
+        cJSON *item=NULL;
+
+        if(!cJSON_Validate(json,length,NULL)){
+            return 1;
+        }
+        start=bench_now()-start;
+        validate=(start<validate)?start:validate;
+
+        start=bench_now();
+        item=cJSON_ParseWithFlags(json,length,NULL,0);
+        if(item==NULL){
+            return 1;
+        }
+        cJSON_Delete(item);
+        start=bench_now()-start;
+        parse=(start<parse)?start:parse;
+    }
+    printf("%zu bytes\n",length);
+    printf("validate      %8.1f MB/s\n",(double)length/validate/1e6);
+    printf("parse+delete  %8.1f MB/s\n",(double)length/parse/1e6);
+
+    free(json);
+    return 0;
+}
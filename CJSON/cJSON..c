@@ -17,6 +17,46 @@
 #include<stdlib.h>
 #include<limits.h>
 #include<ctype.h>
+#include<stdint.h>
+
+//block scanning uses SSE2/AVX2 when the compiler targets them,define CJSON_NO_SIMD to force the portable path
+#if !defined(CJSON_NO_SIMD)&&defined(__AVX2__)
+#define CJSON_SIMD_AVX2
+#include<immintrin.h>
+#elif !defined(CJSON_NO_SIMD)&&(defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&(_M_IX86_FP>=2)))
+#define CJSON_SIMD_SSE2
+#include<emmintrin.h>
+#endif
+
+//UTF-8 validation also needs byte shuffles,from SSSE3 (AVX2 includes them)
+#if defined(CJSON_SIMD_AVX2)||(defined(CJSON_SIMD_SSE2)&&defined(__SSSE3__))
+#define CJSON_SIMD_SHUFFLE
+#include<tmmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include<intrin.h>
+#endif
+
+#if defined(_WIN32)
+#include<io.h>
+#include<fcntl.h>
+#include<sys/stat.h>
+#else
+#include<unistd.h>
+#include<errno.h>
+#include<fcntl.h>
+#include<sys/stat.h>
+#include<sys/mman.h>
+#endif
+
+//cJSON_PrintParallel only uses threads if CJSON_PARALLEL is defined,the pooled
+//allocator hooks thread exit in any case; link with -pthread where libc needs it
+#if defined(_WIN32)
+#include<windows.h>
+#else
+#include<pthread.h>
+#endif
 
 #ifdef ENABLE_LOCALES
 #include<locale.h>
@@ -135,8 +175,15 @@ static unsigned char* cJSON_strdup(const unsigned char* string,const internal_ho
     return copy;
 }
 
+static cJSON_bool pool_holds_memory(void);
+
 CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks *hooks){
-    if(hooks=NULL){
+    //blocks of the pooled allocator can only be freed by it
+    if(pool_holds_memory()){
+        return;
+    }
+
+    if(hooks==NULL){
         //Reset hook
         global_hooks.allocate=malloc;
         global_hooks.deallcoate=free;
@@ -149,6 +196,11 @@ CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks *hooks){
         global_hooks.allocate=hooks->malloc_fn;
     }
 
+    global_hooks.deallcoate=free;
+    if(hooks->free_fn!=NULL){
+        global_hooks.deallcoate=hooks->free_fn;
+    }
+
     //use realloc only if both free and malloc are used
     global_hooks.realloccate=NULL;
     if((global_hooks.allocate==malloc)&&(global_hooks.deallcoate==free)){
@@ -156,22 +208,327 @@ CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks *hooks){
     }
 }
 
+//atomic operations for counters and pointers shared between threads
+#if defined(__GNUC__)||defined(__clang__)
+#define atomic_load_size(pointer) __atomic_load_n((pointer),__ATOMIC_SEQ_CST)
+#define atomic_store_size(pointer,value) __atomic_store_n((pointer),(value),__ATOMIC_SEQ_CST)
+#define atomic_add_size(pointer,value) __atomic_add_fetch((pointer),(value),__ATOMIC_SEQ_CST)
+#define atomic_sub_size(pointer,value) __atomic_sub_fetch((pointer),(value),__ATOMIC_SEQ_CST)
+#define atomic_exchange_size(pointer,value) __atomic_exchange_n((pointer),(value),__ATOMIC_SEQ_CST)
+#define atomic_load_pointer(pointer) __atomic_load_n((pointer),__ATOMIC_SEQ_CST)
+#define atomic_exchange_pointer(pointer,value) __atomic_exchange_n((pointer),(value),__ATOMIC_SEQ_CST)
+#define atomic_compare_exchange_pointer(pointer,expected,value) __atomic_compare_exchange_n((pointer),&(expected),(value),false,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST)
+#elif defined(_MSC_VER)&&defined(_WIN64)
+#define atomic_load_size(pointer) ((size_t)_InterlockedOr64((volatile __int64*)(pointer),0))
+#define atomic_store_size(pointer,value) ((void)_InterlockedExchange64((volatile __int64*)(pointer),(__int64)(value)))
+#define atomic_add_size(pointer,value) ((size_t)_InterlockedExchangeAdd64((volatile __int64*)(pointer),(__int64)(value))+(value))
+#define atomic_sub_size(pointer,value) ((size_t)_InterlockedExchangeAdd64((volatile __int64*)(pointer),-(__int64)(value))-(value))
+#define atomic_exchange_size(pointer,value) ((size_t)_InterlockedExchange64((volatile __int64*)(pointer),(__int64)(value)))
+#define atomic_load_pointer(pointer) _InterlockedCompareExchangePointer((void*volatile*)(pointer),NULL,NULL)
+#define atomic_exchange_pointer(pointer,value) _InterlockedExchangePointer((void*volatile*)(pointer),(value))
+#define atomic_compare_exchange_pointer(pointer,expected,value) cjson_compare_exchange_pointer((void*volatile*)(pointer),(void**)&(expected),(value))
+#elif defined(_MSC_VER)
+#define atomic_load_size(pointer) ((size_t)_InterlockedOr((volatile long*)(pointer),0))
+#define atomic_store_size(pointer,value) ((void)_InterlockedExchange((volatile long*)(pointer),(long)(value)))
+#define atomic_add_size(pointer,value) ((size_t)_InterlockedExchangeAdd((volatile long*)(pointer),(long)(value))+(value))
+#define atomic_sub_size(pointer,value) ((size_t)_InterlockedExchangeAdd((volatile long*)(pointer),-(long)(value))-(value))
+#define atomic_exchange_size(pointer,value) ((size_t)_InterlockedExchange((volatile long*)(pointer),(long)(value)))
+#define atomic_load_pointer(pointer) _InterlockedCompareExchangePointer((void*volatile*)(pointer),NULL,NULL)
+#define atomic_exchange_pointer(pointer,value) _InterlockedExchangePointer((void*volatile*)(pointer),(value))
+#define atomic_compare_exchange_pointer(pointer,expected,value) cjson_compare_exchange_pointer((void*volatile*)(pointer),(void**)&(expected),(value))
+#else
+//no atomic operations known for this compiler,the library is then only safe from one thread
+#define atomic_load_size(pointer) (*(pointer))
+#define atomic_store_size(pointer,value) ((void)(*(pointer)=(value)))
+#define atomic_add_size(pointer,value) (*(pointer)+=(value))
+#define atomic_sub_size(pointer,value) (*(pointer)-=(value))
+#define atomic_exchange_size(pointer,value) cjson_exchange_size((pointer),(value))
+#define atomic_load_pointer(pointer) (*(pointer))
+#define atomic_exchange_pointer(pointer,value) cjson_exchange_pointer((void**)(pointer),(value))
+#define atomic_compare_exchange_pointer(pointer,expected,value) (*(pointer)=(value),true)
+static size_t cjson_exchange_size(size_t*const pointer,const size_t value){
+    const size_t previous=*pointer;
+    *pointer=value;
+    return previous;
+}
+static void *cjson_exchange_pointer(void**const pointer,void*const value){
+    void *const previous=*pointer;
+    *pointer=value;
+    return previous;
+}
+#endif
+
+//the same for the int counters kept in items
+#if defined(__GNUC__)||defined(__clang__)
+#define atomic_load_int(pointer) __atomic_load_n((pointer),__ATOMIC_SEQ_CST)
+#define atomic_add_int(pointer,value) __atomic_add_fetch((pointer),(value),__ATOMIC_SEQ_CST)
+#define atomic_or_int(pointer,value) __atomic_or_fetch((pointer),(value),__ATOMIC_SEQ_CST)
+#define atomic_and_int(pointer,value) __atomic_and_fetch((pointer),(value),__ATOMIC_SEQ_CST)
+#define atomic_compare_exchange_int(pointer,expected,value) __atomic_compare_exchange_n((pointer),&(expected),(value),false,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST)
+#elif defined(_MSC_VER)
+#define atomic_load_int(pointer) ((int)_InterlockedOr((volatile long*)(pointer),0))
+#define atomic_add_int(pointer,value) ((int)_InterlockedExchangeAdd((volatile long*)(pointer),(long)(value))+(value))
+#define atomic_or_int(pointer,value) ((int)_InterlockedOr((volatile long*)(pointer),(long)(value))|(value))
+#define atomic_and_int(pointer,value) ((int)_InterlockedAnd((volatile long*)(pointer),(long)(value))&(value))
+#define atomic_compare_exchange_int(pointer,expected,value) cjson_compare_exchange_int((volatile long*)(pointer),&(expected),(value))
+#else
+#define atomic_load_int(pointer) (*(pointer))
+#define atomic_add_int(pointer,value) (*(pointer)+=(value))
+#define atomic_or_int(pointer,value) (*(pointer)|=(value))
+#define atomic_and_int(pointer,value) (*(pointer)&=(value))
+#define atomic_compare_exchange_int(pointer,expected,value) (*(pointer)=(value),true)
+#endif
+
+#if defined(_MSC_VER)
+//like __atomic_compare_exchange_n: on failure expected receives the current value
+static cJSON_bool cjson_compare_exchange_pointer(void*volatile*const pointer,void**const expected,void*const value){
+    void *const previous=_InterlockedCompareExchangePointer(pointer,value,*expected);
+    if(previous==*expected){
+        return true;
+    }
+    *expected=previous;
+    return false;
+}
+
+static cJSON_bool cjson_compare_exchange_int(volatile long*const pointer,int*const expected,const int value){
+    const long previous=_InterlockedCompareExchange(pointer,(long)value,(long)*expected);
+    if(previous==(long)*expected){
+        return true;
+    }
+    *expected=(int)previous;
+    return false;
+}
+#endif
+
+//not defined where the compiler has no thread-local storage
+#if defined(_MSC_VER)
+#define CJSON_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)||defined(__clang__)
+#define CJSON_THREAD_LOCAL __thread
+#elif defined(__STDC_VERSION__)&&(__STDC_VERSION__>=201112L)
+#define CJSON_THREAD_LOCAL _Thread_local
+#endif
+
+/* Profiling. With CJSON_PROFILE defined every thread counts,per phase,the calls,
+ * the cycles spent and the bytes handled in thread-local counters,without any
+ * synchronization. The cycles come from the time stamp counter where there is
+ * one,from clock() otherwise. Without CJSON_PROFILE the macros expand to nothing. */
+#if defined(CJSON_PROFILE)
+#if !defined(CJSON_THREAD_LOCAL)
+#error "CJSON_PROFILE needs thread-local storage"
+#endif
+
+static CJSON_THREAD_LOCAL cJSON_Profile thread_profile;
+
+static unsigned long long profile_cycles(void){
+#if defined(_MSC_VER)&&(defined(_M_X64)||defined(_M_IX86))
+    return __rdtsc();
+#elif (defined(__GNUC__)||defined(__clang__))&&(defined(__x86_64__)||defined(__i386__))
+    return __builtin_ia32_rdtsc();
+#elif (defined(__GNUC__)||defined(__clang__))&&defined(__aarch64__)
+    unsigned long long ticks=0;
+    __asm__ __volatile__("mrs %0,cntvct_el0":"=r"(ticks));
+    return ticks;
+#else
+    return (unsigned long long)clock();
+#endif
+}
+
+static void profile_add(const int phase,const unsigned long long cycles,const size_t bytes){
+    cJSON_ProfileCounter *const counter=&thread_profile.phase[phase];
+    counter->calls++;
+    counter->cycles+=cycles;
+    counter->bytes+=bytes;
+}
+
+#if defined(CJSON_PARALLEL)
+//add the counters of a thread that worked for this one
+static void profile_merge(cJSON_Profile*const total,const cJSON_Profile*const profile){
+    int phase=0;
+    for(phase=0;phase<cJSON_ProfilePhases;phase++){
+        total->phase[phase].calls+=profile->phase[phase].calls;
+        total->phase[phase].cycles+=profile->phase[phase].cycles;
+        total->phase[phase].bytes+=profile->phase[phase].bytes;
+    }
+}
+#endif
+
+//a phase starts at position and ends at another,the bytes are the difference
+#define profile_begin(name,position) const unsigned long long name##_cycles=profile_cycles();const size_t name##_position=(size_t)(position)
+#define profile_end(name,phase,position) profile_add((phase),profile_cycles()-name##_cycles,(size_t)(position)-name##_position)
+#else
+#define profile_begin(name,position)
+#define profile_end(name,phase,position)
+#endif
+
+CJSON_PUBLIC(cJSON_bool)cJSON_ProfileSnapshot(cJSON_Profile*profile){
+    if(profile==NULL){
+        return false;
+    }
+#if defined(CJSON_PROFILE)
+    *profile=thread_profile;
+    return true;
+#else
+    memset(profile,0,sizeof(cJSON_Profile));
+    return false;
+#endif
+}
+
+CJSON_PUBLIC(void)cJSON_ProfileReset(void){
+#if defined(CJSON_PROFILE)
+    memset(&thread_profile,0,sizeof(cJSON_Profile));
+#endif
+}
+
+CJSON_PUBLIC(char*)cJSON_PrintProfile(const cJSON_Profile*profile){
+    static const char *const names[cJSON_ProfilePhases]={"whitespace","string","number","strtod","allocate","ensure"};
+    char *output=NULL;
+    size_t length=0;
+    int phase=0;
+
+    if(profile==NULL){
+        return NULL;
+    }
+    //a name and three counters of up to 20 digits per phase
+    output=(char*)global_hooks.allocate(cJSON_ProfilePhases*128);
+    if(output==NULL){
+        return NULL;
+    }
+
+    output[length++]='{';
+    for(phase=0;phase<cJSON_ProfilePhases;phase++){
+        length+=(size_t)sprintf(output+length,"%s\"%s\":{\"calls\":%llu,\"cycles\":%llu,\"bytes\":%llu}",(phase>0)?",":"",names[phase],profile->phase[phase].calls,profile->phase[phase].cycles,profile->phase[phase].bytes);
+    }
+    output[length++]='}';
+    output[length]='\0';
+
+    return output;
+}
+
 static cJSON *cJSON_NEW_Item(const internal_hooks *const hooks){
-    cJSON *node=(cJSON*)hooks->allocate(sizeof(cJSON));
+    cJSON *node=NULL;
+    profile_begin(allocate,0);
+    node=(cJSON*)hooks->allocate(sizeof(cJSON));
+    profile_end(allocate,cJSON_ProfileAllocate,sizeof(cJSON));
     if(node){
         memset(node,'\0',sizeof(cJSON));
     }
     return node;
 }
 
+/* Copy on write sharing. A child list can be owned by several containers; the
+ * owners beyond the first are counted in the shares of the head of the list.
+ * Every item below one given to cJSON_DuplicateShared is frozen: it can be
+ * reached from more than one tree,so the mutating functions refuse it. A shared
+ * list is never changed in place,a container about to change its children
+ * copies the list first (unshare_children) and the copies share the lists below
+ * them in turn. Shares are only touched atomically,trees that share lists can be
+ * read,changed and deleted in separate threads. */
+#define share_frozen 0x40000000
+#define share_owners 0x3FFFFFFF
+
+static int *share_word(const cJSON*const item){
+    //bookkeeping apart from the value,like a mutable member
+    return &((cJSON*)item)->shares;
+}
+
+static cJSON_bool share_is_frozen(const cJSON*const item){
+    return (atomic_load_int(share_word(item))&share_frozen)!=0;
+}
 
-//delete a cJSON structure
-CJSON_PUBLIC(void)cJSON_Delete(cJSON*item){
+static cJSON_bool share_is_shared(const cJSON*const head){
+    return (atomic_load_int(share_word(head))&share_owners)!=0;
+}
+
+//count one more owner of the list at head
+static void share_add_owner(const cJSON*const head){
+    atomic_add_int(share_word(head),1);
+}
+
+/* Drop one owner of the list at head. False if it had no other owner,the caller
+ * then holds the only reference. */
+static cJSON_bool share_drop_owner(const cJSON*const head){
+    int shares=atomic_load_int(share_word(head));
+
+    do{
+        if((shares&share_owners)==0){
+            return false;
+        }
+    }while(!atomic_compare_exchange_int(share_word(head),shares,shares-1));
+
+    return true;
+}
+
+static void share_freeze_item(const cJSON*const item);
+
+/* Freeze the items of the list at child and everything below them. A frozen
+ * item only has frozen items below it and a list is frozen as a whole,so a
+ * frozen head ends the walk: later duplicates of a tree cost O(1). The head is
+ * frozen last,whoever finds it frozen can rely on the rest. */
+static void share_freeze(const cJSON*const child){
+    const cJSON *current_item=NULL;
+
+    if(share_is_frozen(child)){
+        return;
+    }
+    for(current_item=child->next;current_item!=NULL;current_item=current_item->next){
+        share_freeze_item(current_item);
+    }
+    share_freeze_item(child);
+}
+
+static void share_freeze_item(const cJSON*const item){
+    //a reference does not own the list it points to
+    if(!(item->type&cJSON_IsReference)&&(item->child!=NULL)){
+        share_freeze(item->child);
+    }
+    atomic_or_int(share_word(item),share_frozen);
+}
+
+//the only owner of a frozen list takes it back,the lists below stay frozen
+static void share_thaw(cJSON*const child){
+    cJSON *current_item=NULL;
+
+    for(current_item=child;current_item!=NULL;current_item=current_item->next){
+        atomic_and_int(share_word(current_item),~share_frozen);
+    }
+}
+
+/* Digests of cJSON_Compare and cJSON_Digest are cached in a small table per
+ * thread keyed by item,so nothing is written to the items. An item does not know
+ * its parents and a change below a cached item cannot find its entry: every
+ * mutating function,cJSON_Delete and a parser dropping its tree advance the
+ * epoch instead,and an entry only holds in the epoch it was computed in. Until
+ * some thread caches a digest the epoch stays put,a change costs one load. */
+#define DIGEST_CACHE_SIZE 256
+
+typedef struct
+{
+    const cJSON *item;
+    size_t epoch;//0 for a free entry
+    uint64_t digest;
+}digest_entry;
+
+static size_t digest_epoch=1;
+static size_t digest_cached=0;//set once any thread caches a digest
+
+static void digest_forget(void){
+    if(atomic_load_size(&digest_cached)==0){
+        return;
+    }
+    if(atomic_add_size(&digest_epoch,1)==0){
+        //0 marks a free entry
+        atomic_add_size(&digest_epoch,1);
+    }
+}
+
+static void delete_items(cJSON*item){
     cJSON *next=NULL;
     while(item!=NULL){
         next=item->next;
-        if(!(item->type&cJSON_IsReference)&&(item->child!=NULL)){
-            cJSON_Delete(item->child);
+        //a shared list is left to its other owners
+        if(!(item->type&cJSON_IsReference)&&(item->child!=NULL)&&!share_drop_owner(item->child)){
+            delete_items(item->child);
         }
         if(!(item->type&cJSON_IsReference)&&(item->valuestring!=NULL)){
             global_hooks.deallcoate(item->valuestring);
@@ -180,8 +537,18 @@ CJSON_PUBLIC(void)cJSON_Delete(cJSON*item){
             global_hooks.deallcoate(item->string);
         }
         global_hooks.deallcoate(item);
-        item->next;
+        item=next;
+    }
+}
+
+//delete a cJSON structure
+CJSON_PUBLIC(void)cJSON_Delete(cJSON*item){
+    if(item==NULL){
+        return;
     }
+    //the addresses may come back for other items
+    digest_forget();
+    delete_items(item);
 }
 
 
@@ -194,913 +561,8733 @@ static unsigned char get_decimal_point(void){
 #endif
 }
 
+/* Block scanning: a 64 byte block is classified into bitmasks,one bit per byte
+ * (bit 0 is the first byte). String and escape state is carried between blocks,
+ * so structural bytes inside strings can be masked out without a byte loop. */
+#define BLOCK_SIZE 64
+
 typedef struct{
-    const unsigned char* content;
-    size_t length;
-    size_t offset;
-    size_t depth; //How deeply nested(in arrays/objects) is the input at the current offset
-    internal_hooks hooks;
-}parse_buffer;
+    uint64_t whitespace;//' ','\t','\r','\n'
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t slash;
+}block_masks;
 
-//check if the given size is left to read in a given parse buffer (starting with 1)
-#define can_read(buffer,size)  ((buffer!=NULL)&&(((buffer)->offset+size)<=(buffer)->length))
-//check if the buffer can be accessed at the given index (starting with 1)
-#define can_access_at_index(buffer,index) ((buffer!=NULL)&&(((buffer)->offset+index)<(buffer)->length))
-#define cannot_access_at_index(buffer,index) (!can_access_at_index(buffer,index))
-//get a pointer to the buffer at the position
-#define buffer_at_offset(buffer) ((buffer)->content+(buffer)->offset)
+typedef struct{
+    uint64_t escaped_carry;//1 if the first byte of the next block is escaped
+    uint64_t in_string_carry;//all ones if the next block starts inside a string
+}block_state;
+
+static unsigned int trailing_zeroes(uint64_t mask){
+#if defined(__GNUC__)||defined(__clang__)
+    return (unsigned int)__builtin_ctzll(mask);
+#elif defined(_MSC_VER)&&defined(_M_X64)
+    unsigned long index=0;
+    _BitScanForward64(&index,mask);
+    return (unsigned int)index;
+#else
+    unsigned int count=0;
+    while((mask&1)==0){
+        mask>>=1;
+        count++;
+    }
+    return count;
+#endif
+}
 
-//parse the input text to generate a number, and populate the result into item
-static cJSON_bool parse_number(cJSON *const item,parse_buffer*const input_buffer){
-    double number=0;
-    unsigned char*after_end=NULL;
-    unsigned char number_c_string[64];
-    unsigned char decimal_pointer=get_decimal_point();
+static unsigned int population_count(uint64_t mask){
+#if defined(__GNUC__)||defined(__clang__)
+    return (unsigned int)__builtin_popcountll(mask);
+#else
+    unsigned int count=0;
+    for(;mask!=0;mask&=mask-1){
+        count++;
+    }
+    return count;
+#endif
+}
+
+//mask of the bytes in a block equal to c
+static uint64_t equal_mask(const unsigned char*const block,const unsigned char c){
+#if defined(CJSON_SIMD_AVX2)
+    const __m256i needle=_mm256_set1_epi8((char)c);
+    const uint64_t low=(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)block),needle));
+    const uint64_t high=(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(block+32)),needle));
+    return low|(high<<32);
+#elif defined(CJSON_SIMD_SSE2)
+    const __m128i needle=_mm_set1_epi8((char)c);
+    uint64_t mask=0;
     size_t i=0;
+    for(i=0;i<BLOCK_SIZE;i+=16){
+        mask|=(uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(block+i)),needle))<<i;
+    }
+    return mask;
+#else
+    uint64_t mask=0;
+    size_t i=0;
+    for(i=0;i<BLOCK_SIZE;i++){
+        mask|=(uint64_t)(block[i]==c)<<i;
+    }
+    return mask;
+#endif
+}
 
-    if((input_buffer)==NULL||(input_buffer->content)==NULL){
-        return false;
+//mask of the bytes in a block that are not ASCII
+static uint64_t high_bit_mask(const unsigned char*const block){
+#if defined(CJSON_SIMD_AVX2)
+    const uint64_t low=(uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)block));
+    const uint64_t high=(uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(block+32)));
+    return low|(high<<32);
+#elif defined(CJSON_SIMD_SSE2)
+    uint64_t mask=0;
+    size_t i=0;
+    for(i=0;i<BLOCK_SIZE;i+=16){
+        mask|=(uint64_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(block+i)))<<i;
+    }
+    return mask;
+#else
+    uint64_t mask=0;
+    size_t i=0;
+    for(i=0;i<BLOCK_SIZE;i++){
+        mask|=(uint64_t)(block[i]>>7)<<i;
     }
+    return mask;
+#endif
+}
 
-    /*copy the number into a temporary buffer and replace '.' with the decimal point
-    of the current locale(for strtod)
-    this also takes care of '\0' not necessarily being available for marking the end of input
-     * */
+#if defined(CJSON_SIMD_SHUFFLE)
+/* Vector UTF-8 check after Keiser and Lemire,"Validating UTF-8 In Less Than One
+ * Instruction Per Byte". Each byte is classified three times,by the high and the
+ * low nibble of the byte before it and by its own high nibble; only the pairs
+ * that cannot occur in UTF-8 have a bit set in all three. The third and fourth
+ * bytes of longer sequences are then checked to be continuations. */
+#define UTF8_TOO_SHORT 0x01//lead not followed by a continuation
+#define UTF8_TOO_LONG 0x02//continuation after ASCII
+#define UTF8_OVERLONG_3 0x04
+#define UTF8_TOO_LARGE 0x08//above U+10FFFF
+#define UTF8_SURROGATE 0x10
+#define UTF8_OVERLONG_2 0x20
+#define UTF8_TOO_LARGE_1000 0x40
+#define UTF8_OVERLONG_4 0x40
+#define UTF8_TWO_CONTS 0x80//a continuation after a continuation,fine for the third and fourth byte
+#define UTF8_CARRY (UTF8_TOO_SHORT|UTF8_TOO_LONG|UTF8_TWO_CONTS)
+
+//the bytes of block shifted back by count,with the last ones of previous in front
+#define utf8_previous(block,previous,count) _mm_alignr_epi8((block),(previous),16-(count))
+
+//nonzero bytes where block does not continue the sequences of previous correctly
+static __m128i utf8_block_errors(const __m128i block,const __m128i previous){
+    const __m128i nibble=_mm_set1_epi8(0x0F);
+    const __m128i byte_1_high_table=_mm_setr_epi8(
+        //ASCII
+        UTF8_TOO_LONG,UTF8_TOO_LONG,UTF8_TOO_LONG,UTF8_TOO_LONG,UTF8_TOO_LONG,UTF8_TOO_LONG,UTF8_TOO_LONG,UTF8_TOO_LONG,
+        //continuation
+        (char)UTF8_TWO_CONTS,(char)UTF8_TWO_CONTS,(char)UTF8_TWO_CONTS,(char)UTF8_TWO_CONTS,
+        //1100,1101: two byte leads
+        UTF8_TOO_SHORT|UTF8_OVERLONG_2,UTF8_TOO_SHORT,
+        //1110: three byte leads
+        UTF8_TOO_SHORT|UTF8_OVERLONG_3|UTF8_SURROGATE,
+        //1111: four byte leads
+        UTF8_TOO_SHORT|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000|UTF8_OVERLONG_4);
+    const __m128i byte_1_low_table=_mm_setr_epi8(
+        (char)(UTF8_CARRY|UTF8_OVERLONG_3|UTF8_OVERLONG_2|UTF8_OVERLONG_4),
+        (char)(UTF8_CARRY|UTF8_OVERLONG_2),
+        (char)UTF8_CARRY,(char)UTF8_CARRY,
+        (char)(UTF8_CARRY|UTF8_TOO_LARGE),
+        (char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),(char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),(char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),(char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),(char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),(char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),
+        //____1101: 0xED
+        (char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000|UTF8_SURROGATE),
+        (char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000),(char)(UTF8_CARRY|UTF8_TOO_LARGE|UTF8_TOO_LARGE_1000));
+    const __m128i byte_2_high_table=_mm_setr_epi8(
+        //ASCII
+        UTF8_TOO_SHORT,UTF8_TOO_SHORT,UTF8_TOO_SHORT,UTF8_TOO_SHORT,UTF8_TOO_SHORT,UTF8_TOO_SHORT,UTF8_TOO_SHORT,UTF8_TOO_SHORT,
+        //1000,1001,101_: continuations
+        (char)(UTF8_TOO_LONG|UTF8_OVERLONG_2|UTF8_TWO_CONTS|UTF8_OVERLONG_3|UTF8_TOO_LARGE_1000|UTF8_OVERLONG_4),
+        (char)(UTF8_TOO_LONG|UTF8_OVERLONG_2|UTF8_TWO_CONTS|UTF8_OVERLONG_3|UTF8_TOO_LARGE),
+        (char)(UTF8_TOO_LONG|UTF8_OVERLONG_2|UTF8_TWO_CONTS|UTF8_SURROGATE|UTF8_TOO_LARGE),
+        (char)(UTF8_TOO_LONG|UTF8_OVERLONG_2|UTF8_TWO_CONTS|UTF8_SURROGATE|UTF8_TOO_LARGE),
+        //leads
+        UTF8_TOO_SHORT,UTF8_TOO_SHORT,UTF8_TOO_SHORT,UTF8_TOO_SHORT);
+    const __m128i previous_1=utf8_previous(block,previous,1);
+    const __m128i byte_1_high=_mm_shuffle_epi8(byte_1_high_table,_mm_and_si128(_mm_srli_epi16(previous_1,4),nibble));
+    const __m128i byte_1_low=_mm_shuffle_epi8(byte_1_low_table,_mm_and_si128(previous_1,nibble));
+    const __m128i byte_2_high=_mm_shuffle_epi8(byte_2_high_table,_mm_and_si128(_mm_srli_epi16(block,4),nibble));
+    const __m128i special=_mm_and_si128(_mm_and_si128(byte_1_high,byte_1_low),byte_2_high);
+    //only 111_____ two bytes back and 1111____ three bytes back reach 0x80
+    const __m128i third=_mm_subs_epu8(utf8_previous(block,previous,2),_mm_set1_epi8((char)(0xE0-0x80)));
+    const __m128i fourth=_mm_subs_epu8(utf8_previous(block,previous,3),_mm_set1_epi8((char)(0xF0-0x80)));
+    const __m128i must_continue=_mm_and_si128(_mm_or_si128(third,fourth),_mm_set1_epi8((char)0x80));
+
+    return _mm_xor_si128(must_continue,special);
+}
 
-    for(i=0;(i<(sizeof(number_c_string)-1))&&can_access_at_index(input_buffer,1);i++){
-        switch (buffer_at_offset(input_buffer)[i])
-        {
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-        case '+':
-        case '-':
-        case 'e':
-        case 'E':
-            number_c_string[i]=buffer_at_offset(input_buffer)[i];
-            break;
-        case '.':
-            number_c_string[i]=decimal_pointer;
+//nonzero if block ends inside a sequence
+static __m128i utf8_block_incomplete(const __m128i block){
+    const __m128i last_valid=_mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,(char)(0xF0-1),(char)(0xE0-1),(char)(0xC0-1));
+    return _mm_subs_epu8(block,last_valid);
+}
+#endif
+
+/* return the first byte of an invalid UTF-8 sequence in [input,end),or NULL.
+ * With byte shuffles whole blocks are checked at once and the sequences of a
+ * block with an error are walked one by one to find its first byte; otherwise
+ * ASCII runs are skipped 16 bytes at a time. Overlong forms,surrogates and code
+ * points above U+10FFFF are rejected */
+static const unsigned char *find_invalid_utf8(const unsigned char*input,const unsigned char*const end){
+#if defined(CJSON_SIMD_SHUFFLE)
+    const unsigned char *const start=input;
+    const __m128i zero=_mm_setzero_si128();
+    __m128i previous=zero;//the bytes before input are ASCII
+    __m128i incomplete=zero;
+    const unsigned char *unchecked=NULL;
+
+    while((end-input)>=16){
+        const __m128i block=_mm_loadu_si128((const __m128i*)input);
+        __m128i errors=incomplete;//an ASCII block cannot complete a sequence
+
+        if(_mm_movemask_epi8(block)!=0){
+            errors=utf8_block_errors(block,previous);
+            incomplete=utf8_block_incomplete(block);
+        }else{
+            incomplete=zero;
+        }
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(errors,zero))!=0xFFFF){
             break;
-        
-        default:
-            goto loop_end;
         }
+        previous=block;
+        input+=16;
     }
-loop_end:
-    number_c_string[i]='\0';
-    //如果after_end不为NULL，则将遇到的不符合条件而终止的ntr中的字符指针由endptr传回
-    number=strtod((const char*)number_c_string,(char**)&after_end);
-    if(number_c_string==after_end){
-        return false;//parse_error
+    /* walk the rest from the lead of a sequence reaching into it. Everything
+     * before it checked out,so the first byte of the last three that is not a
+     * continuation starts a sequence */
+    unchecked=input;
+    input=((unchecked-start)>3)?(unchecked-3):start;
+    while((input<unchecked)&&((*input&0xC0)==0x80)){
+        input++;
     }
+#endif
+    while(input<end){
+        unsigned char lead=0;
+        unsigned char second_min=0x80;
+        unsigned char second_max=0xBF;
+        size_t length=0;
+        size_t continuation=0;
+
+#if defined(CJSON_SIMD_AVX2)||defined(CJSON_SIMD_SSE2)
+        if(((end-input)>=16)&&(_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)input))==0)){
+            input+=16;
+            continue;
+        }
+#else
+        if((end-input)>=8){
+            uint64_t word;
+            memcpy(&word,input,sizeof(word));
+            if((word&0x8080808080808080ULL)==0){
+                input+=8;
+                continue;
+            }
+        }
+#endif
+        lead=*input;
+        if(lead<0x80){
+            input++;
+            continue;
+        }
 
-    item->valuedouble=number;
+        if((lead>=0xC2)&&(lead<=0xDF)){
+            length=2;
+        }
+        else if((lead>=0xE0)&&(lead<=0xEF)){
+            length=3;
+            if(lead==0xE0){
+                second_min=0xA0;//overlong
+            }
+            else if(lead==0xED){
+                second_max=0x9F;//UTF-16 surrogates
+            }
+        }
+        else if((lead>=0xF0)&&(lead<=0xF4)){
+            length=4;
+            if(lead==0xF0){
+                second_min=0x90;//overlong
+            }
+            else if(lead==0xF4){
+                second_max=0x8F;//above U+10FFFF
+            }
+        }
+        else{
+            //continuation byte without a lead,overlong 0xC0/0xC1 or 0xF5 and above
+            return input;
+        }
 
-    if(number>=INT_MAX){
-        item->valueint=INT_MAX;
-    }
-    else if(number<=(double)INT_MIN){
-        item->valueint=INT_MIN;
-    }
-    else{
-        item->valueint=(int)number;
+        if((size_t)(end-input)<length){
+            return input;
+        }
+        if((input[1]<second_min)||(input[1]>second_max)){
+            return input;
+        }
+        for(continuation=2;continuation<length;continuation++){
+            if((input[continuation]&0xC0)!=0x80){
+                return input;
+            }
+        }
+
+        input+=length;
     }
 
-    item->type=cJSON_Number;
+    return NULL;
+}
 
-    input_buffer->offset+=(size_t)(after_end-number_c_string);
-    return true;
+static void classify_block(const unsigned char*const block,block_masks*const masks){
+    masks->whitespace=equal_mask(block,' ')|equal_mask(block,'\t')|equal_mask(block,'\r')|equal_mask(block,'\n');
+    masks->quote=equal_mask(block,'\"');
+    masks->backslash=equal_mask(block,'\\');
+    masks->slash=equal_mask(block,'/');
 }
 
-CJSON_PUBLIC(double)cJSOn_setNumberHelper(cJSON*object,double number){
-    if(number>=INT_MAX){
-        object->valueint=INT_MAX;;
-    }else if(number<=(double)INT_MIN){
-        object->valueint=INT_MIN;
-    }else{
-        object->valueint=(int)number;
+//mask of the bytes that are escaped by an odd run of backslashes
+static uint64_t escaped_mask(uint64_t backslash,block_state*const state){
+    const uint64_t odd_bits=0xAAAAAAAAAAAAAAAAULL;
+    uint64_t potential_escape=0;
+    uint64_t escape_and_terminal=0;
+    uint64_t escaped=0;
+
+    if(backslash==0){
+        escaped=state->escaped_carry;
+        state->escaped_carry=0;
+        return escaped;
     }
 
-    return object->valuedouble=number;
+    //a backslash escaped by the previous block starts no escape of its own
+    potential_escape=backslash&~state->escaped_carry;
+    //runs starting on an even bit end on an odd bit after subtraction and vice versa
+    escape_and_terminal=(((potential_escape<<1)|odd_bits)-potential_escape)^odd_bits;
+    escaped=escape_and_terminal^(backslash|state->escaped_carry);
+    state->escaped_carry=(escape_and_terminal&backslash)>>63;
+
+    return escaped;
 }
 
-typedef struct
-{
-    unsigned char *buffer;
+static uint64_t prefix_xor(uint64_t mask){
+    mask^=mask<<1;
+    mask^=mask<<2;
+    mask^=mask<<4;
+    mask^=mask<<8;
+    mask^=mask<<16;
+    mask^=mask<<32;
+    return mask;
+}
+
+//mask of the bytes inside strings,the opening quote is included and the closing quote is not
+static uint64_t string_mask(const block_masks*const masks,block_state*const state){
+    uint64_t quotes=masks->quote&~escaped_mask(masks->backslash,state);
+    uint64_t in_string=prefix_xor(quotes)^state->in_string_carry;
+
+    state->in_string_carry=(uint64_t)0-(in_string>>63);
+    return in_string;
+}
+
+typedef struct structural_index structural_index;
+
+typedef struct{
+    const unsigned char* content;
     size_t length;
     size_t offset;
-    size_t depth;
-    cJSON_bool noalloc;
-    cJSON_bool format;//is this print a formatted print
+    size_t depth; //How deeply nested(in arrays/objects) is the input at the current offset
     internal_hooks hooks;
-}printbuffer;
+    int flags;//cJSON_Parse* flags
+    const structural_index *parallel;//set to parse large arrays/objects on several threads
+    cJSON_Parser *parser;//set when the tree is built in a parser's storage
+}parse_buffer;
 
-static unsigned char* ensure(printbuffer *const p,size_t needed){
-    unsigned char *newbuffer=NULL;
-    size_t newsize=0;
+//check if the given size is left to read in a given parse buffer (starting with 1)
+#define can_read(buffer,size)  ((buffer!=NULL)&&(((buffer)->offset+size)<=(buffer)->length))
+//check if the buffer can be accessed at the given index (starting with 1)
+#define can_access_at_index(buffer,index) ((buffer!=NULL)&&(((buffer)->offset+index)<(buffer)->length))
+#define cannot_access_at_index(buffer,index) (!can_access_at_index(buffer,index))
+//get a pointer to the buffer at the position
+#define buffer_at_offset(buffer) ((buffer)->content+(buffer)->offset)
 
-    if((p==NULL)||(p->buffer==NULL)){
-        return NULL;
-    }
+/* Storage of a cJSON_Parser. Items and strings of a tree are carved from the
+ * current chunk and never freed one by one. A parse that outgrows the chunk adds
+ * bigger ones,and the next reset replaces them with a single chunk as large as all
+ * of them,so a stream of similar messages stops allocating after the first few.
+ * Object keys are interned in a table that lives as long as the parser. */
+#ifndef CJSON_PARSER_CHUNK_SIZE
+#define CJSON_PARSER_CHUNK_SIZE 4096
+#endif
+//at most this many keys of up to CJSON_PARSER_INTERN_LENGTH bytes are interned
+#ifndef CJSON_PARSER_INTERN_LIMIT
+#define CJSON_PARSER_INTERN_LIMIT 4096
+#endif
+#ifndef CJSON_PARSER_INTERN_LENGTH
+#define CJSON_PARSER_INTERN_LENGTH 64
+#endif
 
-    if((p->length>0)&&(p->offset>=p->length)){
-        return NULL;
-    }
+//objects get a shape while fewer than this many shapes exist
+#ifndef CJSON_PARSER_SHAPE_LIMIT
+#define CJSON_PARSER_SHAPE_LIMIT 4096
+#endif
 
-    if(needed>INT_MAX){
+#define parser_align(size) (((size)+7)&~(size_t)7)
+#define parser_chunk_data(chunk) ((unsigned char*)((chunk)+1))
+
+typedef struct parser_chunk
+{
+    struct parser_chunk *next;
+    size_t size;
+}parser_chunk;
+
+typedef struct
+{
+    const char *key;//NULL for a free slot
+    size_t length;
+    uint32_t hash;
+}intern_entry;
+
+/* Shapes form a tree of transitions: the shape of an object with keys a,b is
+ * reached from the empty shape through a,then b. Keys are interned,so they are
+ * compared by address. */
+struct cJSON_Shape
+{
+    const char *key;//the last key,NULL for the empty shape
+    size_t count;//members
+    struct cJSON_Shape *transitions;//shapes with one more member
+    struct cJSON_Shape *sibling;//the next transition of the parent
+    struct cJSON_Shape *created;//the shape created before this one
+    size_t generation;//of the parser,see cJSON_GetFieldItem
+};
+
+//an object's shape,followed by its count members
+struct cJSON_Layout
+{
+    const cJSON_Shape *shape;
+};
+#define layout_members(layout) ((cJSON*const*)((layout)+1))
+
+/* Items of a parser are preceded by the layout of the object they may become,so
+ * cJSON keeps its size; cJSON_HasShape marks the objects that have one. */
+typedef struct
+{
+    const struct cJSON_Layout *layout;
+    cJSON item;
+}parser_item;
+#define item_parser_slot(object) ((parser_item*)(void*)((unsigned char*)(object)-offsetof(parser_item,item)))
+
+struct cJSON_Parser
+{
+    parser_chunk *chunk;
+    size_t used;//bytes of chunk handed out
+    parser_chunk *retired;//chunks filled by the current tree
+    size_t retired_size;
+    intern_entry *interned;
+    size_t intern_capacity;//a power of two,0 before the first key
+    size_t intern_count;
+    cJSON_Shape empty_shape;
+    cJSON_Shape *shapes;//the last shape created
+    size_t shape_count;
+    int flags;
+    internal_hooks hooks;
+};
+
+static parser_chunk *parser_new_chunk(const cJSON_Parser*const parser,const size_t size){
+    parser_chunk *chunk=(parser_chunk*)parser->hooks.allocate(sizeof(parser_chunk)+size);
+    if(chunk==NULL){
         return NULL;
     }
+    chunk->next=NULL;
+    chunk->size=size;
 
-    needed+=p->offset+1;
+    return chunk;
+}
 
-    if(needed<=p->length){
-        return p->buffer+p->offset;
-    }
+static void *parser_allocate(cJSON_Parser*const parser,size_t size){
+    unsigned char *block=NULL;
 
-    if(p->noalloc){
-        return NULL;
+    size=parser_align(size);
+    if((parser->chunk==NULL)||((parser->chunk->size-parser->used)<size)){
+        size_t chunk_size=(parser->chunk!=NULL)?(parser->chunk->size*2):CJSON_PARSER_CHUNK_SIZE;
+        parser_chunk *chunk=NULL;
+
+        if(chunk_size<size){
+            chunk_size=size;
+        }
+        chunk=parser_new_chunk(parser,chunk_size);
+        if(chunk==NULL){
+            return NULL;
+        }
+        if(parser->chunk!=NULL){
+            parser->chunk->next=parser->retired;
+            parser->retired=parser->chunk;
+            parser->retired_size+=parser->chunk->size;
+        }
+        parser->chunk=chunk;
+        parser->used=0;
     }
 
-    //calculate new buffer szie
+    block=parser_chunk_data(parser->chunk)+parser->used;
+    parser->used+=size;
 
-   if(needed>(INT_MAX/2)){
-        if(needed <=INT_MAX){
-        newsize=INT_MAX;
+    return block;
+}
+
+//drop the tree,folding the chunks it needed into one for the next
+static void parser_rewind(cJSON_Parser*const parser){
+    digest_forget();
+    if(parser->retired!=NULL){
+        parser_chunk *chunk=NULL;
+
+        while(parser->retired!=NULL){
+            chunk=parser->retired->next;
+            parser->hooks.deallcoate(parser->retired);
+            parser->retired=chunk;
         }
-        else
-        {
-        return NULL;
+        chunk=parser_new_chunk(parser,parser->retired_size+parser->chunk->size);
+        if(chunk!=NULL){
+            parser->hooks.deallcoate(parser->chunk);
+            parser->chunk=chunk;
         }
-   }else
-   {
-       newsize=needed*2;
-   }
+        parser->retired_size=0;
+    }
+    parser->used=0;
+}
 
-   if(p->hooks.realloccate!=NULL){
-       newbuffer=(unsigned char*)p->hooks.realloccate(p->buffer,newsize);
-       if(newbuffer==NULL){
-           p->hooks.deallcoate(p->buffer);
-           p->length=0;
-           p->buffer=NULL;
+static uint32_t intern_hash(const unsigned char*key,size_t*const length){
+    const unsigned char *const start=key;
+    uint32_t hash=0x811C9DC5UL;
 
-           return NULL;
-       }
+    for(;*key!='\0';key++){
+        hash^=(uint32_t)*key;
+        hash*=0x01000193UL;
+    }
+    *length=(size_t)(key-start);
 
-       if(newbuffer){
-            memcpy(newbuffer,p->buffer,p->offset+1);
-       }
+    return hash;
+}
 
-       p->hooks.deallcoate(p->buffer);
+static cJSON_bool intern_grow(cJSON_Parser*const parser){
+    const size_t capacity=(parser->intern_capacity==0)?64:(parser->intern_capacity*2);
+    intern_entry *entries=(intern_entry*)parser->hooks.allocate(capacity*sizeof(intern_entry));
+    size_t index=0;
 
-   }
-   p->length=newsize;
-   p->buffer=newbuffer;
+    if(entries==NULL){
+        return false;
+    }
+    memset(entries,0,capacity*sizeof(intern_entry));
 
-   return newbuffer+p->offset;
-      
+    for(index=0;index<parser->intern_capacity;index++){
+        const intern_entry *const entry=&parser->interned[index];
+        size_t slot=entry->hash&(capacity-1);
+        if(entry->key==NULL){
+            continue;
+        }
+        while(entries[slot].key!=NULL){
+            slot=(slot+1)&(capacity-1);
+        }
+        entries[slot]=*entry;
+    }
+
+    if(parser->interned!=NULL){
+        parser->hooks.deallcoate(parser->interned);
+    }
+    parser->interned=entries;
+    parser->intern_capacity=capacity;
+
+    return true;
 }
 
-//Render the number nicely from the given item into string
-static cJSON_bool print_number(const cJSON*const item,printbuffer *const output_buffer){
-   unsigned char*output_pointer=NULL;
-   double d=item->valuedouble;
-   int length=0;
-   size_t i=0;
-   unsigned char number_buffer[26];
-   unsigned char decimal_point=get_decimal_point();
-   double test;
+/* The interned copy of key,which was just parsed into the current chunk at
+ * offset mark,and which is given back to the chunk. Keys past the limits stay
+ * where they are. */
+static char *parser_intern(cJSON_Parser*const parser,char*const key,const size_t mark){
+    size_t length=0;
+    const uint32_t hash=intern_hash((const unsigned char*)key,&length);
+    intern_entry *entry=NULL;
+    char *copy=NULL;
+
+    if(parser->intern_capacity>0){
+        size_t slot=hash&(parser->intern_capacity-1);
+        for(;parser->interned[slot].key!=NULL;slot=(slot+1)&(parser->intern_capacity-1)){
+            entry=&parser->interned[slot];
+            if((entry->hash==hash)&&(entry->length==length)&&(memcmp(entry->key,key,length)==0)){
+                copy=(char*)entry->key;
+                goto release;
+            }
+        }
+    }
 
-   if(output_buffer==NULL){
-       return false;
-   }
+    if((length>CJSON_PARSER_INTERN_LENGTH)||(parser->intern_count>=CJSON_PARSER_INTERN_LIMIT)){
+        return key;
+    }
+    //keep the table at most half full
+    if(((parser->intern_count+1)*2>parser->intern_capacity)&&!intern_grow(parser)){
+        return key;
+    }
+    copy=(char*)parser->hooks.allocate(length+sizeof(""));
+    if(copy==NULL){
+        return key;
+    }
+    memcpy(copy,key,length+sizeof(""));
 
-   //this checks for NaN and Infinity
-   if((d*0)!=0){
-       length=sprintf((char*)number_buffer,"null");
-   }
-   else{
-       //尝试15个小数位数的精度避免不重要的非零数字 
-       length=sprintf((char*)number_buffer,"%1.15g",d);
+    entry=&parser->interned[hash&(parser->intern_capacity-1)];
+    while(entry->key!=NULL){
+        entry=(entry==&parser->interned[parser->intern_capacity-1])?parser->interned:(entry+1);
+    }
+    entry->key=copy;
+    entry->length=length;
+    entry->hash=hash;
+    parser->intern_count++;
+
+release:
+    //nothing was carved from the chunk behind the key
+    if((unsigned char*)key==parser_chunk_data(parser->chunk)+mark){
+        parser->used=mark;
+    }
 
-       if((sscanf((char*)number_buffer,"%1g",&test)!=1)||(double)test!=d){
-           length=sprintf((char*)number_buffer,"%1.17g",d);
-       }
-   }
+    return copy;
+}
 
-    //sprintf failed or buffer overrun occured
-   if((length<0)||(length>(int)(sizeof(number_buffer)-1))){
-       return false;
-   }
+/* The shape reached from shape by adding the interned key,NULL once the shape
+ * limit is reached. The transition taken is moved to the front,objects in a row
+ * usually take the same ones. */
+static cJSON_Shape *parser_shape(cJSON_Parser*const parser,cJSON_Shape*const shape,const char*const key){
+    cJSON_Shape *next=NULL;
+    cJSON_Shape *previous=NULL;
+
+    for(next=shape->transitions;next!=NULL;previous=next,next=next->sibling){
+        if(next->key==key){
+            if(previous!=NULL){
+                previous->sibling=next->sibling;
+                next->sibling=shape->transitions;
+                shape->transitions=next;
+            }
+            return next;
+        }
+    }
 
-   //reserve appropriate space in the output
-   output_pointer=ensure(output_buffer,(size_t)length+sizeof(""));
-   if(output_buffer==NULL){
-       return false;
-   }
+    if(parser->shape_count>=CJSON_PARSER_SHAPE_LIMIT){
+        return NULL;
+    }
+    next=(cJSON_Shape*)parser->hooks.allocate(sizeof(cJSON_Shape));
+    if(next==NULL){
+        return NULL;
+    }
+    next->key=key;
+    next->count=shape->count+1;
+    next->generation=shape->generation;
+    next->transitions=NULL;
+    next->sibling=shape->transitions;
+    shape->transitions=next;
+    next->created=parser->shapes;
+    parser->shapes=next;
+    parser->shape_count++;
+
+    return next;
+}
 
-   //copy the printed number to the output and replace locale
-   //dependent decimal point with '.'
-   for(i=0;i<((size_t)length);i++){
-       if(number_buffer[i]==decimal_point){
-           output_pointer[i]='.';
-           continue;
-       }
+//items and strings of a parse come from the parser's storage when there is one
+static cJSON *parse_new_item(parse_buffer*const input_buffer){
+    parser_item *slot=NULL;
 
-       output_pointer[i]==number_buffer[i];
-   }
-   output_pointer[i]='\0';
-   output_buffer->offset+=(size_t)length;
+    if(input_buffer->parser==NULL){
+        return cJSON_NEW_Item(&input_buffer->hooks);
+    }
+    profile_begin(allocate,0);
+    slot=(parser_item*)parser_allocate(input_buffer->parser,sizeof(parser_item));
+    profile_end(allocate,cJSON_ProfileAllocate,sizeof(parser_item));
+    if(slot==NULL){
+        return NULL;
+    }
+    memset(slot,'\0',sizeof(parser_item));
 
-   return true;
+    return &slot->item;
+}
 
+static void *parse_allocate(parse_buffer*const input_buffer,const size_t size){
+    if(input_buffer->parser!=NULL){
+        return parser_allocate(input_buffer->parser,size);
+    }
+    return input_buffer->hooks.allocate(size);
 }
 
-//parse 4 digit hexadecimal number
-static unsigned parse_hex4(const unsigned char*const input){
-    unsigned int h=0;
-    size_t i=0;
+//parser storage is only released as a whole
+static void parse_deallocate(parse_buffer*const input_buffer,void*const pointer){
+    if(input_buffer->parser==NULL){
+        input_buffer->hooks.deallcoate(pointer);
+    }
+}
 
-    for(i=0;i<4;i++){
-        if((input[i]>='0')&&input[i]<='9'){
-            h+=(unsigned int)input[i]-'0';
+static void parse_delete(parse_buffer*const input_buffer,cJSON*const item){
+    if(input_buffer->parser==NULL){
+        cJSON_Delete(item);
+    }
+}
+
+/* Length of the JSON number at the start of the length bytes of text,0 if there
+ * is none. The RFC 8259 grammar is enforced: no leading zeros,digits after '.'
+ * and after the exponent,and no digit,letter,'.','+' or '-' right after the
+ * number,so "01","1.","-.5","1e" and "0x1" are all rejected. parse_number uses it
+ * for parsing,validating and lazy numbers alike. */
+static size_t lexeme_length(const unsigned char*const text,const size_t length){
+    size_t position=0;
+
+    if((position<length)&&(text[position]=='-')){
+        position++;
+    }
+    if((position<length)&&(text[position]=='0')){
+        position++;
+    }else if((position<length)&&(text[position]>='1')&&(text[position]<='9')){
+        while((position<length)&&(text[position]>='0')&&(text[position]<='9')){
+            position++;
         }
-        else if((input[i]>='A')&&(input[i]<='F')){
-            h+=(unsigned int)10+input[i]-'A';
+    }else{
+        return 0;
+    }
+    if((position<length)&&(text[position]=='.')){
+        position++;
+        if(!((position<length)&&(text[position]>='0')&&(text[position]<='9'))){
+            return 0;
         }
-        else if((input[i]>='a')&&(input[i]<='f')){
-            h+=(unsigned int)10+input[i]-'a';
+        while((position<length)&&(text[position]>='0')&&(text[position]<='9')){
+            position++;
         }
-        else{
+    }
+    if((position<length)&&((text[position]=='e')||(text[position]=='E'))){
+        position++;
+        if((position<length)&&((text[position]=='+')||(text[position]=='-'))){
+            position++;
+        }
+        if(!((position<length)&&(text[position]>='0')&&(text[position]<='9'))){
             return 0;
         }
-
-        if(i<3){
-            //左移4位留出半个字节
-            h=h<<4;
+        while((position<length)&&(text[position]>='0')&&(text[position]<='9')){
+            position++;
         }
     }
+    if((position<length)&&(isalnum(text[position])||(text[position]=='.')||(text[position]=='+')||(text[position]=='-'))){
+        return 0;
+    }
 
-    return h;
+    return position;
 }
 
-//convert a UTF-16 literal to UTF-8
-//a literal can be one or two sequence of the form \uXXXX
+/* strtod of a number lexeme,with '.' replaced by the decimal point of the
+ * locale. Lexemes of 64 characters or more are copied through hooks,false if
+ * that allocation fails. */
+static cJSON_bool lexeme_convert(const unsigned char*const lexeme,const size_t length,const internal_hooks*const hooks,double*const number){
+    unsigned char number_c_string[64];
+    unsigned char *copy=number_c_string;
+    const unsigned char decimal_point=get_decimal_point();
+    size_t i=0;
 
-static unsigned char utf16_literal_to_uft8(const unsigned char*const input_pointer,const unsigned char*const input_end,unsigned char**output_pointer){
-    long unsigned int codepoint=0;
-    unsigned int first_code=0;
-    const unsigned char*first_sequence=input_pointer;
-    unsigned char utf8_length=0;
-    unsigned char utf8_position=0;
-    unsigned char sequence_length=0;
-    unsigned char first_byte_mark=0;
-    //utf16使用2/4个字节进行储存 （0-FFFF）部分统一使用2个字节来进行储存,字符映射范围（U+0000-U+10FFFF）
-    //utf32使用固定的4个字节来进行储存
-    //utf8纯在单字节编码，使用1-6个字节进行储存，兼容ASCII,当编码超过一个字节，则设最高比特位为0
-    //当编码超过一个字节，则需要几个字节，就在第一个字节最高位开始令连续的几个比特为1，之后的字节最高为10
-    if((input_end-first_sequence)<6){
-        goto fail;
+    if(length>=sizeof(number_c_string)){
+        copy=(unsigned char*)hooks->allocate(length+sizeof(""));
+        if(copy==NULL){
+            return false;
+        }
+    }
+    for(i=0;i<length;i++){
+        copy[i]=(lexeme[i]=='.')?decimal_point:lexeme[i];
     }
+    copy[length]='\0';
 
-    first_code=parse_hex4(first_sequence+2);
+    *number=strtod((const char*)copy,NULL);
 
-    //utf16 surrogate pair
-    //一个生僻字符需要使用0xffff以上的映射范围，即需要两个码元，也即是4byte
-    //第一个码元(前导代理)：0xD800-0xDBFF
-    //第二个码元(后尾代理)：0xDC00-0xDFFF
-    //单独的前导代理不能够表示字符，必须与后尾代理一起构成一个完整字，即必须是双映射
-    if((first_code>=0xDC00)&&(first_code<=0xDFFF)){
-        goto fail;
+    if(copy!=number_c_string){
+        hooks->deallcoate(copy);
     }
+    return true;
+}
 
-    if((first_code>=0xD800)&&(first_code<=0xDBFF)){
-        const unsigned char *second_sequence=first_sequence+6;
-        unsigned int second_code=0;
-        sequence_length=12;
+//parse the input text to generate a number, and populate the result into item.item may be NULL to only validate the input
+static cJSON_bool parse_number(cJSON *const item,parse_buffer*const input_buffer){
+    double number=0;
+    size_t length=0;
 
-        if((input_end-second_sequence)<6){
-            goto fail;
-        }
+    if((input_buffer)==NULL||(input_buffer->content)==NULL){
+        return false;
+    }
 
-        if((second_sequence[0]!='\\')||(second_sequence[1]!='u')){
-            //missing second half of the surrogate pair
-            goto fail;
-        }
+    length=lexeme_length(buffer_at_offset(input_buffer),input_buffer->length-input_buffer->offset);
+    if(length==0){
+        return false;//parse_error
+    }
 
-        second_code=parse_hex4(second_sequence+2);
+    //only validating
+    if(item==NULL){
+        input_buffer->offset+=length;
+        return true;
+    }
 
-        if((second_code<0xDC00)||(second_code>0xDFFF)){
-            goto fail;
+    //a lazy number keeps its text and is converted when it is read
+    if(input_buffer->flags&cJSON_ParseLazyNumbers){
+        profile_begin(allocate,0);
+        item->valuestring=(char*)parse_allocate(input_buffer,length+sizeof(""));
+        profile_end(allocate,cJSON_ProfileAllocate,length+sizeof(""));
+        if(item->valuestring==NULL){
+            return false;
         }
-        //calculate the unicode codepoint from the surrogate pair
-        codepoint =0x10000+(((first_code&0x3ff)<<10)|(second_code&0x3ff));//映射方式
-    }
-    else{
-        sequence_length=6;
-        codepoint=first_code;
+        memcpy(item->valuestring,buffer_at_offset(input_buffer),length);
+        item->valuestring[length]='\0';
+        item->type=cJSON_Number|cJSON_NumberIsLazy;
+        input_buffer->offset+=length;
+        return true;
     }
 
-    //encode as utf8
-    if(codepoint<0x80){
-        utf8_length=1;//normal ASCII.encoding 0xxxxxxx
-    }
-    else if(codepoint<0x800){
-        utf8_length=2;  //two bytes encoding 110xxxxx 10xxxxxx
-        first_byte_mark=0xc0; //11000000
-    }else if(codepoint<0x10000){
-        utf8_length=3;//three bytes encoding 1110xxxx 10xxxxxx 10xxxxxx 
-        first_byte_mark=0xe0;//11100000
-    }else if(codepoint<=0x10FFFF){
-        utf8_length=4;//four bytes,encoding 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-        first_byte_mark=0xF0; //11110000
-    }else{
-        goto fail;
+    profile_begin(strtod,0);
+    if(!lexeme_convert(buffer_at_offset(input_buffer),length,&input_buffer->hooks,&number)){
+        return false;
     }
+    profile_end(strtod,cJSON_ProfileStrtod,length);
 
-    for(utf8_position=(unsigned char)(utf8_length-1);utf8_position>0;utf8_position--){
-        (*output_pointer)[utf8_position]=(unsigned char)((codepoint|0x80)&0xbf);
-        codepoint>>=6;
-    }
+    input_buffer->offset+=length;
 
-    if(utf8_length>1){
-        (*output_pointer)[0]=(unsigned char)((codepoint|first_byte_mark)&0xff);
-    }
-    else{
+    item->valuedouble=number;
+
+    if(number>=INT_MAX){
+        item->valueint=INT_MAX;
+    }
+    else if(number<=(double)INT_MIN){
+        item->valueint=INT_MIN;
+    }
+    else{
+        item->valueint=(int)number;
+    }
+
+    item->type=cJSON_Number;
+
+    return true;
+}
+
+//set valuedouble and the clamped valueint of a fresh item
+static double assign_number(cJSON*const object,const double number){
+    if(number>=INT_MAX){
+        object->valueint=INT_MAX;
+    }else if(number<=(double)INT_MIN){
+        object->valueint=INT_MIN;
+    }else{
+        object->valueint=(int)number;
+    }
+
+    return object->valuedouble=number;
+}
+
+//convert the text of a lazy number
+static double lexeme_value(const char*const lexeme){
+    double number=0;
+
+    //a long lexeme that cannot be copied reads as NaN
+    if(!lexeme_convert((const unsigned char*)lexeme,strlen(lexeme),&global_hooks,&number)){
+        return NAN;
+    }
+    return number;
+}
+
+/* The value of a number item. The text of a lazy number is converted the first
+ * time,valuedouble and valueint serve as the cache from then on. */
+static double number_value(const cJSON*const item){
+    if((item->type&(cJSON_NumberIsLazy|cJSON_NumberIsConverted))==cJSON_NumberIsLazy){
+        cJSON *const cache=(cJSON*)item;//converting does not change the value
+        assign_number(cache,lexeme_value(item->valuestring));
+        cache->type|=cJSON_NumberIsConverted;
+    }
+
+    return item->valuedouble;
+}
+
+//the value of a number item,leaving a lazy number unconverted
+static double read_number_value(const cJSON*const item){
+    if((item->type&(cJSON_NumberIsLazy|cJSON_NumberIsConverted))==cJSON_NumberIsLazy){
+        return lexeme_value(item->valuestring);
+    }
+
+    return item->valuedouble;
+}
+
+//a number set through the API has no text to print anymore
+static void drop_lexeme(cJSON*const item){
+    if(item->type&cJSON_NumberIsLazy){
+        //a reference shares the text with the item it refers to
+        if(!(item->type&cJSON_IsReference)){
+            global_hooks.deallcoate(item->valuestring);
+        }
+        item->valuestring=NULL;
+        item->type&=~(cJSON_NumberIsLazy|cJSON_NumberIsConverted);
+    }
+}
+
+CJSON_PUBLIC(double)cJSOn_setNumberHelper(cJSON*object,double number){
+    if(share_is_frozen(object)){
+        //a frozen item keeps its value
+        return number_value(object);
+    }
+    digest_forget();
+    drop_lexeme(object);
+    return assign_number(object,number);
+}
+
+CJSON_PUBLIC(double)cJSON_GetNumberValue(const cJSON*const item){
+    if(!cJSON_IsNumber(item)){
+        return (double)NAN;
+    }
+
+    return number_value(item);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_GetInt64Value(const cJSON*const item,long long*const value){
+    double number=0;
+
+    if(!cJSON_IsNumber(item)||(value==NULL)){
+        return false;
+    }
+
+    if(item->type&cJSON_NumberIsLazy){
+        //read an integer from its text,so no digit is lost to double
+        const char *digit=item->valuestring;
+        const cJSON_bool negative=(*digit=='-');
+        unsigned long long magnitude=0;
+        const unsigned long long limit=negative?(unsigned long long)LLONG_MAX+1:(unsigned long long)LLONG_MAX;
+
+        if(negative){
+            digit++;
+        }
+        for(;(*digit>='0')&&(*digit<='9');digit++){
+            const unsigned int d=(unsigned int)(*digit-'0');
+            if(magnitude>(limit-d)/10){
+                return false;
+            }
+            magnitude=magnitude*10+d;
+        }
+        if(*digit=='\0'){
+            *value=negative?(long long)(0-magnitude):(long long)magnitude;
+            return true;
+        }
+        //a fraction or an exponent,the value may still be integral
+    }
+
+    number=number_value(item);
+    //the upper bound is exclusive,2^63 is exact as double
+    if((floor(number)!=number)||(number<-9223372036854775808.0)||!(number<9223372036854775808.0)){
+        return false;
+    }
+    *value=(long long)number;
+
+    return true;
+}
+
+typedef struct
+{
+    unsigned char *buffer;
+    size_t length;
+    size_t offset;
+    size_t depth;
+    cJSON_bool noalloc;
+    cJSON_bool format;//is this print a formatted print
+    internal_hooks hooks;
+    size_t threads;//more than 1 to print the children of large containers in parallel
+}printbuffer;
+
+static unsigned char* ensure(printbuffer *const p,size_t needed){
+    unsigned char *newbuffer=NULL;
+    size_t newsize=0;
+
+    if((p==NULL)||(p->buffer==NULL)){
+        return NULL;
+    }
+
+    if((p->length>0)&&(p->offset>=p->length)){
+        return NULL;
+    }
+
+    if(needed>INT_MAX){
+        return NULL;
+    }
+
+    needed+=p->offset+1;
+
+    if(needed<=p->length){
+        return p->buffer+p->offset;
+    }
+
+    if(p->noalloc){
+        return NULL;
+    }
+
+    profile_begin(ensure,p->length);
+
+    //calculate new buffer szie
+
+   if(needed>(INT_MAX/2)){
+        if(needed <=INT_MAX){
+        newsize=INT_MAX;
+        }
+        else
+        {
+        return NULL;
+        }
+   }else
+   {
+       newsize=needed*2;
+   }
+
+   if(p->hooks.realloccate!=NULL){
+       //reallocate with realloc if available
+       newbuffer=(unsigned char*)p->hooks.realloccate(p->buffer,newsize);
+       if(newbuffer==NULL){
+           p->hooks.deallcoate(p->buffer);
+           p->length=0;
+           p->buffer=NULL;
+
+           return NULL;
+       }
+   }
+   else{
+       //otherwise reallocate manually
+       newbuffer=(unsigned char*)p->hooks.allocate(newsize);
+       if(newbuffer==NULL){
+           p->hooks.deallcoate(p->buffer);
+           p->length=0;
+           p->buffer=NULL;
+
+           return NULL;
+       }
+
+       memcpy(newbuffer,p->buffer,p->offset+1);
+       p->hooks.deallcoate(p->buffer);
+   }
+   p->length=newsize;
+   p->buffer=newbuffer;
+   profile_end(ensure,cJSON_ProfileEnsure,newsize);
+
+   return newbuffer+p->offset;
+      
+}
+
+//calculate the new length of the string in a printbuffer and update the offset
+static void update_offset(printbuffer*const buffer){
+    const unsigned char *buffer_pointer=NULL;
+    if((buffer==NULL)||(buffer->buffer==NULL)){
+        return;
+    }
+    buffer_pointer=buffer->buffer+buffer->offset;
+
+    buffer->offset+=strlen((const char*)buffer_pointer);
+}
+
+//Render the number nicely from the given item into string
+static cJSON_bool print_number(const cJSON*const item,printbuffer *const output_buffer){
+   unsigned char*output_pointer=NULL;
+   double d=item->valuedouble;
+   int length=0;
+   size_t i=0;
+   unsigned char number_buffer[26];
+   unsigned char decimal_point=get_decimal_point();
+   double test;
+
+   if(output_buffer==NULL){
+       return false;
+   }
+
+   //a lazy number is printed as it was written
+   if((item->type&cJSON_NumberIsLazy)&&(item->valuestring!=NULL)){
+       const size_t lexeme=strlen(item->valuestring);
+       output_pointer=ensure(output_buffer,lexeme+sizeof(""));
+       if(output_pointer==NULL){
+           return false;
+       }
+       memcpy(output_pointer,item->valuestring,lexeme+sizeof(""));
+       output_buffer->offset+=lexeme;
+       return true;
+   }
+
+   //this checks for NaN and Infinity
+   if((d*0)!=0){
+       length=sprintf((char*)number_buffer,"null");
+   }
+   else{
+       //尝试15个小数位数的精度避免不重要的非零数字 
+       length=sprintf((char*)number_buffer,"%1.15g",d);
+
+       if((sscanf((char*)number_buffer,"%lg",&test)!=1)||(double)test!=d){
+           length=sprintf((char*)number_buffer,"%1.17g",d);
+       }
+   }
+
+    //sprintf failed or buffer overrun occured
+   if((length<0)||(length>(int)(sizeof(number_buffer)-1))){
+       return false;
+   }
+
+   //reserve appropriate space in the output
+   output_pointer=ensure(output_buffer,(size_t)length+sizeof(""));
+   if(output_pointer==NULL){
+       return false;
+   }
+
+   //copy the printed number to the output and replace locale
+   //dependent decimal point with '.'
+   for(i=0;i<((size_t)length);i++){
+       if(number_buffer[i]==decimal_point){
+           output_pointer[i]='.';
+           continue;
+       }
+
+       output_pointer[i]=number_buffer[i];
+   }
+   output_pointer[i]='\0';
+   output_buffer->offset+=(size_t)length;
+
+   return true;
+
+}
+
+//parse 4 digit hexadecimal number
+static unsigned parse_hex4(const unsigned char*const input){
+    unsigned int h=0;
+    size_t i=0;
+
+    for(i=0;i<4;i++){
+        if((input[i]>='0')&&input[i]<='9'){
+            h+=(unsigned int)input[i]-'0';
+        }
+        else if((input[i]>='A')&&(input[i]<='F')){
+            h+=(unsigned int)10+input[i]-'A';
+        }
+        else if((input[i]>='a')&&(input[i]<='f')){
+            h+=(unsigned int)10+input[i]-'a';
+        }
+        else{
+            return 0;
+        }
+
+        if(i<3){
+            //左移4位留出半个字节
+            h=h<<4;
+        }
+    }
+
+    return h;
+}
+
+//convert a UTF-16 literal to UTF-8
+//a literal can be one or two sequence of the form \uXXXX
+
+static unsigned char utf16_literal_to_uft8(const unsigned char*const input_pointer,const unsigned char*const input_end,unsigned char**output_pointer){
+    long unsigned int codepoint=0;
+    unsigned int first_code=0;
+    const unsigned char*first_sequence=input_pointer;
+    unsigned char utf8_length=0;
+    unsigned char utf8_position=0;
+    unsigned char sequence_length=0;
+    unsigned char first_byte_mark=0;
+    //utf16使用2/4个字节进行储存 （0-FFFF）部分统一使用2个字节来进行储存,字符映射范围（U+0000-U+10FFFF）
+    //utf32使用固定的4个字节来进行储存
+    //utf8纯在单字节编码，使用1-6个字节进行储存，兼容ASCII,当编码超过一个字节，则设最高比特位为0
+    //当编码超过一个字节，则需要几个字节，就在第一个字节最高位开始令连续的几个比特为1，之后的字节最高为10
+    if((input_end-first_sequence)<6){
+        goto fail;
+    }
+
+    first_code=parse_hex4(first_sequence+2);
+
+    //utf16 surrogate pair
+    //一个生僻字符需要使用0xffff以上的映射范围，即需要两个码元，也即是4byte
+    //第一个码元(前导代理)：0xD800-0xDBFF
+    //第二个码元(后尾代理)：0xDC00-0xDFFF
+    //单独的前导代理不能够表示字符，必须与后尾代理一起构成一个完整字，即必须是双映射
+    if((first_code>=0xDC00)&&(first_code<=0xDFFF)){
+        goto fail;
+    }
+
+    if((first_code>=0xD800)&&(first_code<=0xDBFF)){
+        const unsigned char *second_sequence=first_sequence+6;
+        unsigned int second_code=0;
+        sequence_length=12;
+
+        if((input_end-second_sequence)<6){
+            goto fail;
+        }
+
+        if((second_sequence[0]!='\\')||(second_sequence[1]!='u')){
+            //missing second half of the surrogate pair
+            goto fail;
+        }
+
+        second_code=parse_hex4(second_sequence+2);
+
+        if((second_code<0xDC00)||(second_code>0xDFFF)){
+            goto fail;
+        }
+        //calculate the unicode codepoint from the surrogate pair
+        codepoint =0x10000+(((first_code&0x3ff)<<10)|(second_code&0x3ff));//映射方式
+    }
+    else{
+        sequence_length=6;
+        codepoint=first_code;
+    }
+
+    //encode as utf8
+    if(codepoint<0x80){
+        utf8_length=1;//normal ASCII.encoding 0xxxxxxx
+    }
+    else if(codepoint<0x800){
+        utf8_length=2;  //two bytes encoding 110xxxxx 10xxxxxx
+        first_byte_mark=0xc0; //11000000
+    }else if(codepoint<0x10000){
+        utf8_length=3;//three bytes encoding 1110xxxx 10xxxxxx 10xxxxxx 
+        first_byte_mark=0xe0;//11100000
+    }else if(codepoint<=0x10FFFF){
+        utf8_length=4;//four bytes,encoding 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+        first_byte_mark=0xF0; //11110000
+    }else{
+        goto fail;
+    }
+
+    for(utf8_position=(unsigned char)(utf8_length-1);utf8_position>0;utf8_position--){
+        (*output_pointer)[utf8_position]=(unsigned char)((codepoint|0x80)&0xbf);
+        codepoint>>=6;
+    }
+
+    if(utf8_length>1){
+        (*output_pointer)[0]=(unsigned char)((codepoint|first_byte_mark)&0xff);
+    }
+    else{
         (*output_pointer)[0]=(unsigned char)(codepoint&0x7F);
     }
-    *output_pointer+=utf8_length;
+    *output_pointer+=utf8_length;
+
+    return sequence_length;
+
+    
+
+fail:
+    return 0;
+}
+
+
+/* find the closing quote of a string,input_end points behind the opening quote.
+ * Whole blocks are scanned through the quote and backslash masks,the tail byte by byte.
+ * skipped_bytes counts the escape backslashes,which are not part of the output.
+ * If non_ascii is not NULL it receives the first byte >=0x80 in the string (or stays NULL),
+ * so pure ASCII strings never reach the UTF-8 validator */
+static const unsigned char *find_string_end(const unsigned char*input_end,const parse_buffer*const input_buffer,size_t*const skipped_bytes,const unsigned char**const non_ascii){
+    const unsigned char*const buffer_end=input_buffer->content+input_buffer->length;
+    block_state state={0,0};
+
+    while((size_t)(buffer_end-input_end)>=BLOCK_SIZE){
+        const uint64_t backslash=equal_mask(input_end,'\\');
+        const uint64_t escaped=escaped_mask(backslash,&state);
+        const uint64_t quotes=equal_mask(input_end,'\"')&~escaped;
+        uint64_t in_string=~(uint64_t)0;
+
+        if(quotes!=0){
+            in_string=(quotes&(0-quotes))-1;
+        }
+        if((non_ascii!=NULL)&&(*non_ascii==NULL)){
+            const uint64_t high_bits=high_bit_mask(input_end)&in_string;
+            if(high_bits!=0){
+                *non_ascii=input_end+trailing_zeroes(high_bits);
+            }
+        }
+
+        if(quotes!=0){
+            *skipped_bytes+=population_count(backslash&~escaped&in_string);
+            return input_end+trailing_zeroes(quotes);
+        }
+
+        *skipped_bytes+=population_count(backslash&~escaped);
+        input_end+=BLOCK_SIZE;
+    }
+
+    //the last block may have ended with an escape backslash
+    if(state.escaped_carry!=0){
+        if(input_end>=buffer_end){
+            return NULL;
+        }
+        input_end++;
+    }
+
+    while((input_end<buffer_end)&&(*input_end!='\"')){
+        if(input_end[0]=='\\'){
+            if((input_end+1)>=buffer_end){
+                return NULL;
+            }
+            (*skipped_bytes)++;
+            input_end++;
+        }
+        else if((input_end[0]>=0x80)&&(non_ascii!=NULL)&&(*non_ascii==NULL)){
+            *non_ascii=input_end;
+        }
+        input_end++;
+    }
+
+    if(input_end>=buffer_end){
+        return NULL;
+    }
+
+    return input_end;
+}
+
+//parse the input text into an unescaped cstring,and populate item.item may be NULL to only validate the input
+static cJSON_bool parse_string(cJSON*const item,parse_buffer*const input_buffer){
+    const unsigned char *input_pointer=buffer_at_offset(input_buffer)+1;
+    const unsigned char*input_end=NULL;
+    unsigned char *output_pointer=NULL;
+    unsigned char *output=NULL;
+    //validation writes every unescaped sequence here instead of into an allocation
+    unsigned char scratch[4];
+    size_t allocation_length=0;
+    size_t skipped_bytes=0;
+    const unsigned char*non_ascii=NULL;
+    const cJSON_bool validate_utf8=((input_buffer->flags&cJSON_ParseValidateUTF8)!=0);
+    profile_begin(string,input_buffer->offset);
+
+    if(buffer_at_offset(input_buffer)[0]!='\"'){
+        goto fail;
+    }
+
+    input_end=find_string_end(input_pointer,input_buffer,&skipped_bytes,validate_utf8?&non_ascii:NULL);
+    if(input_end==NULL){
+        //string ended unexpectedly
+        goto fail;
+    }
+
+    if(non_ascii!=NULL){
+        const unsigned char*invalid=find_invalid_utf8(non_ascii,input_end);
+        if(invalid!=NULL){
+            //report the offending byte
+            input_pointer=invalid;
+            goto fail;
+        }
+    }
+
+    if(item!=NULL){
+        //calculate approximate sizeof the output(overestimate)
+        allocation_length=(size_t)(input_end-buffer_at_offset(input_buffer))-skipped_bytes;
+        profile_begin(allocate,0);
+        output=(unsigned char*)parse_allocate(input_buffer,allocation_length+sizeof(""));
+        profile_end(allocate,cJSON_ProfileAllocate,allocation_length+sizeof(""));
+        if(output==NULL){
+            goto fail;
+        }
+        output_pointer=output;
+    }
+
+    while (input_pointer<input_end)
+    {
+        if(output==NULL){
+            output_pointer=scratch;
+        }
+
+        if(*input_pointer!='\\'){
+            *output_pointer++ = *input_pointer++;
+        }
+        else{
+            unsigned char sequence_length=2;
+            if((input_end-input_pointer)<1){
+                goto fail;
+            }
+            switch (input_pointer[1])
+            {
+            case 'b':
+                *output_pointer++='\b';
+                break;
+            case 'f':
+                *output_pointer++='\f';
+                break;
+            case 'n':
+                *output_pointer++='\n';
+                break;
+            case 'r':
+                *output_pointer++='\r';
+                break;
+            case 't':
+                *output_pointer++='\t';
+                break;
+            case '\"':
+            case '\\':
+            case '/':
+                *output_pointer++ = input_pointer[1];
+                break;
+            case 'u':
+                sequence_length=utf16_literal_to_uft8(input_pointer,input_end,&output_pointer);
+                if(sequence_length==0)
+                {
+                    goto fail;
+                }
+                break;
+            default:
+                goto fail;
+            }
+            input_pointer+=sequence_length;
+         
+        }
+
+    }
+
+    if(item!=NULL){
+        *output_pointer='\0';
+
+        item->type=cJSON_String;
+        item->valuestring=(char*)output;
+    }
+
+    input_buffer->offset=(size_t)(input_end-input_buffer->content);
+    input_buffer->offset++;
+    profile_end(string,cJSON_ProfileString,input_buffer->offset);
+    return true;
+    
+
+fail:
+    if(output!=NULL){
+        parse_deallocate(input_buffer,output);
+    }
+    if(input_buffer!=NULL){
+        input_buffer->offset=(size_t)(input_pointer-input_buffer->content);
+    }
+    profile_end(string,cJSON_ProfileString,input_buffer->offset);
+
+    
+    return false;
+
+}
+
+//Render the cstring provided to an secaped version that can be printed
+static cJSON_bool print_string_ptr(const unsigned char* const input,printbuffer*const output_buffer){
+    const unsigned char* input_pointer=NULL;
+    unsigned char* output=NULL;
+    unsigned char* output_pointer=NULL;
+    size_t output_length=0;
+
+    //numbers of additional characters needed for escaping
+    //即需要避免的额外的词汇
+    size_t escape_characters=0;
+
+    if(output_buffer==NULL){
+        return  false;
+    }
+
+    //empty string
+    if(input==NULL){
+        output=ensure(output_buffer,sizeof("\"\""));
+        if(output==NULL){
+            return false;
+        }
+        strcpy((char*)output,"\"\"");
+        return true;
+    }
+    
+    for(input_pointer=input;*input_pointer;input_pointer++){
+        switch (*input_pointer)
+        {
+        case '\"':
+        case '\\':
+        case '\b':
+        case '\f':
+        case '\n':
+        case '\r':
+        case '\t':
+            escape_characters++;
+            break;
+        
+        default:
+            //若ASCII值小于32，即无法找到对应的字符类型组成字符串
+            if(*input_pointer<32){
+                //utf16 escape sequence uXXXX
+                escape_characters+=5;
+            }
+            break;
+        }
+    }
+    //以上确定输出长度
+    output_length=(size_t)(input_pointer-input)+escape_characters;
+
+    output=ensure(output_buffer,output_length+sizeof("\"\""));
+    if(output==NULL){
+        return false;
+    }
+
+    //没有字符需要被跳过
+    if(escape_characters==0){
+        output[0]='\"';
+        memcpy(output+1,input,output_length);
+        output[output_length+1]='\"';
+        output[output_length+2]='\0';
+        return true;
+    }
+
+    output[0]='\"';
+    output_pointer=output+1;
+
+    for(input_pointer=input;*input_pointer!='\0';(void)input_pointer++,output_pointer++){
+        if((*input_pointer>31)&&(*input_pointer!='\"')&&(*input_pointer!='\\')){
+            *output_pointer=*input_pointer;
+        }
+        else{
+            *output_pointer++ ='\\';
+            switch (*input_pointer)
+            {
+            case '\\':
+                *output_pointer='\\';
+                break;
+            case '\"':
+                *output_pointer='\"';
+                break;
+            case '\b':
+                *output_pointer='b';
+                break;
+            case '\f':
+                *output_pointer='f';
+                break;
+            case '\n':
+                *output_pointer='n';
+                break;
+            case '\r':
+                *output_pointer='r';
+                break;
+            case '\t':
+                *output_pointer='t';
+                break;
+            default:
+                sprintf((char*)output_pointer,"u%04x",*input_pointer);
+                output_pointer+=4;
+                break;
+            }
+        }
+    }
+
+    output[output_length+1]='\"';
+    output[output_length+2]='\0';
+    return true;
+}
+
+static cJSON_bool print_string(const cJSON*const item,printbuffer*const p){
+    return print_string_ptr((unsigned char*)item->valuestring,p);
+}
+
+//Predeclare these prototypes
+static cJSON_bool parse_value(cJSON*const item,parse_buffer*const input_buffer);
+static cJSON_bool print_value(const cJSON *const item,printbuffer*const output_buffer);
+static cJSON_bool parse_array(cJSON*const item,parse_buffer *const input_buffer);
+static cJSON_bool print_array(const cJSON*const item,printbuffer*const output_buffer);
+static cJSON_bool parse_object(cJSON*const item,parse_buffer*const input_buffer);
+static cJSON_bool print_object(const cJSON*const item,printbuffer *const output_buffer);
+
+static parse_buffer *buffer_skip_whitespace(parse_buffer*const buffer){
+    if((buffer==NULL)||(buffer->content==NULL)){
+        return NULL;
+    }
+    profile_begin(whitespace,buffer->offset);
+    //将offset指针移动至第一个字符的位置
+    while (can_access_at_index(buffer,0)&&(buffer_at_offset(buffer)[0]<=32))
+    {
+        buffer->offset++;
+    }
+    profile_end(whitespace,cJSON_ProfileWhitespace,buffer->offset);
+
+    if(buffer->offset==buffer->length){
+        buffer->offset--;
+    }
+
+    return buffer;
+    
+}
+
+//skip the utf8 bom(byte order mark) if it is at the beginning of a buffer
+static parse_buffer *skip_utf8_bom(parse_buffer*const buffer){
+    if((buffer==NULL)||(buffer->content==NULL)||(buffer->offset!=0)){
+        return NULL;
+    }
+    //\xEF\xBF\xBB即bom文件的标记，用来指出这个文件是UTF8编码
+    if(can_access_at_index(buffer,4)&&(strncmp((const char *)buffer_at_offset(buffer),"\xEF\xBB\xBF",3)==0)){
+        buffer->offset+=3;
+    }
+
+    return buffer;
+}
+
+//Parse an object -create a new root ,and populate
+static cJSON *parse(const char*const value,const size_t length,const char**const return_parse_end,const int flags,const structural_index*const parallel){
+    parse_buffer buffer={0,0,0,0,{0,0,0},0,NULL,NULL};
+    cJSON *item=NULL;
+
+    //reset error position
+    global_error.json=NULL;
+    global_error.position=0;
+
+    if((value==NULL)||(length==0)){
+        goto fail;
+    }
+
+    buffer.content=(const unsigned char*)value;
+    buffer.length=length;
+    buffer.offset=0;
+    buffer.hooks=global_hooks;
+    buffer.flags=flags;
+    buffer.parallel=parallel;
+
+    item=cJSON_NEW_Item(&global_hooks);
+    if(item==NULL)
+    {
+        goto fail;
+    }
+
+    if(!parse_value(item,buffer_skip_whitespace(skip_utf8_bom(&buffer)))){
+        
+        goto fail;
+    }
+
+    //if we require null-terminated JSON without appended garbage ,skip and then check fo a null terminator
+    if(flags&cJSON_ParseRequireNullTerminated){
+        buffer_skip_whitespace(&buffer);
+        if((buffer.offset>=buffer.length)||buffer_at_offset(&buffer)[0]!='\0'){
+            goto fail;
+        }
+    }
+
+    if(return_parse_end){
+        *return_parse_end=(const char*)buffer_at_offset(&buffer);
+    }
+
+    return item;
+
+
+fail:
+    if(item!=NULL){
+        cJSON_Delete(item);
+    }
+    
+    if(value!=NULL){
+        error local_error;
+        local_error.json=(const unsigned char*)value;
+        local_error.position=0;
+
+        if(buffer.offset<buffer.length){
+            local_error.position=buffer.offset;
+        }
+        else if(buffer.length>0){
+            local_error.position=buffer.length-1;
+        }
+        if(return_parse_end!=NULL){
+            *return_parse_end=(const char *)local_error.json+local_error.position;
+        }
+        global_error=local_error;
+    }
+
+    return NULL;
+
+
+}
+
+CJSON_PUBLIC(cJSON*) cJSON_ParseWithFlags(const char*value,size_t length,const char**return_parse_end,int flags){
+    return parse(value,length,return_parse_end,flags,NULL);
+}
+
+CJSON_PUBLIC(cJSON*) cJSON_ParseWithOpts(const char*value,const char**return_parse_end,cJSON_bool require_null_terminated){
+    if(value==NULL){
+        global_error.json=NULL;
+        global_error.position=0;
+        return NULL;
+    }
+
+    //the '\0' is part of the buffer,so a terminator can be required
+    return cJSON_ParseWithFlags(value,strlen(value)+sizeof(""),return_parse_end,require_null_terminated?cJSON_ParseRequireNullTerminated:0);
+}
+
+
+CJSON_PUBLIC(cJSON*)cJSON_Parse(const char *value){
+    return cJSON_ParseWithOpts(value,0,0);
+}
+
+//run the parser over the input without building a tree,nothing is allocated
+CJSON_PUBLIC(cJSON_bool)cJSON_Validate(const char*json,size_t length,size_t*error_offset){
+    return cJSON_ValidateWithFlags(json,length,error_offset,0);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_ValidateWithFlags(const char*json,size_t length,size_t*error_offset,int flags){
+    parse_buffer buffer={0,0,0,0,{0,0,0},0,NULL,NULL};
+
+    if((json==NULL)||(length==0)){
+        if(error_offset!=NULL){
+            *error_offset=0;
+        }
+        return false;
+    }
+
+    buffer.content=(const unsigned char*)json;
+    buffer.length=length;
+    buffer.offset=0;
+    buffer.hooks=global_hooks;
+    buffer.flags=flags;
+
+    if(!parse_value(NULL,buffer_skip_whitespace(skip_utf8_bom(&buffer)))){
+        goto fail;
+    }
+
+    //only whitespace may follow the value
+    while((buffer.offset<buffer.length)&&(buffer_at_offset(&buffer)[0]<=32)){
+        buffer.offset++;
+    }
+    if(buffer.offset<buffer.length){
+        goto fail;
+    }
+
+    return true;
+
+fail:
+    if(error_offset!=NULL){
+        *error_offset=(buffer.offset<buffer.length)?buffer.offset:(buffer.length-1);
+    }
+
+    return false;
+}
+
+//every parser gets its own,so shapes of different parsers never look alike
+static size_t parser_generation=0;
+
+CJSON_PUBLIC(cJSON_Parser*)cJSON_CreateParser(size_t capacity,int flags){
+    cJSON_Parser *parser=(cJSON_Parser*)global_hooks.allocate(sizeof(cJSON_Parser));
+    if(parser==NULL){
+        return NULL;
+    }
+    memset(parser,0,sizeof(cJSON_Parser));
+    parser->hooks=global_hooks;
+    parser->flags=flags;
+    parser->empty_shape.generation=atomic_add_size(&parser_generation,1);
+
+    if(capacity>0){
+        parser->chunk=parser_new_chunk(parser,parser_align(capacity));
+        if(parser->chunk==NULL){
+            parser->hooks.deallcoate(parser);
+            return NULL;
+        }
+    }
+
+    return parser;
+}
+
+CJSON_PUBLIC(const cJSON*)cJSON_ParserParse(cJSON_Parser*const parser,const char*value,size_t length,const char**return_parse_end){
+    parse_buffer buffer={0,0,0,0,{0,0,0},0,NULL,NULL};
+    cJSON *item=NULL;
+
+    if(parser==NULL){
+        return NULL;
+    }
+    //the previous tree goes away with every parse
+    parser_rewind(parser);
+
+    if((value==NULL)||(length==0)){
+        goto fail;
+    }
+
+    buffer.content=(const unsigned char*)value;
+    buffer.length=length;
+    buffer.offset=0;
+    buffer.hooks=parser->hooks;
+    buffer.flags=parser->flags;
+    buffer.parser=parser;
+
+    item=parse_new_item(&buffer);
+    if(item==NULL){
+        goto fail;
+    }
+
+    if(!parse_value(item,buffer_skip_whitespace(skip_utf8_bom(&buffer)))){
+        goto fail;
+    }
+
+    if(parser->flags&cJSON_ParseRequireNullTerminated){
+        buffer_skip_whitespace(&buffer);
+        if((buffer.offset>=buffer.length)||buffer_at_offset(&buffer)[0]!='\0'){
+            goto fail;
+        }
+    }
+
+    if(return_parse_end!=NULL){
+        *return_parse_end=(const char*)buffer_at_offset(&buffer);
+    }
+
+    return item;
+
+fail:
+    parser_rewind(parser);
+
+    //the position is the parser's own,the global error is left alone
+    if((value!=NULL)&&(return_parse_end!=NULL)){
+        size_t position=0;
+        if(buffer.offset<buffer.length){
+            position=buffer.offset;
+        }else if(buffer.length>0){
+            position=buffer.length-1;
+        }
+        *return_parse_end=value+position;
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(void)cJSON_ParserReset(cJSON_Parser*const parser){
+    if(parser==NULL){
+        return;
+    }
+    parser_rewind(parser);
+}
+
+CJSON_PUBLIC(void)cJSON_DeleteParser(cJSON_Parser*parser){
+    size_t index=0;
+
+    if(parser==NULL){
+        return;
+    }
+
+    digest_forget();
+    while(parser->retired!=NULL){
+        parser_chunk *const next=parser->retired->next;
+        parser->hooks.deallcoate(parser->retired);
+        parser->retired=next;
+    }
+    if(parser->chunk!=NULL){
+        parser->hooks.deallcoate(parser->chunk);
+    }
+    for(index=0;index<parser->intern_capacity;index++){
+        if(parser->interned[index].key!=NULL){
+            parser->hooks.deallcoate((void*)parser->interned[index].key);
+        }
+    }
+    if(parser->interned!=NULL){
+        parser->hooks.deallcoate(parser->interned);
+    }
+    while(parser->shapes!=NULL){
+        cJSON_Shape *const created=parser->shapes->created;
+        parser->hooks.deallcoate(parser->shapes);
+        parser->shapes=created;
+    }
+    parser->hooks.deallcoate(parser);
+}
+
+#define cjson_min(a,b) ((a<b)?a:b)
+
+/* Array streams parse the elements of a top-level array one at a time. Over a
+ * buffer the parser runs in place. Over a reader the window holds the current
+ * element only: the end of an element is found with the block masks first,then
+ * the element is parsed,so a large element is read once and not reparsed.
+ * Record streams share the machinery for newline-delimited JSON,where a raw
+ * newline cannot occur inside a value and so ends each record. */
+#define STREAM_CHUNK 65536
+
+enum{
+    STREAM_START,//before '['
+    STREAM_FIRST,//after '[',the next element has no ','
+    STREAM_NEXT,//after an element
+    STREAM_DONE,
+    STREAM_FAILED
+};
+
+struct cJSON_ArrayStream
+{
+    const unsigned char *content;//the caller's buffer or the window
+    size_t length;
+    size_t offset;
+    size_t consumed;//bytes dropped from the front of the window
+    unsigned char *window;//NULL over a buffer
+    size_t capacity;
+    cJSON_StreamReader read;
+    void *context;
+    int fd;
+    int flags;
+    int state;
+    cJSON_bool end_of_input;
+    cJSON_bool records;//one value per line instead of one array
+};
+
+//read the rest of the input behind the window,false at the end of the input or on error
+static cJSON_bool stream_refill(cJSON_ArrayStream*const stream){
+    size_t received=0;
+
+    if((stream->window==NULL)||stream->end_of_input){
+        stream->end_of_input=true;
+        return false;
+    }
+
+    //drop what was consumed,the window starts at the current position
+    if(stream->offset>0){
+        memmove(stream->window,stream->window+stream->offset,stream->length-stream->offset);
+        stream->consumed+=stream->offset;
+        stream->length-=stream->offset;
+        stream->offset=0;
+    }
+    if(stream->length==stream->capacity){
+        unsigned char *grown=NULL;
+        if(stream->capacity>((size_t)-1)/2){
+            stream->state=STREAM_FAILED;
+            return false;
+        }
+        if(global_hooks.realloccate!=NULL){
+            grown=(unsigned char*)global_hooks.realloccate(stream->window,stream->capacity*2);
+        }else{
+            grown=(unsigned char*)global_hooks.allocate(stream->capacity*2);
+            if(grown!=NULL){
+                memcpy(grown,stream->window,stream->length);
+                global_hooks.deallcoate(stream->window);
+            }
+        }
+        if(grown==NULL){
+            stream->state=STREAM_FAILED;
+            return false;
+        }
+        stream->window=grown;
+        stream->capacity*=2;
+    }
+
+    received=stream->read(stream->context,(char*)stream->window+stream->length,stream->capacity-stream->length);
+    if(received==(size_t)-1){
+        stream->state=STREAM_FAILED;
+        return false;
+    }
+    if(received==0){
+        stream->end_of_input=true;
+        return false;
+    }
+    stream->length+=received;
+    stream->content=stream->window;
+
+    return true;
+}
+
+//skip whitespace,false if the input ends first
+static cJSON_bool stream_skip_whitespace(cJSON_ArrayStream*const stream){
+    for(;;){
+        while((stream->offset<stream->length)&&(stream->content[stream->offset]<=32)){
+            stream->offset++;
+        }
+        if(stream->offset<stream->length){
+            return true;
+        }
+        if(!stream_refill(stream)){
+            return false;
+        }
+    }
+}
+
+/* Find the ',' or ']' that ends the element at the current position,reading
+ * more input as needed. Positions are relative to the element,which stays at
+ * the front of the window while it grows. */
+static cJSON_bool stream_find_element_end(cJSON_ArrayStream*const stream,size_t*const end){
+    block_state state={0,0};
+    block_masks masks;
+    unsigned char padded[BLOCK_SIZE];
+    size_t position=0;
+    size_t depth=0;
+
+    for(;;){
+        const size_t available=stream->length-stream->offset-position;
+        const unsigned char *block=stream->content+stream->offset+position;
+        uint64_t in_string=0;
+        uint64_t open=0;
+        uint64_t close=0;
+        uint64_t structural=0;
+
+        if((available<BLOCK_SIZE)&&!stream->end_of_input){
+            if(!stream_refill(stream)&&(stream->state==STREAM_FAILED)){
+                return false;
+            }
+            continue;
+        }
+        if(available==0){
+            //the input ends inside the element
+            return false;
+        }
+        if(available<BLOCK_SIZE){
+            memset(padded,' ',sizeof(padded));
+            memcpy(padded,block,available);
+            block=padded;
+        }
+
+        classify_block(block,&masks);
+        in_string=string_mask(&masks,&state);
+        open=(equal_mask(block,'[')|equal_mask(block,'{'))&~in_string;
+        close=(equal_mask(block,']')|equal_mask(block,'}'))&~in_string;
+        structural=open|close|(equal_mask(block,',')&~in_string);
+
+        while(structural!=0){
+            const unsigned int index=trailing_zeroes(structural);
+            const uint64_t bit=(uint64_t)1<<index;
+            structural&=structural-1;
+
+            if(open&bit){
+                depth++;
+            }else if(depth==0){
+                *end=stream->offset+position+index;
+                return true;
+            }else if(close&bit){
+                depth--;
+            }
+        }
+
+        position+=cjson_min(available,(size_t)BLOCK_SIZE);
+    }
+}
+
+//find the '\n' that ends the record at the current position,the end of the input if there is none
+static cJSON_bool stream_find_line_end(cJSON_ArrayStream*const stream,size_t*const end){
+    size_t position=0;
+
+    for(;;){
+        const unsigned char *const start=stream->content+stream->offset;
+        const unsigned char *const newline=(const unsigned char*)memchr(start+position,'\n',stream->length-stream->offset-position);
+        if(newline!=NULL){
+            *end=(size_t)(newline-stream->content);
+            return true;
+        }
+        position=stream->length-stream->offset;
+        if(!stream_refill(stream)){
+            *end=stream->length;
+            return stream->state!=STREAM_FAILED;
+        }
+    }
+}
+
+static cJSON_ArrayStream *create_array_stream(const int flags){
+    cJSON_ArrayStream *stream=(cJSON_ArrayStream*)global_hooks.allocate(sizeof(cJSON_ArrayStream));
+    if(stream==NULL){
+        return NULL;
+    }
+    memset(stream,0,sizeof(cJSON_ArrayStream));
+    stream->fd=-1;
+    stream->flags=flags;
+    stream->state=STREAM_START;
+
+    return stream;
+}
+
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateArrayStream(const char*json,size_t length,int flags){
+    cJSON_ArrayStream *stream=NULL;
+
+    if(json==NULL){
+        return NULL;
+    }
+
+    stream=create_array_stream(flags);
+    if(stream==NULL){
+        return NULL;
+    }
+    stream->content=(const unsigned char*)json;
+    stream->length=length;
+    stream->end_of_input=true;
+
+    return stream;
+}
+
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateArrayStreamReader(cJSON_StreamReader read,void*context,int flags){
+    cJSON_ArrayStream *stream=NULL;
+
+    if(read==NULL){
+        return NULL;
+    }
+
+    stream=create_array_stream(flags);
+    if(stream==NULL){
+        return NULL;
+    }
+    stream->window=(unsigned char*)global_hooks.allocate(STREAM_CHUNK);
+    if(stream->window==NULL){
+        global_hooks.deallcoate(stream);
+        return NULL;
+    }
+    stream->content=stream->window;
+    stream->capacity=STREAM_CHUNK;
+    stream->read=read;
+    stream->context=context;
+
+    return stream;
+}
+
+CJSON_PUBLIC(size_t)cJSON_StreamReadFd(void*context,char*buffer,size_t size){
+    const int fd=*(const int*)context;
+
+    if(size>INT_MAX){
+        size=INT_MAX;
+    }
+#if defined(_WIN32)
+    {
+        const int received=_read(fd,buffer,(unsigned int)size);
+        return (received<0)?(size_t)-1:(size_t)received;
+    }
+#else
+    for(;;){
+        const ssize_t received=read(fd,buffer,size);
+        if(received>=0){
+            return (size_t)received;
+        }
+        if(errno!=EINTR){
+            return (size_t)-1;
+        }
+    }
+#endif
+}
+
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateArrayStreamFd(int fd,int flags){
+    cJSON_ArrayStream *stream=NULL;
+
+    if(fd<0){
+        return NULL;
+    }
+
+    stream=cJSON_CreateArrayStreamReader(cJSON_StreamReadFd,NULL,flags);
+    if(stream==NULL){
+        return NULL;
+    }
+    stream->fd=fd;
+    stream->context=&stream->fd;
+
+    return stream;
+}
+
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateRecordStream(const char*json,size_t length,int flags){
+    cJSON_ArrayStream *const stream=cJSON_CreateArrayStream(json,length,flags);
+    if(stream!=NULL){
+        stream->records=true;
+    }
+
+    return stream;
+}
+
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateRecordStreamReader(cJSON_StreamReader read,void*context,int flags){
+    cJSON_ArrayStream *const stream=cJSON_CreateArrayStreamReader(read,context,flags);
+    if(stream!=NULL){
+        stream->records=true;
+    }
+
+    return stream;
+}
+
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateRecordStreamFd(int fd,int flags){
+    cJSON_ArrayStream *const stream=cJSON_CreateArrayStreamFd(fd,flags);
+    if(stream!=NULL){
+        stream->records=true;
+    }
+
+    return stream;
+}
+
+//the value on the next line that is not empty
+static cJSON *record_stream_next(cJSON_ArrayStream*const stream){
+    parse_buffer buffer={0,0,0,0,{0,0,0},0,NULL,NULL};
+    cJSON *item=NULL;
+    size_t end=0;
+
+    if(!stream_skip_whitespace(stream)){
+        if(stream->state!=STREAM_FAILED){
+            stream->state=STREAM_DONE;
+        }
+        return NULL;
+    }
+    if(!stream_find_line_end(stream,&end)){
+        goto fail;
+    }
+
+    //the '\n' stays in the buffer,so the parser sees where the line ends
+    buffer.content=stream->content;
+    buffer.length=(end<stream->length)?(end+1):end;
+    buffer.offset=stream->offset;
+    buffer.hooks=global_hooks;
+    buffer.flags=stream->flags;
+
+    item=cJSON_NEW_Item(&global_hooks);
+    if(item==NULL){
+        goto fail;
+    }
+    if(!parse_value(item,&buffer)){
+        stream->offset=buffer.offset;
+        cJSON_Delete(item);
+        goto fail;
+    }
+
+    //only whitespace may follow on the line
+    while((buffer.offset<end)&&(buffer_at_offset(&buffer)[0]<=32)){
+        buffer.offset++;
+    }
+    stream->offset=buffer.offset;
+    if(buffer.offset<end){
+        cJSON_Delete(item);
+        goto fail;
+    }
+
+    return item;
+
+fail:
+    stream->state=STREAM_FAILED;
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_ArrayStreamNext(cJSON_ArrayStream*const stream){
+    parse_buffer buffer={0,0,0,0,{0,0,0},0,NULL,NULL};
+    cJSON *item=NULL;
+
+    if((stream==NULL)||(stream->state==STREAM_DONE)||(stream->state==STREAM_FAILED)){
+        return NULL;
+    }
+
+    if((stream->state!=STREAM_START)&&stream->records){
+        return record_stream_next(stream);
+    }
+    if(stream->state==STREAM_START){
+        //skip a UTF-8 BOM,the window holds at least 3 bytes unless the input is shorter
+        while(stream->length-stream->offset<3){
+            if(!stream_refill(stream)){
+                break;
+            }
+        }
+        if((stream->length-stream->offset>=3)&&(strncmp((const char*)stream->content+stream->offset,"\xEF\xBB\xBF",3)==0)){
+            stream->offset+=3;
+        }
+        if(stream->records){
+            stream->state=STREAM_FIRST;
+            return record_stream_next(stream);
+        }
+        if(!stream_skip_whitespace(stream)||(stream->content[stream->offset]!='[')){
+            goto fail;
+        }
+        stream->offset++;
+        stream->state=STREAM_FIRST;
+    }
+
+    if(!stream_skip_whitespace(stream)){
+        goto fail;
+    }
+    if(stream->content[stream->offset]==']'){
+        stream->offset++;
+        goto done;
+    }
+    if(stream->state==STREAM_NEXT){
+        if(stream->content[stream->offset]!=','){
+            goto fail;
+        }
+        stream->offset++;
+        if(!stream_skip_whitespace(stream)){
+            goto fail;
+        }
+    }
+
+    buffer.content=stream->content;
+    buffer.length=stream->length;
+    buffer.offset=stream->offset;
+    buffer.depth=1;//inside the top-level array
+    buffer.hooks=global_hooks;
+    buffer.flags=stream->flags;
+    if(stream->window!=NULL){
+        //the parser never runs past the end of the element
+        if(!stream_find_element_end(stream,&buffer.length)){
+            if(stream->state==STREAM_FAILED){
+                goto fail;
+            }
+            //the input ends inside the element,which is all in the window now
+            buffer.length=stream->length;
+        }
+        buffer.content=stream->content;
+        buffer.offset=stream->offset;
+    }
+
+    item=cJSON_NEW_Item(&global_hooks);
+    if(item==NULL){
+        goto fail;
+    }
+    if(!parse_value(item,&buffer)){
+        stream->offset=buffer.offset;
+        cJSON_Delete(item);
+        goto fail;
+    }
+    stream->offset=buffer.offset;
+    stream->state=STREAM_NEXT;
+
+    return item;
+
+done:
+    stream->state=STREAM_DONE;
+    if(stream->flags&cJSON_ParseRequireNullTerminated){
+        //only whitespace and a '\0' may follow the array
+        if(stream_skip_whitespace(stream)&&(stream->content[stream->offset]!='\0')){
+            goto fail;
+        }
+    }
+
+    return NULL;
+
+fail:
+    stream->state=STREAM_FAILED;
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_ArrayStreamFailed(const cJSON_ArrayStream*const stream,size_t*const error_offset){
+    if(stream==NULL){
+        return true;
+    }
+    if(error_offset!=NULL){
+        *error_offset=stream->consumed+stream->offset;
+    }
+
+    return stream->state==STREAM_FAILED;
+}
+
+CJSON_PUBLIC(void)cJSON_DeleteArrayStream(cJSON_ArrayStream*const stream){
+    if(stream==NULL){
+        return;
+    }
+    if(stream->window!=NULL){
+        global_hooks.deallcoate(stream->window);
+    }
+    global_hooks.deallcoate(stream);
+}
+
+/* Files. A large regular file is mapped and read ahead sequentially,so the
+ * kernel pages it in while the parser runs. A pipe or other stream holding a
+ * top-level array is parsed an element at a time through an array stream as
+ * the data arrives. Anything else is read in full,then parsed. */
+#ifndef CJSON_FILE_MAP_MIN_SIZE
+#define CJSON_FILE_MAP_MIN_SIZE ((size_t)1<<20)
+#endif
+
+typedef struct
+{
+    int fd;
+    const unsigned char *prefix;//read before the stream was created
+    size_t prefix_length;
+}file_reader;
+
+static size_t file_read(void*context,char*buffer,size_t size){
+    file_reader *const reader=(file_reader*)context;
+
+    if(reader->prefix_length>0){
+        const size_t count=cjson_min(size,reader->prefix_length);
+        memcpy(buffer,reader->prefix,count);
+        reader->prefix+=count;
+        reader->prefix_length-=count;
+        return count;
+    }
+
+    return cJSON_StreamReadFd(&reader->fd,buffer,size);
+}
+
+//read until the buffer holds wanted bytes or the input ends,false on error
+static cJSON_bool file_fill(int fd,unsigned char**const content,size_t*const length,size_t*const capacity,const size_t wanted,cJSON_bool*const end_of_input){
+    while((*length<wanted)&&!*end_of_input){
+        size_t received=0;
+
+        if(*length==*capacity){
+            unsigned char *grown=NULL;
+            if(*capacity>((size_t)-1)/2){
+                return false;
+            }
+            if(global_hooks.realloccate!=NULL){
+                grown=(unsigned char*)global_hooks.realloccate(*content,*capacity*2);
+            }else{
+                grown=(unsigned char*)global_hooks.allocate(*capacity*2);
+                if(grown!=NULL){
+                    memcpy(grown,*content,*length);
+                    global_hooks.deallcoate(*content);
+                }
+            }
+            if(grown==NULL){
+                return false;
+            }
+            *content=grown;
+            *capacity*=2;
+        }
+
+        received=cJSON_StreamReadFd(&fd,(char*)*content+*length,*capacity-*length);
+        if(received==(size_t)-1){
+            return false;
+        }
+        if(received==0){
+            *end_of_input=true;
+        }
+        *length+=received;
+    }
+
+    return true;
+}
+
+//offset of the first byte of the value,length if it is not buffered yet
+static size_t file_value_start(const unsigned char*const content,const size_t length){
+    size_t offset=0;
+
+    if((length>=3)&&(strncmp((const char*)content,"\xEF\xBB\xBF",3)==0)){
+        offset=3;
+    }
+    while((offset<length)&&(content[offset]<=32)){
+        offset++;
+    }
+
+    return offset;
+}
+
+static cJSON *parse_file_content(const unsigned char*const content,const size_t length,const int flags,const int threads,size_t*const error_position){
+    const char *end=NULL;
+    size_t offset=0;
+    cJSON *item=NULL;
+
+    //a file has no terminator,with cJSON_ParseRequireNullTerminated only whitespace may follow
+    item=cJSON_ParseParallel((const char*)content,length,&end,flags&~cJSON_ParseRequireNullTerminated,threads);
+    offset=(end!=NULL)?(size_t)((const unsigned char*)end-content):0;
+    if((item!=NULL)&&(flags&cJSON_ParseRequireNullTerminated)){
+        while((offset<length)&&(content[offset]<=32)){
+            offset++;
+        }
+        if(offset<length){
+            cJSON_Delete(item);
+            item=NULL;
+        }
+    }
+    if(item==NULL){
+        *error_position=offset;
+    }
+
+    return item;
+}
+
+static cJSON *parse_file_stream(file_reader*const reader,const int flags,size_t*const error_position){
+    cJSON_ArrayStream *stream=NULL;
+    cJSON *array=NULL;
+    cJSON *element=NULL;
+
+    stream=cJSON_CreateArrayStreamReader(file_read,reader,flags);
+    array=cJSON_CreateArray();
+    if((stream==NULL)||(array==NULL)){
+        goto fail;
+    }
+
+    while((element=cJSON_ArrayStreamNext(stream))!=NULL){
+        cJSON_AddItemToArray(array,element);
+    }
+    if(cJSON_ArrayStreamFailed(stream,error_position)){
+        goto fail;
+    }
+    cJSON_DeleteArrayStream(stream);
+
+    return array;
+
+fail:
+    cJSON_DeleteArrayStream(stream);
+    cJSON_Delete(array);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_ParseFile(const char*path,int flags,int threads,size_t*error_offset){
+    unsigned char *content=NULL;
+    size_t length=0;
+    size_t capacity=STREAM_CHUNK;
+    size_t error_position=0;
+    cJSON_bool end_of_input=false;
+    cJSON_bool regular=false;
+    cJSON *item=NULL;
+    int fd=-1;
+#if defined(_WIN32)
+    struct _stat64 status;
+#else
+    struct stat status;
+#endif
+
+    if(path==NULL){
+        goto done;
+    }
+
+#if defined(_WIN32)
+    fd=_open(path,_O_RDONLY|_O_BINARY);
+    if((fd<0)||(_fstat64(fd,&status)!=0)){
+        goto done;
+    }
+    regular=(status.st_mode&_S_IFMT)==_S_IFREG;
+#else
+    do{
+        fd=open(path,O_RDONLY);
+    }while((fd<0)&&(errno==EINTR));
+    if((fd<0)||(fstat(fd,&status)!=0)){
+        goto done;
+    }
+    regular=S_ISREG(status.st_mode);
+
+    //the mapping must stay unchanged while the parser runs
+    if(regular&&((unsigned long long)status.st_size>=CJSON_FILE_MAP_MIN_SIZE)&&((unsigned long long)status.st_size<=(size_t)-1)){
+        const size_t size=(size_t)status.st_size;
+        void *const map=mmap(NULL,size,PROT_READ,MAP_PRIVATE,fd,0);
+        if(map!=MAP_FAILED){
+#if defined(MADV_SEQUENTIAL)
+            madvise(map,size,MADV_SEQUENTIAL);
+#endif
+            item=parse_file_content((const unsigned char*)map,size,flags,threads,&error_position);
+            munmap(map,size);
+            goto done;
+        }
+    }
+#endif
+
+    //a regular file is read in one go,its size plus one byte to see the end
+    if(regular&&(status.st_size>0)&&((unsigned long long)status.st_size<((size_t)-1)/2)){
+        capacity=(size_t)status.st_size+1;
+    }
+    content=(unsigned char*)global_hooks.allocate(capacity);
+    if(content==NULL){
+        goto done;
+    }
+
+    if(!regular){
+        //read until the first byte of the value arrives,past a possible BOM
+        size_t start=0;
+        while(((length<3)||((start=file_value_start(content,length))==length))&&!end_of_input){
+            if(!file_fill(fd,&content,&length,&capacity,length+1,&end_of_input)){
+                goto done;
+            }
+        }
+        if((start<length)&&(content[start]=='[')){
+            file_reader reader;
+            reader.fd=fd;
+            reader.prefix=content;
+            reader.prefix_length=length;
+            item=parse_file_stream(&reader,flags,&error_position);
+            goto done;
+        }
+    }
+
+    if(!file_fill(fd,&content,&length,&capacity,(size_t)-1,&end_of_input)){
+        goto done;
+    }
+    item=parse_file_content(content,length,flags,threads,&error_position);
+
+done:
+    if(fd>=0){
+#if defined(_WIN32)
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+    if(content!=NULL){
+        global_hooks.deallcoate(content);
+    }
+    //the error position pointed into a buffer that is gone
+    global_error.json=NULL;
+    global_error.position=0;
+    if((item==NULL)&&(error_offset!=NULL)){
+        *error_offset=error_position;
+    }
+
+    return item;
+}
+
+
+static unsigned char*print(const cJSON* const item,cJSON_bool format,const size_t threads,const internal_hooks*const hooks){
+    static const size_t default_buffer_size=256;
+    printbuffer buffer[1];
+    unsigned char*printed=NULL;
+    //memset 将一段内存空间全部设置为某个字符
+    memset(buffer,0,sizeof(buffer));
+    
+    //create buffer
+    buffer->buffer=(unsigned char*)hooks->allocate(default_buffer_size);
+    buffer->length=default_buffer_size;
+    buffer->format=format;
+    buffer->hooks=*hooks;
+    buffer->threads=threads;
+    if(buffer->buffer==NULL){
+        goto fail;
+    }
+
+    if(!print_value(item,buffer)){
+        goto fail;
+    }
+    update_offset(buffer);
+
+    if(hooks->realloccate!=NULL){
+        printed=(unsigned char*)hooks->realloccate(buffer->buffer,buffer->offset+1);
+        if(printed==NULL){
+            goto fail;
+        }
+        buffer->buffer=NULL;
+    }
+    else
+    {
+        printed=(unsigned char*)hooks->allocate(buffer->offset+1);
+        if(printed==NULL){
+            goto fail;
+        }
+        memcpy(printed,buffer->buffer,cjson_min(buffer->length,buffer->offset+1));
+        printed[buffer->offset]='\0';
+
+        hooks->deallcoate(buffer->buffer);
+    }
+
+    return printed;
+    
+
+fail:
+    if(buffer->buffer!=NULL){
+        hooks->deallcoate(buffer->buffer);
+    }
+
+    if(printed!=NULL){
+        hooks->deallcoate(printed);
+    }
+    return NULL;                                           
+}
+
+CJSON_PUBLIC(char*)cJSON_Print(const cJSON*item){
+    return (char *)print(item,true,0,&global_hooks);
+}
+
+CJSON_PUBLIC(char*)cJSON_PrintUnformatted(const cJSON*item){
+    return (char*)print(item,false,0,&global_hooks);
+}
+
+CJSON_PUBLIC(char*)cJSON_PrintParallel(const cJSON*item,cJSON_bool format,int threads){
+    return (char*)print(item,format,(threads>1)?(size_t)threads:0,&global_hooks);
+}
+
+CJSON_PUBLIC(char*)cJSON_PrintBuffered(const cJSON *item,int prebuffer,cJSON_bool fmt){
+    printbuffer p={0,0,0,0,0,0,{0,0,0},0};
+    if(prebuffer<0){
+        return NULL;
+    }
+    p.buffer=(unsigned char*)global_hooks.allocate((size_t)prebuffer);
+    if(!p.buffer){
+        return NULL;
+    }
+
+    p.length=(size_t)prebuffer;
+    p.offset=0;
+    p.noalloc=false;
+    p.format=fmt;
+    p.hooks=global_hooks;
+
+    if(!print_value(item,&p)){
+        global_hooks.deallcoate(p.buffer);
+        return NULL;
+    }
+
+    return (char*)p.buffer;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_PrintPreallocated(cJSON*item,char *buf,const int len,const cJSON_bool fmt){
+     printbuffer p={0,0,0,0,0,0,{0,0,0},0};
+     if((len<0)||(buf==NULL)){
+         return false;
+     }
+
+     p.buffer=(unsigned char*)buf;
+     p.length=(size_t)len;
+     p.offset=0;
+     p.format=fmt;
+     p.hooks=global_hooks;
+
+     return print_value(item,&p);
+}
+
+//a printer keeps its buffer between calls,so steady-state printing does not allocate
+struct cJSON_Printer
+{
+    unsigned char *buffer;
+    size_t capacity;
+    size_t length;//length of the last printed text,without the '\0'
+    internal_hooks hooks;
+};
+
+CJSON_PUBLIC(cJSON_Printer*)cJSON_CreatePrinter(size_t capacity){
+    cJSON_Printer *printer=(cJSON_Printer*)global_hooks.allocate(sizeof(cJSON_Printer));
+    if(printer==NULL){
+        return NULL;
+    }
+    memset(printer,0,sizeof(cJSON_Printer));
+    printer->hooks=global_hooks;
+
+    if(capacity>0){
+        printer->buffer=(unsigned char*)printer->hooks.allocate(capacity);
+        if(printer->buffer==NULL){
+            printer->hooks.deallcoate(printer);
+            return NULL;
+        }
+        printer->capacity=capacity;
+    }
+
+    return printer;
+}
+
+static cJSON_bool cbor_encode_value(const cJSON*const item,printbuffer*const output_buffer);
+
+//render item into the printer's buffer,either as text or as CBOR
+static const unsigned char *printer_render(cJSON_Printer*const printer,const cJSON*const item,const cJSON_bool format,const cJSON_bool cbor,size_t*const length){
+    static const size_t default_buffer_size=256;
+    printbuffer p={0,0,0,0,0,0,{0,0,0},0};
+
+    if((printer==NULL)||(item==NULL)){
+        return NULL;
+    }
+
+    //the previous view is invalidated by every print
+    printer->length=0;
+
+    if(printer->buffer==NULL){
+        printer->buffer=(unsigned char*)printer->hooks.allocate(default_buffer_size);
+        if(printer->buffer==NULL){
+            return NULL;
+        }
+        printer->capacity=default_buffer_size;
+    }
+
+    p.buffer=printer->buffer;
+    p.length=printer->capacity;
+    p.offset=0;
+    p.noalloc=false;
+    p.format=format;
+    p.hooks=printer->hooks;
+
+    if(!(cbor?cbor_encode_value(item,&p):print_value(item,&p))){
+        //ensure() frees the buffer when growing fails
+        printer->buffer=p.buffer;
+        printer->capacity=p.length;
+        return NULL;
+    }
+    if(!cbor){
+        update_offset(&p);
+    }
+
+    //keep whatever ensure() grew the buffer to,this is the high-water capacity
+    printer->buffer=p.buffer;
+    printer->capacity=p.length;
+    printer->length=p.offset;
+
+    if(length!=NULL){
+        *length=printer->length;
+    }
+
+    return printer->buffer;
+}
+
+CJSON_PUBLIC(const char*)cJSON_PrinterPrint(cJSON_Printer*const printer,const cJSON*const item,const cJSON_bool format,size_t*const length){
+    return (const char*)printer_render(printer,item,format,false,length);
+}
+
+CJSON_PUBLIC(void)cJSON_PrinterReset(cJSON_Printer*const printer){
+    if(printer==NULL){
+        return;
+    }
+
+    //drop the last view but keep the buffer and its capacity
+    printer->length=0;
+    if(printer->buffer!=NULL){
+        printer->buffer[0]='\0';
+    }
+}
+
+CJSON_PUBLIC(void)cJSON_DeletePrinter(cJSON_Printer*printer){
+    if(printer==NULL){
+        return;
+    }
+    if(printer->buffer!=NULL){
+        printer->hooks.deallcoate(printer->buffer);
+    }
+    printer->hooks.deallcoate(printer);
+}
+
+//Parser core -when encountering text,process appropriately.item may be NULL to only validate the input
+static cJSON_bool parse_value(cJSON*const item,parse_buffer *const input_buffer){
+    if((input_buffer==NULL)||(input_buffer->content==NULL)){
+        return false;
+    }
+
+    //parse the different types of values
+    //NULL
+    if(can_read(input_buffer,4)&&(strncmp((const char*)buffer_at_offset(input_buffer),"null",4)==0)){
+        if(item!=NULL){
+            item->type=cJSON_NULL;
+        }
+        input_buffer->offset+=4;
+        return true;
+    }
+
+    //false
+    if(can_read(input_buffer,5)&&(strncmp((const char*)buffer_at_offset(input_buffer),"false",5)==0)){
+        if(item!=NULL){
+            item->type=cJSON_False;
+        }
+        input_buffer->offset+=5;
+        return true;
+    }
+
+    //true
+    if(can_read(input_buffer,4)&&(strncmp((const char*)buffer_at_offset(input_buffer),"true",4)==0)){
+        if(item!=NULL){
+            item->type=cJSON_True;
+            item->valueint=1;
+        }
+        input_buffer->offset+=4;
+        return true;
+    }
+
+    //string
+    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='\"')){
+        return parse_string(item,input_buffer);
+    }
+
+    //number
+    if(can_access_at_index(input_buffer,0)&&((buffer_at_offset(input_buffer)[0]=='-')||((buffer_at_offset(input_buffer)[0]>='0')&&(buffer_at_offset(input_buffer)[0]<='9')))){
+        cJSON_bool parsed=false;
+        profile_begin(number,input_buffer->offset);
+        parsed=parse_number(item,input_buffer);
+        profile_end(number,cJSON_ProfileNumber,input_buffer->offset);
+        return parsed;
+    }
+
+    //array
+    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='[')){
+
+        return parse_array(item,input_buffer);
+    }
+    
+    //object
+    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='{')){
+        return parse_object(item,input_buffer);
+    }
+
+    return false;
+}
+
+/* Parallel printing: the children of a container with at least
+ * CJSON_PARALLEL_MIN_CHILDREN items are split into chunks of consecutive items.
+ * Each chunk is printed into its own buffer with the depth of the container,
+ * then the buffers are appended in order,so the output is the same as a serial
+ * print. Smaller containers are printed by the thread that reaches them,which
+ * still splits larger containers below them,inside a chunk as well. */
+#ifndef CJSON_PARALLEL_MIN_CHILDREN
+#define CJSON_PARALLEL_MIN_CHILDREN 1024
+#endif
+
+typedef cJSON_bool (*print_children_fn)(const cJSON*const first,const cJSON*const stop,printbuffer*const output_buffer);
+
+#if defined(CJSON_PARALLEL)
+typedef void (*parallel_task)(void*argument);
+
+/* The threads of parallel_run are started once and kept. A call that wants
+ * helpers is listed in the pool and idle workers join the newest one. The thread
+ * that made the call runs the task as well and then waits only for the workers
+ * that joined,so a task can make calls of its own,as a chunk with a large
+ * container in it does,without tying up the pool. */
+#ifndef CJSON_PARALLEL_MAX_THREADS
+#define CJSON_PARALLEL_MAX_THREADS 64
+#endif
+
+#if defined(_WIN32)
+typedef SRWLOCK parallel_lock;
+typedef CONDITION_VARIABLE parallel_condition;
+#define PARALLEL_LOCK_INIT SRWLOCK_INIT
+#define PARALLEL_CONDITION_INIT CONDITION_VARIABLE_INIT
+#define parallel_lock_acquire(lock) AcquireSRWLockExclusive(lock)
+#define parallel_lock_release(lock) ReleaseSRWLockExclusive(lock)
+#define parallel_wait(condition,lock) SleepConditionVariableSRW((condition),(lock),INFINITE,0)
+#define parallel_wake_all(condition) WakeAllConditionVariable(condition)
+#else
+typedef pthread_mutex_t parallel_lock;
+typedef pthread_cond_t parallel_condition;
+#define PARALLEL_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define PARALLEL_CONDITION_INIT PTHREAD_COND_INITIALIZER
+#define parallel_lock_acquire(lock) pthread_mutex_lock(lock)
+#define parallel_lock_release(lock) pthread_mutex_unlock(lock)
+#define parallel_wait(condition,lock) pthread_cond_wait((condition),(lock))
+#define parallel_wake_all(condition) pthread_cond_broadcast(condition)
+#endif
+
+typedef struct parallel_call{
+    parallel_task task;
+    void *argument;
+    size_t wanted;//helpers that may still join
+    size_t active;//helpers running the task
+    struct parallel_call *next;//the call listed before
+#if defined(CJSON_PROFILE)
+    cJSON_Profile profile;//what the helpers counted,added to the caller's counters
+#endif
+}parallel_call;
+
+static struct{
+    parallel_lock lock;
+    parallel_condition work;//a call was listed
+    parallel_condition done;//a helper finished
+    parallel_call *calls;//calls that want helpers,newest first
+    size_t workers;
+}parallel_pool={PARALLEL_LOCK_INIT,PARALLEL_CONDITION_INIT,PARALLEL_CONDITION_INIT,NULL,0};
+
+static void parallel_unlist(const parallel_call*const call){
+    parallel_call **link=&parallel_pool.calls;
+
+    while(*link!=NULL){
+        if(*link==call){
+            *link=call->next;
+            return;
+        }
+        link=&(*link)->next;
+    }
+}
+
+static void parallel_work(void){
+    parallel_call *call=NULL;
+
+    parallel_lock_acquire(&parallel_pool.lock);
+    for(;;){
+        while(parallel_pool.calls==NULL){
+            parallel_wait(&parallel_pool.work,&parallel_pool.lock);
+        }
+        call=parallel_pool.calls;
+        call->active++;
+        call->wanted--;
+        if(call->wanted==0){
+            parallel_pool.calls=call->next;
+        }
+        parallel_lock_release(&parallel_pool.lock);
+
+#if defined(CJSON_PROFILE)
+        memset(&thread_profile,0,sizeof(cJSON_Profile));
+#endif
+        call->task(call->argument);
+        //release the worker's pool at once,the thread may idle for long
+        cJSON_PoolReleaseThread();
+
+        parallel_lock_acquire(&parallel_pool.lock);
+#if defined(CJSON_PROFILE)
+        profile_merge(&call->profile,&thread_profile);
+#endif
+        //the caller may return as soon as this is 0,call is not touched after
+        call->active--;
+        if(call->active==0){
+            parallel_wake_all(&parallel_pool.done);
+        }
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI parallel_thread_main(LPVOID argument){
+    (void)argument;
+    parallel_work();
+    return 0;
+}
+#else
+static void *parallel_thread_main(void*argument){
+    (void)argument;
+    parallel_work();
+    return NULL;
+}
+#endif
+
+static cJSON_bool parallel_start_worker(void){
+#if defined(_WIN32)
+    const HANDLE thread=CreateThread(NULL,0,parallel_thread_main,NULL,0,NULL);
+    if(thread==NULL){
+        return false;
+    }
+    CloseHandle(thread);
+#else
+    pthread_t thread;
+    if(pthread_create(&thread,NULL,parallel_thread_main,NULL)!=0){
+        return false;
+    }
+    pthread_detach(thread);
+#endif
+
+    return true;
+}
+
+/* Run task on up to threads threads,the calling thread included,and wait for
+ * all of them. Tasks share their work through argument,so fewer threads than
+ * asked for (if the pool cannot grow or its workers are busy) only make it
+ * slower. */
+static void parallel_run(const parallel_task task,void*const argument,const size_t threads){
+    parallel_call call;
+
+    if(threads<=1){
+        task(argument);
+        return;
+    }
+
+    memset(&call,0,sizeof(call));
+    call.task=task;
+    call.argument=argument;
+    call.wanted=cjson_min(threads,CJSON_PARALLEL_MAX_THREADS)-1;
+
+    parallel_lock_acquire(&parallel_pool.lock);
+    while((parallel_pool.workers<call.wanted)&&parallel_start_worker()){
+        parallel_pool.workers++;
+    }
+    if(parallel_pool.workers>0){
+        call.next=parallel_pool.calls;
+        parallel_pool.calls=&call;
+        parallel_wake_all(&parallel_pool.work);
+    }else{
+        call.wanted=0;
+    }
+    parallel_lock_release(&parallel_pool.lock);
+
+    task(argument);
+
+    parallel_lock_acquire(&parallel_pool.lock);
+    //the work is handed out by now,no one else needs to join
+    if(call.wanted>0){
+        parallel_unlist(&call);
+    }
+    while(call.active>0){
+        parallel_wait(&parallel_pool.done,&parallel_pool.lock);
+    }
+    parallel_lock_release(&parallel_pool.lock);
+#if defined(CJSON_PROFILE)
+    profile_merge(&thread_profile,&call.profile);
+#endif
+}
+
+typedef struct{
+    const cJSON **starts;//chunk i is starts[i] up to starts[i+1]
+    printbuffer *outputs;
+    size_t chunk_count;
+    size_t next_chunk;
+    size_t failed;
+    print_children_fn print_range;
+}print_job;
+
+static void print_chunks(void*argument){
+    print_job *const job=(print_job*)argument;
+
+    for(;;){
+        const size_t index=atomic_add_size(&job->next_chunk,1)-1;
+        printbuffer *output=NULL;
+
+        if(index>=job->chunk_count){
+            return;
+        }
+        output=&job->outputs[index];
+        output->buffer=(unsigned char*)output->hooks.allocate(output->length);
+        if((output->buffer==NULL)||!job->print_range(job->starts[index],job->starts[index+1],output)){
+            atomic_store_size(&job->failed,1);
+        }
+    }
+}
+
+static cJSON_bool print_children_parallel(const cJSON*const item,printbuffer*const output_buffer,const print_children_fn print_range){
+    print_job job;
+    const cJSON *child=NULL;
+    unsigned char *output_pointer=NULL;
+    size_t count=0;
+    size_t index=0;
+    cJSON_bool success=false;
+
+    for(child=item->child;child!=NULL;child=child->next){
+        count++;
+    }
+    if(count<CJSON_PARALLEL_MIN_CHILDREN){
+        return print_range(item->child,NULL,output_buffer);
+    }
+
+    memset(&job,0,sizeof(job));
+    job.print_range=print_range;
+    //a few chunks per thread even out children of different sizes
+    job.chunk_count=cjson_min(count,output_buffer->threads*4);
+    job.starts=(const cJSON**)global_hooks.allocate((job.chunk_count+1)*sizeof(const cJSON*));
+    job.outputs=(printbuffer*)global_hooks.allocate(job.chunk_count*sizeof(printbuffer));
+    if((job.starts==NULL)||(job.outputs==NULL)){
+        goto cleanup;
+    }
+
+    child=item->child;
+    for(index=0;index<job.chunk_count;index++){
+        size_t skip=count/job.chunk_count+((index<count%job.chunk_count)?1:0);
+        job.starts[index]=child;
+        while(skip>0){
+            child=child->next;
+            skip--;
+        }
+
+        memset(&job.outputs[index],0,sizeof(printbuffer));
+        job.outputs[index].length=256;
+        job.outputs[index].depth=output_buffer->depth;
+        job.outputs[index].format=output_buffer->format;
+        job.outputs[index].hooks=output_buffer->hooks;
+        //large containers inside the chunk are split in turn
+        job.outputs[index].threads=output_buffer->threads;
+    }
+    job.starts[job.chunk_count]=NULL;
+
+    parallel_run(print_chunks,&job,output_buffer->threads);
+    if(job.failed){
+        goto cleanup;
+    }
+
+    for(index=0;index<job.chunk_count;index++){
+        const size_t length=job.outputs[index].offset;
+        output_pointer=ensure(output_buffer,length);
+        if(output_pointer==NULL){
+            goto cleanup;
+        }
+        memcpy(output_pointer,job.outputs[index].buffer,length);
+        output_pointer[length]='\0';
+        output_buffer->offset+=length;
+    }
+    success=true;
+
+cleanup:
+    if(job.outputs!=NULL){
+        for(index=0;index<job.chunk_count;index++){
+            if(job.outputs[index].buffer!=NULL){
+                job.outputs[index].hooks.deallcoate(job.outputs[index].buffer);
+            }
+        }
+        global_hooks.deallcoate(job.outputs);
+    }
+    if(job.starts!=NULL){
+        global_hooks.deallcoate((void*)job.starts);
+    }
+
+    return success;
+}
+#endif
+
+static cJSON_bool print_children(const cJSON*const item,printbuffer*const output_buffer,const print_children_fn print_range){
+#if defined(CJSON_PARALLEL)
+    if(output_buffer->threads>1){
+        return print_children_parallel(item,output_buffer,print_range);
+    }
+#endif
+
+    return print_range(item->child,NULL,output_buffer);
+}
+
+/* Parallel parsing in two stages. Stage one indexes the brackets and commas
+ * outside strings over chunks of the input on all threads: a first pass counts
+ * the unescaped quotes of every chunk,their running parity tells whether the
+ * next chunk starts inside a string,and a second pass records the structural
+ * bytes with that state. Stage two is the regular parser,except that a large
+ * array or object found in the index has its children split at commas of its
+ * own level into ranges,which are parsed on separate threads and then linked. */
+#ifndef CJSON_PARALLEL_MIN_LENGTH
+#define CJSON_PARALLEL_MIN_LENGTH (1<<20)
+#endif
+
+typedef struct{
+    size_t open;//offset of the '[' or '{'
+    size_t close;//offset of the matching ']' or '}'
+    size_t children;
+    size_t chunk;//the '[' or '{' in the index
+    size_t index;
+}large_container;
+
+struct structural_index
+{
+    const unsigned char *content;
+    size_t length;
+    size_t chunk_size;
+    size_t chunk_count;
+    uint32_t **positions;//per chunk,offsets from the start of the chunk
+    size_t *counts;
+    unsigned char *starts_in_string;
+    large_container *large;//sorted by open
+    size_t large_count;
+    size_t threads;
+    size_t next_chunk;
+    size_t failed;
+};
+
+#if defined(CJSON_PARALLEL)
+//1 if the chunk starts with a byte escaped by the backslashes in front of it
+static uint64_t chunk_escaped_carry(const structural_index*const index,const size_t start){
+    size_t backslashes=0;
+
+    while((backslashes<start)&&(index->content[start-backslashes-1]=='\\')){
+        backslashes++;
+    }
+
+    return (uint64_t)(backslashes&1);
+}
+
+//the 64 bytes at position,padded with spaces at the end of the input
+static const unsigned char *index_block(const structural_index*const index,const size_t position,unsigned char*const padded){
+    if(index->length-position>=BLOCK_SIZE){
+        return index->content+position;
+    }
+    memset(padded,' ',BLOCK_SIZE);
+    memcpy(padded,index->content+position,index->length-position);
+
+    return padded;
+}
+
+static void index_count_quotes(void*argument){
+    structural_index *const index=(structural_index*)argument;
+    unsigned char padded[BLOCK_SIZE];
+
+    for(;;){
+        const size_t chunk=atomic_add_size(&index->next_chunk,1)-1;
+        size_t position=0;
+        size_t end=0;
+        uint64_t parity=0;
+        block_state state={0,0};
+
+        if(chunk>=index->chunk_count){
+            return;
+        }
+        position=chunk*index->chunk_size;
+        end=cjson_min(position+index->chunk_size,index->length);
+        state.escaped_carry=chunk_escaped_carry(index,position);
+        for(;position<end;position+=BLOCK_SIZE){
+            block_masks masks;
+            classify_block(index_block(index,position,padded),&masks);
+            parity^=population_count(masks.quote&~escaped_mask(masks.backslash,&state))&1;
+        }
+        index->starts_in_string[chunk]=(unsigned char)parity;
+    }
+}
+
+static void index_structurals(void*argument){
+    structural_index *const index=(structural_index*)argument;
+    unsigned char padded[BLOCK_SIZE];
+
+    for(;;){
+        const size_t chunk=atomic_add_size(&index->next_chunk,1)-1;
+        size_t start=0;
+        size_t position=0;
+        size_t end=0;
+        size_t capacity=0;
+        block_state state={0,0};
+
+        if(chunk>=index->chunk_count){
+            return;
+        }
+        start=chunk*index->chunk_size;
+        end=cjson_min(start+index->chunk_size,index->length);
+        state.escaped_carry=chunk_escaped_carry(index,start);
+        state.in_string_carry=index->starts_in_string[chunk]?~(uint64_t)0:0;
+        for(position=start;position<end;position+=BLOCK_SIZE){
+            const unsigned char *const block=index_block(index,position,padded);
+            block_masks masks;
+            uint64_t structural=0;
+
+            classify_block(block,&masks);
+            structural=(equal_mask(block,'[')|equal_mask(block,'{')|equal_mask(block,']')|equal_mask(block,'}')|equal_mask(block,','))&~string_mask(&masks,&state);
+            if(index->counts[chunk]+population_count(structural)>capacity){
+                uint32_t *grown=NULL;
+                capacity=(capacity==0)?4096:capacity*2;
+                capacity=cjson_min(capacity,index->chunk_size);
+                if(global_hooks.realloccate!=NULL){
+                    grown=(uint32_t*)global_hooks.realloccate(index->positions[chunk],capacity*sizeof(uint32_t));
+                }else{
+                    grown=(uint32_t*)global_hooks.allocate(capacity*sizeof(uint32_t));
+                    if((grown!=NULL)&&(index->positions[chunk]!=NULL)){
+                        memcpy(grown,index->positions[chunk],index->counts[chunk]*sizeof(uint32_t));
+                        global_hooks.deallcoate(index->positions[chunk]);
+                    }
+                }
+                if(grown==NULL){
+                    atomic_store_size(&index->failed,1);
+                    return;
+                }
+                index->positions[chunk]=grown;
+            }
+            while(structural!=0){
+                index->positions[chunk][index->counts[chunk]++]=(uint32_t)(position-start+trailing_zeroes(structural));
+                structural&=structural-1;
+            }
+        }
+    }
+}
+
+static int compare_large_containers(const void*a,const void*b){
+    const size_t first=((const large_container*)a)->open;
+    const size_t second=((const large_container*)b)->open;
+
+    return (first<second)?-1:((first>second)?1:0);
+}
+
+//match the brackets of the index and keep the containers with many children
+static cJSON_bool index_find_large_containers(structural_index*const index){
+    large_container *stack=NULL;
+    size_t depth=0;
+    size_t capacity=0;
+    size_t chunk=0;
+    size_t position=0;
+
+    stack=(large_container*)global_hooks.allocate(CJSON_NESTING_LIMIT*sizeof(large_container));
+    if(stack==NULL){
+        return false;
+    }
+
+    for(chunk=0;chunk<index->chunk_count;chunk++){
+        for(position=0;position<index->counts[chunk];position++){
+            const size_t offset=chunk*index->chunk_size+index->positions[chunk][position];
+            const unsigned char c=index->content[offset];
+
+            if((c=='[')||(c=='{')){
+                if(depth<CJSON_NESTING_LIMIT){
+                    stack[depth].open=offset;
+                    stack[depth].children=1;
+                    stack[depth].chunk=chunk;
+                    stack[depth].index=position;
+                }
+                depth++;
+            }else if(c==','){
+                if((depth>0)&&(depth<=CJSON_NESTING_LIMIT)){
+                    stack[depth-1].children++;
+                }
+            }else if(depth>0){
+                depth--;
+                if((depth<CJSON_NESTING_LIMIT)&&(stack[depth].children>=CJSON_PARALLEL_MIN_CHILDREN)){
+                    if(index->large_count==capacity){
+                        large_container *grown=NULL;
+                        capacity=(capacity==0)?16:capacity*2;
+                        grown=(large_container*)global_hooks.allocate(capacity*sizeof(large_container));
+                        if(grown==NULL){
+                            global_hooks.deallcoate(stack);
+                            return false;
+                        }
+                        if(index->large!=NULL){
+                            memcpy(grown,index->large,index->large_count*sizeof(large_container));
+                            global_hooks.deallcoate(index->large);
+                        }
+                        index->large=grown;
+                    }
+                    stack[depth].close=offset;
+                    index->large[index->large_count++]=stack[depth];
+                }
+            }
+        }
+    }
+    global_hooks.deallcoate(stack);
+
+    //containers were added as they closed,inner ones first
+    if(index->large_count>1){
+        qsort(index->large,index->large_count,sizeof(large_container),compare_large_containers);
+    }
+
+    return true;
+}
+
+static void delete_structural_index(structural_index*const index){
+    size_t chunk=0;
+
+    if(index->positions!=NULL){
+        for(chunk=0;chunk<index->chunk_count;chunk++){
+            if(index->positions[chunk]!=NULL){
+                global_hooks.deallcoate(index->positions[chunk]);
+            }
+        }
+        global_hooks.deallcoate(index->positions);
+    }
+    if(index->counts!=NULL){
+        global_hooks.deallcoate(index->counts);
+    }
+    if(index->starts_in_string!=NULL){
+        global_hooks.deallcoate(index->starts_in_string);
+    }
+    if(index->large!=NULL){
+        global_hooks.deallcoate(index->large);
+    }
+}
+
+static cJSON_bool build_structural_index(structural_index*const index,const unsigned char*const content,const size_t length,const size_t threads){
+    size_t chunk=0;
+    unsigned char in_string=0;
+
+    memset(index,0,sizeof(structural_index));
+    index->content=content;
+    index->length=length;
+    index->threads=threads;
+    //a few chunks per thread,a multiple of the block size and small enough for 32 bit offsets
+    index->chunk_size=length/(threads*4)+BLOCK_SIZE;
+    index->chunk_size=cjson_min(index->chunk_size-index->chunk_size%BLOCK_SIZE,(size_t)1<<30);
+    index->chunk_count=(length+index->chunk_size-1)/index->chunk_size;
+
+    index->positions=(uint32_t**)global_hooks.allocate(index->chunk_count*sizeof(uint32_t*));
+    index->counts=(size_t*)global_hooks.allocate(index->chunk_count*sizeof(size_t));
+    index->starts_in_string=(unsigned char*)global_hooks.allocate(index->chunk_count);
+    if((index->positions==NULL)||(index->counts==NULL)||(index->starts_in_string==NULL)){
+        goto fail;
+    }
+    memset(index->positions,0,index->chunk_count*sizeof(uint32_t*));
+    memset(index->counts,0,index->chunk_count*sizeof(size_t));
+
+    parallel_run(index_count_quotes,index,threads);
+    //turn the quote parity of every chunk into the string state at its start
+    for(chunk=0;chunk<index->chunk_count;chunk++){
+        const unsigned char parity=index->starts_in_string[chunk];
+        index->starts_in_string[chunk]=in_string;
+        in_string^=parity;
+    }
+
+    index->next_chunk=0;
+    parallel_run(index_structurals,index,threads);
+    if(index->failed||!index_find_large_containers(index)){
+        goto fail;
+    }
+
+    return true;
+
+fail:
+    delete_structural_index(index);
+
+    return false;
+}
+
+typedef struct{
+    const parse_buffer *input;
+    size_t *bounds;//range i is between the separators at bounds[i] and bounds[i+1]
+    cJSON **heads;
+    cJSON **tails;
+    size_t *error_offsets;//SIZE_MAX if the range parsed
+    size_t range_count;
+    size_t next_range;
+    cJSON_bool object;
+}parse_job;
+
+//parse the comma separated children of one range,which have to end at its separator
+static cJSON_bool parse_range(parse_job*const job,const size_t range){
+    parse_buffer buffer=*job->input;
+    cJSON *current_item=NULL;
+
+    //the separator after the range is kept,so the parser sees what it would see serially
+    buffer.offset=job->bounds[range];
+    buffer.length=job->bounds[range+1]+1;
+    buffer.parallel=NULL;
+
+    for(;;){
+        cJSON *new_item=cJSON_NEW_Item(&buffer.hooks);
+        if(new_item==NULL){
+            goto fail;
+        }
+        if(current_item==NULL){
+            job->heads[range]=new_item;
+        }else{
+            current_item->next=new_item;
+            new_item->prev=current_item;
+        }
+        current_item=new_item;
+
+        //skip the separator in front of the child
+        buffer.offset++;
+        buffer_skip_whitespace(&buffer);
+        if(job->object){
+            if(cannot_access_at_index(&buffer,0)||!parse_string(current_item,&buffer)){
+                goto fail;
+            }
+            buffer_skip_whitespace(&buffer);
+            current_item->string=current_item->valuestring;
+            current_item->valuestring=NULL;
+            if(cannot_access_at_index(&buffer,0)||(buffer_at_offset(&buffer)[0]!=':')){
+                goto fail;
+            }
+            buffer.offset++;
+            buffer_skip_whitespace(&buffer);
+        }
+        if(!parse_value(current_item,&buffer)){
+            goto fail;
+        }
+        buffer_skip_whitespace(&buffer);
+
+        if(buffer.offset==job->bounds[range+1]){
+            break;
+        }
+        if(buffer_at_offset(&buffer)[0]!=','){
+            goto fail;
+        }
+    }
+    job->tails[range]=current_item;
+
+    return true;
+
+fail:
+    job->error_offsets[range]=buffer.offset;
+    cJSON_Delete(job->heads[range]);
+    job->heads[range]=NULL;
+
+    return false;
+}
+
+static void parse_ranges(void*argument){
+    parse_job *const job=(parse_job*)argument;
+
+    for(;;){
+        const size_t range=atomic_add_size(&job->next_range,1)-1;
+
+        if(range>=job->range_count){
+            return;
+        }
+        parse_range(job,range);
+    }
+}
+
+static const large_container *find_large_container(const structural_index*const index,const size_t open){
+    size_t low=0;
+    size_t high=index->large_count;
+
+    while(low<high){
+        const size_t middle=low+(high-low)/2;
+        if(index->large[middle].open<open){
+            low=middle+1;
+        }else{
+            high=middle;
+        }
+    }
+
+    return ((low<index->large_count)&&(index->large[low].open==open))?&index->large[low]:NULL;
+}
+
+//find the separators that split the children of container into range_count ranges
+static cJSON_bool split_children(const structural_index*const index,const large_container*const container,size_t*const bounds,const size_t range_count){
+    size_t chunk=container->chunk;
+    size_t position=container->index+1;
+    size_t depth=0;
+    size_t commas=0;
+    size_t range=1;
+
+    bounds[0]=container->open;
+    for(;chunk<index->chunk_count;chunk++,position=0){
+        for(;position<index->counts[chunk];position++){
+            const size_t offset=chunk*index->chunk_size+index->positions[chunk][position];
+            const unsigned char c=index->content[offset];
+
+            if(offset==container->close){
+                bounds[range_count]=offset;
+                return range==range_count;
+            }
+            if((c=='[')||(c=='{')){
+                depth++;
+            }else if((c==']')||(c=='}')){
+                depth--;
+            }else if((depth==0)&&(range<range_count)){
+                commas++;
+                if(commas==range*container->children/range_count){
+                    bounds[range++]=offset;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+#endif
+
+/* Parse the children of a large array or object on several threads. parsed is
+ * false if the container is not one of them,then the caller parses it. */
+static cJSON_bool parse_large_container(parse_buffer*const input_buffer,const size_t open,const cJSON_bool object,cJSON**const head,cJSON**const tail,cJSON_bool*const parsed){
+#if defined(CJSON_PARALLEL)
+    const large_container *const container=find_large_container(input_buffer->parallel,open);
+    parse_job job;
+    size_t range=0;
+    size_t error_offset=SIZE_MAX;
+    cJSON_bool success=false;
+
+    *parsed=false;
+    if(container==NULL){
+        return true;
+    }
+
+    memset(&job,0,sizeof(job));
+    job.input=input_buffer;
+    job.object=object;
+    job.range_count=cjson_min(container->children,input_buffer->parallel->threads*4);
+    job.bounds=(size_t*)global_hooks.allocate((job.range_count+1)*sizeof(size_t));
+    job.heads=(cJSON**)global_hooks.allocate(job.range_count*sizeof(cJSON*));
+    job.tails=(cJSON**)global_hooks.allocate(job.range_count*sizeof(cJSON*));
+    job.error_offsets=(size_t*)global_hooks.allocate(job.range_count*sizeof(size_t));
+    //without memory for the ranges,or if the index doesn't match the grammar,the caller parses serially
+    success=true;
+    if((job.bounds==NULL)||(job.heads==NULL)||(job.tails==NULL)||(job.error_offsets==NULL)){
+        goto cleanup;
+    }
+    if(!split_children(input_buffer->parallel,container,job.bounds,job.range_count)){
+        goto cleanup;
+    }
+    success=false;
+    for(range=0;range<job.range_count;range++){
+        job.heads[range]=NULL;
+        job.tails[range]=NULL;
+        job.error_offsets[range]=SIZE_MAX;
+    }
+
+    parallel_run(parse_ranges,&job,input_buffer->parallel->threads);
+
+    for(range=0;range<job.range_count;range++){
+        if(job.error_offsets[range]!=SIZE_MAX){
+            //the first error in the input,as the serial parser would report it
+            error_offset=job.error_offsets[range];
+            break;
+        }
+    }
+    if(error_offset!=SIZE_MAX){
+        input_buffer->offset=error_offset;
+        for(range=0;range<job.range_count;range++){
+            cJSON_Delete(job.heads[range]);
+        }
+        goto cleanup;
+    }
+
+    for(range=0;range+1<job.range_count;range++){
+        job.tails[range]->next=job.heads[range+1];
+        job.heads[range+1]->prev=job.tails[range];
+    }
+    *head=job.heads[0];
+    *tail=job.tails[job.range_count-1];
+    input_buffer->offset=container->close;
+    *parsed=true;
+    success=true;
+
+cleanup:
+    if(job.bounds!=NULL){
+        global_hooks.deallcoate(job.bounds);
+    }
+    if(job.heads!=NULL){
+        global_hooks.deallcoate(job.heads);
+    }
+    if(job.tails!=NULL){
+        global_hooks.deallcoate(job.tails);
+    }
+    if(job.error_offsets!=NULL){
+        global_hooks.deallcoate(job.error_offsets);
+    }
+
+    return success;
+#else
+    (void)input_buffer;
+    (void)open;
+    (void)object;
+    (void)head;
+    (void)tail;
+    *parsed=false;
+
+    return true;
+#endif
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_ParseParallel(const char*value,size_t length,const char**return_parse_end,int flags,int threads){
+#if defined(CJSON_PARALLEL)
+    structural_index index;
+    cJSON *item=NULL;
+
+    if((value!=NULL)&&(threads>1)&&(length>=CJSON_PARALLEL_MIN_LENGTH)&&build_structural_index(&index,(const unsigned char*)value,length,(size_t)threads)){
+        item=parse(value,length,return_parse_end,flags,(index.large_count>0)?&index:NULL);
+        delete_structural_index(&index);
+        return item;
+    }
+#else
+    (void)threads;
+#endif
+
+    return parse(value,length,return_parse_end,flags,NULL);
+}
+
+//Render a value to text
+
+static cJSON_bool print_value(const cJSON* const item ,printbuffer *const output_buffer){
+    unsigned char *output=NULL;
+
+    if((item==NULL)||(output_buffer==NULL)){
+        return false;
+    }
+
+    switch ((item->type)&0xFF)
+    {
+    case cJSON_NULL:
+        output=ensure(output_buffer,5);
+        if(output==NULL){
+            return false;
+        }
+        strcpy((char*)output,"null");
+        return true;
+    case cJSON_False:
+        output=ensure(output_buffer,6);
+        if(output==NULL){
+            return false;
+        }
+        strcpy((char*)output,"false");
+        return true;
+    case cJSON_True:
+        output=ensure(output_buffer,5);
+        if(output==NULL){
+            return false;
+        }
+        strcpy((char *)output,"true");
+        return true;
+    case cJSON_Number:
+        return print_number(item,output_buffer);
+    case cJSON_Raw:
+        size_t raw_lenght=0;
+        if(item->valuestring==NULL)
+        {
+            return false;
+        }
+        raw_lenght=strlen(item->valuestring)+sizeof("");
+        output=ensure(output_buffer,raw_lenght);
+        if(output==NULL){
+            return false;
+        }
+        memcpy(output,item->valuestring,raw_lenght);
+        return true;
+    case cJSON_String:
+        return print_string(item,output_buffer);
+    case cJSON_Array:
+        return print_array(item,output_buffer);
+    case cJSON_Object:
+        return print_object(item,output_buffer);
+    default:
+        return false;
+    }
+}
+
+//build an array from input text.item may be NULL to only validate the input
+static cJSON_bool parse_array(cJSON*const item,parse_buffer*const input_buffer){
+    cJSON*head=NULL;//head of the linked list
+    cJSON*current_item=NULL;
+    size_t open=0;
+
+    if(input_buffer->depth>=CJSON_NESTING_LIMIT){
+        return false;//to deeply nested
+    }
+    input_buffer->depth++;
+
+    if(buffer_at_offset(input_buffer)[0]!='['){
+        //not an array
+        goto fail;
+    }
+
+    open=input_buffer->offset;
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]==']')){
+        //empty array
+        goto success;
+    }
+
+    //check if we skipped to the end of the buffer
+    if(cannot_access_at_index(input_buffer,0)){
+        input_buffer->offset--;
+        goto fail;
+    }
+
+    if((item!=NULL)&&(input_buffer->parallel!=NULL)){
+        cJSON_bool parsed=false;
+        if(!parse_large_container(input_buffer,open,false,&head,&current_item,&parsed)){
+            goto fail;
+        }
+        if(parsed){
+            goto children_parsed;
+        }
+    }
+
+    //step back to character in front of the first element
+    input_buffer->offset--;
+    //loop through the comma separated array elements
+    do
+    {
+        if(item!=NULL){
+            //allocate next item
+            cJSON*new_item=parse_new_item(input_buffer);
+            if(new_item==NULL){
+                goto fail;
+            }
+
+            //attach next item to list
+            if(head==NULL){
+                //start the linked list
+                current_item=head=new_item;
+            }
+            else{
+                //add to the end and advance
+                current_item->next=new_item;
+                new_item->prev=current_item;
+                current_item=new_item;
+            }
+        }
+
+        //parse next value
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if(!parse_value(current_item,input_buffer)){
+            goto fail;
+        }
+        buffer_skip_whitespace(input_buffer);
+    }
+    while(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]==','));
+
+children_parsed:
+    if(cannot_access_at_index(input_buffer,0)||buffer_at_offset(input_buffer)[0]!=']'){
+        //expected end of array
+        goto fail;
+    }
+
+success:
+    input_buffer->depth--;
+
+    if(item!=NULL){
+        if(head!=NULL){
+            //the first item's prev points to the last,so appends are O(1)
+            head->prev=current_item;
+        }
+        item->type=cJSON_Array;
+        item->child=head;
+    }
+
+    input_buffer->offset++;
+
+    return true;
+
+fail:
+    if(head!=NULL){
+        parse_delete(input_buffer,head);
+    }
+
+    return false;
+}
+
+//Render an array to text
+//print the elements from first up to stop with their separators
+static cJSON_bool print_elements(const cJSON*const first,const cJSON*const stop,printbuffer*const output_buffer){
+    unsigned char *output_pointer=NULL;
+    size_t length=0;
+    const cJSON *current_element=first;
+
+    while(current_element!=stop){
+        if(!print_value(current_element,output_buffer)){
+            return false;
+        }
+        update_offset(output_buffer);
+        if(current_element->next){
+            length=(size_t)(output_buffer->format?2:1);
+            output_pointer=ensure(output_buffer,length+1);
+            if(output_pointer==NULL){
+                return false;
+            }
+            *output_pointer++=',';
+            if(output_buffer->format){
+                *output_pointer++=' ';
+            }
+            *output_pointer='\0';
+            output_buffer->offset+=length;
+        }
+        current_element=current_element->next;
+    }
+
+    return true;
+}
+
+static cJSON_bool print_array(const cJSON*const item,printbuffer*const output_buffer){
+    unsigned char *output_pointer=NULL;
+
+    if(output_buffer==NULL){
+        return false;
+    }
+
+    //opening square bracket
+    output_pointer=ensure(output_buffer,1);
+    if(output_pointer==NULL){
+        return false;
+    }
+
+    *output_pointer='[';
+    output_buffer->offset++;
+    output_buffer->depth++;
+
+    if(!print_children(item,output_buffer,print_elements)){
+        return false;
+    }
+
+    output_pointer=ensure(output_buffer,2);
+    if(output_pointer==NULL){
+        return false;
+    }
+    *output_pointer++=']';
+    *output_pointer='\0';
+    output_buffer->depth--;
+
+    return true;
+}
+
+//build an object from the text.item may be NULL to only validate the input
+static cJSON_bool parse_object(cJSON*const item,parse_buffer*const input_buffer){
+    cJSON*head=NULL;//linked list head
+    cJSON*current_item=NULL;
+    size_t open=0;
+    size_t key_mark=0;//where a parser carves the next name from
+    cJSON_Shape *shape=NULL;//of the members so far,NULL without one
+
+    if(input_buffer->depth>=CJSON_NESTING_LIMIT){
+        return false;//to deeply nested
+    }
+    input_buffer->depth++;
+
+    if(cannot_access_at_index(input_buffer,0)||(buffer_at_offset(input_buffer)[0]!='{')){
+        //not an object
+        goto fail;
+    }
+
+    open=input_buffer->offset;
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='}')){
+        //empty object
+        goto success;
+    }
+
+    //check if we skipped to the end of the buffer
+    if(cannot_access_at_index(input_buffer,0)){
+        input_buffer->offset--;
+        goto fail;
+    }
+
+    if((item!=NULL)&&(input_buffer->parallel!=NULL)){
+        cJSON_bool parsed=false;
+        if(!parse_large_container(input_buffer,open,true,&head,&current_item,&parsed)){
+            goto fail;
+        }
+        if(parsed){
+            goto children_parsed;
+        }
+    }
+
+    if((item!=NULL)&&(input_buffer->parser!=NULL)){
+        shape=&input_buffer->parser->empty_shape;
+    }
+
+    //step back to character in front of the first element
+    input_buffer->offset--;
+    //loop through the comma separated array elements
+    do
+    {
+        if(item!=NULL){
+            //allocate next item
+            cJSON*new_item=parse_new_item(input_buffer);
+            if(new_item==NULL){
+                goto fail;
+            }
+
+            //attach next item to list
+            if(head==NULL){
+                //start the linked list
+                current_item=head=new_item;
+            }
+            else{
+                //add to the end and advance
+                current_item->next=new_item;
+                new_item->prev=current_item;
+                current_item=new_item;
+            }
+        }
+
+        //parse the name of the child
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if(input_buffer->parser!=NULL){
+            key_mark=input_buffer->parser->used;
+        }
+        if(cannot_access_at_index(input_buffer,0)||!parse_string(current_item,input_buffer)){
+            //failed to parse name
+            goto fail;
+        }
+        buffer_skip_whitespace(input_buffer);
+
+        if(current_item!=NULL){
+            //swap valuestring and string,because we parsed the name
+            current_item->string=current_item->valuestring;
+            current_item->valuestring=NULL;
+            if(input_buffer->parser!=NULL){
+                char *const key=current_item->string;
+                current_item->string=parser_intern(input_buffer->parser,key,key_mark);
+                //a key that was not interned has no shape
+                if(shape!=NULL){
+                    shape=(current_item->string!=key)?parser_shape(input_buffer->parser,shape,current_item->string):NULL;
+                }
+            }
+        }
+
+        if(cannot_access_at_index(input_buffer,0)||(buffer_at_offset(input_buffer)[0]!=':')){
+            //invalid object
+            goto fail;
+        }
+
+        //parse the value
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if(!parse_value(current_item,input_buffer)){
+            //failed to parse value
+            goto fail;
+        }
+        buffer_skip_whitespace(input_buffer);
+    }
+    while(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]==','));
+
+children_parsed:
+    if(cannot_access_at_index(input_buffer,0)||(buffer_at_offset(input_buffer)[0]!='}')){
+        //expected end of object
+        goto fail;
+    }
+
+success:
+    input_buffer->depth--;
+
+    if(item!=NULL){
+        if(head!=NULL){
+            head->prev=current_item;
+        }
+        item->type=cJSON_Object;
+        item->child=head;
+
+        if((shape!=NULL)&&(shape->count>0)){
+            struct cJSON_Layout *const layout=(struct cJSON_Layout*)parse_allocate(input_buffer,sizeof(struct cJSON_Layout)+shape->count*sizeof(cJSON*));
+            if(layout!=NULL){
+                cJSON **members=(cJSON**)(layout+1);
+                for(current_item=head;current_item!=NULL;current_item=current_item->next){
+                    *members++=current_item;
+                }
+                layout->shape=shape;
+                item_parser_slot(item)->layout=layout;
+                item->type|=cJSON_HasShape;
+            }
+        }
+    }
+
+    input_buffer->offset++;
+    return true;
+
+fail:
+    if(head!=NULL){
+        parse_delete(input_buffer,head);
+    }
+
+    return false;
+}
+
+//Render an object to text
+//print the members from first up to stop with their separators
+static cJSON_bool print_members(const cJSON*const first,const cJSON*const stop,printbuffer*const output_buffer){
+    unsigned char *output_pointer=NULL;
+    size_t length=0;
+    const cJSON *current_item=first;
+
+    while(current_item!=stop){
+        if(output_buffer->format){
+            size_t i;
+            output_pointer=ensure(output_buffer,output_buffer->depth);
+            if(output_pointer==NULL){
+                return false;
+            }
+            for(i=0;i<output_buffer->depth;i++){
+                *output_pointer++='\t';
+            }
+            output_buffer->offset+=output_buffer->depth;
+        }
+
+        //print key
+        if(!print_string_ptr((unsigned char*)current_item->string,output_buffer)){
+            return false;
+        }
+        update_offset(output_buffer);
+
+        length=(size_t)(output_buffer->format?2:1);
+        output_pointer=ensure(output_buffer,length);
+        if(output_pointer==NULL){
+            return false;
+        }
+        *output_pointer++=':';
+        if(output_buffer->format){
+            *output_pointer++='\t';
+        }
+        output_buffer->offset+=length;
+
+        //print value
+        if(!print_value(current_item,output_buffer)){
+            return false;
+        }
+        update_offset(output_buffer);
+
+        //print comma if not last
+        length=((size_t)(output_buffer->format?1:0)+(size_t)(current_item->next?1:0));
+        output_pointer=ensure(output_buffer,length+1);
+        if(output_pointer==NULL){
+            return false;
+        }
+        if(current_item->next){
+            *output_pointer++=',';
+        }
+        if(output_buffer->format){
+            *output_pointer++='\n';
+        }
+        *output_pointer='\0';
+        output_buffer->offset+=length;
+
+        current_item=current_item->next;
+    }
+
+    return true;
+}
+
+static cJSON_bool print_object(const cJSON*const item,printbuffer*const output_buffer){
+    unsigned char *output_pointer=NULL;
+    size_t length=0;
+
+    if(output_buffer==NULL){
+        return false;
+    }
+
+    //compose the output,fmt: {\n
+    length=(size_t)(output_buffer->format?2:1);
+    output_pointer=ensure(output_buffer,length+1);
+    if(output_pointer==NULL){
+        return false;
+    }
+
+    *output_pointer++='{';
+    output_buffer->depth++;
+    if(output_buffer->format){
+        *output_pointer++='\n';
+    }
+    output_buffer->offset+=length;
+
+    if(!print_children(item,output_buffer,print_members)){
+        return false;
+    }
+
+    output_pointer=ensure(output_buffer,output_buffer->format?(output_buffer->depth+1):2);
+    if(output_pointer==NULL){
+        return false;
+    }
+    if(output_buffer->format){
+        size_t i;
+        for(i=0;i<(output_buffer->depth-1);i++){
+            *output_pointer++='\t';
+        }
+    }
+    *output_pointer++='}';
+    *output_pointer='\0';
+    output_buffer->depth--;
+
+    return true;
+}
+
+CJSON_PUBLIC(int)cJSON_GetArraySize(const cJSON*array){
+    cJSON *child=NULL;
+    size_t size=0;
+
+    if(array==NULL){
+        return 0;
+    }
+
+    child=array->child;
+
+    while(child!=NULL){
+        size++;
+        child=child->next;
+    }
+
+    return (int)size;
+}
+
+static cJSON *get_array_item(const cJSON*array,size_t index){
+    cJSON *current_child=NULL;
+
+    if(array==NULL){
+        return NULL;
+    }
+
+    current_child=array->child;
+    while((current_child!=NULL)&&(index>0)){
+        index--;
+        current_child=current_child->next;
+    }
+
+    return current_child;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_GetArrayItem(const cJSON*array,int index){
+    if(index<0){
+        return NULL;
+    }
+
+    return get_array_item(array,(size_t)index);
+}
+
+static cJSON *get_object_item(const cJSON*const object,const char*const name,const cJSON_bool case_sensitive){
+    cJSON *current_element=NULL;
+
+    if((object==NULL)||(name==NULL)){
+        return NULL;
+    }
+
+    current_element=object->child;
+    if(case_sensitive){
+        while((current_element!=NULL)&&(current_element->string!=NULL)&&(strcmp(name,current_element->string)!=0)){
+            current_element=current_element->next;
+        }
+    }
+    else{
+        while((current_element!=NULL)&&(case_insensitive_strcmp((const unsigned char*)name,(const unsigned char*)(current_element->string))!=0)){
+            current_element=current_element->next;
+        }
+    }
+
+    if((current_element==NULL)||(current_element->string==NULL)){
+        return NULL;
+    }
+
+    return current_element;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_getObjectItem(const cJSON*const object,const char*const string){
+    return get_object_item(object,string,false);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_getObjectItemCaseSensitive(const cJSON*const object,const char*const string){
+    return get_object_item(object,string,true);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_GetFieldItem(const cJSON*const object,cJSON_Field*const field){
+    const struct cJSON_Layout *layout=NULL;
+    cJSON *const *members=NULL;
+    size_t index=0;
+
+    if((object==NULL)||(field==NULL)||(field->key==NULL)||!cJSON_IsObject(object)){
+        return NULL;
+    }
+    if(!(object->type&cJSON_HasShape)){
+        return get_object_item(object,field->key,true);
+    }
+    //a const object,only its layout is read
+    layout=item_parser_slot((cJSON*)object)->layout;
+    members=layout_members(layout);
+    //a shape of a deleted parser may sit at the same address,but not with its generation
+    if((layout->shape==field->shape)&&(layout->shape->generation==field->generation)){
+        return (field->index<layout->shape->count)?members[field->index]:NULL;
+    }
+
+    //the first lookup in this shape,an absent key is cached as count
+    for(index=0;index<layout->shape->count;index++){
+        if(strcmp(members[index]->string,field->key)==0){
+            break;
+        }
+    }
+    field->shape=layout->shape;
+    field->generation=layout->shape->generation;
+    field->index=index;
+
+    return (index<layout->shape->count)?members[index]:NULL;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_HasObjectItem(const cJSON*object,const char*string){
+    return cJSON_getObjectItem(object,string)?1:0;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_ISInvalid(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_Invalid;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsFalse(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_False;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsTrue(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_True;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsBool(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&(cJSON_True|cJSON_False))!=0;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsNULL(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_NULL;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsNumber(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_Number;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsString(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_String;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsArray(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_Array;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsObject(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_Object;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsRaw(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return (item->type&0xFF)==cJSON_Raw;
+}
+
+/* Give a container its own copy of a shared child list. Only the list itself is
+ * copied,the copies share their children in turn,so a path of mutations costs
+ * O(depth*width) instead of O(tree). Nothing is written to the shared items. If
+ * translate points to an item of the old list,it is updated to the corresponding
+ * copy. */
+static cJSON_bool unshare_children(cJSON*const item,cJSON**const translate){
+    cJSON *shared=item->child;
+    cJSON *current_item=NULL;
+    cJSON *head=NULL;
+    cJSON *tail=NULL;
+    cJSON *copy=NULL;
+
+    if(shared==NULL){
+        return true;
+    }
+    if(!share_is_shared(shared)){
+        //the last owner takes back a list frozen by cJSON_DuplicateShared
+        if(share_is_frozen(shared)){
+            share_thaw(shared);
+        }
+        return true;
+    }
+
+    for(current_item=shared;current_item!=NULL;current_item=current_item->next){
+        copy=cJSON_NEW_Item(&global_hooks);
+        if(copy==NULL){
+            goto fail;
+        }
+        //link first,so a failure below frees the copy with the rest
+        if(tail==NULL){
+            head=copy;
+        }else{
+            tail->next=copy;
+            copy->prev=tail;
+        }
+        tail=copy;
+
+        copy->type=current_item->type&~cJSON_HasShape;
+        copy->valueint=current_item->valueint;
+        copy->valuedouble=current_item->valuedouble;
+        if(current_item->type&cJSON_IsReference){
+            copy->valuestring=current_item->valuestring;
+            copy->child=current_item->child;
+        }else{
+            if(current_item->valuestring!=NULL){
+                copy->valuestring=(char*)cJSON_strdup((const unsigned char*)current_item->valuestring,&global_hooks);
+                if(copy->valuestring==NULL){
+                    goto fail;
+                }
+            }
+            if(current_item->child!=NULL){
+                share_add_owner(current_item->child);
+            }
+            copy->child=current_item->child;
+        }
+        if(current_item->string!=NULL){
+            copy->string=(current_item->type&cJSON_StringIsConst)?current_item->string:(char*)cJSON_strdup((const unsigned char*)current_item->string,&global_hooks);
+            if(copy->string==NULL){
+                goto fail;
+            }
+        }
+
+        if((translate!=NULL)&&(*translate==current_item)){
+            *translate=copy;
+        }
+    }
+
+    head->prev=tail;
+    item->child=head;
+    //the other owners may have let go meanwhile
+    if(!share_drop_owner(shared)){
+        cJSON_Delete(shared);
+    }
+
+    return true;
+
+fail:
+    if((translate!=NULL)&&(head!=NULL)){
+        for(current_item=shared,copy=head;copy!=NULL;current_item=current_item->next,copy=copy->next){
+            if(*translate==copy){
+                *translate=current_item;
+            }
+        }
+    }
+    cJSON_Delete(head);
+
+    return false;
+}
+
+/* A container can own its children unless it is frozen itself or merely
+ * references the list of another container. */
+static cJSON_bool own_children(cJSON*const item,cJSON**const translate){
+    if((item==NULL)||share_is_frozen(item)){
+        return false;
+    }
+    //the caller is about to change the children
+    digest_forget();
+    if(item->type&cJSON_IsReference){
+        return (item->child==NULL)||(!share_is_shared(item->child)&&!share_is_frozen(item->child));
+    }
+
+    return unshare_children(item,translate);
+}
+
+static void suffix_object(cJSON*prev,cJSON*item){
+    prev->next=item;
+    item->prev=prev;
+}
+
+/* The first item's prev points to the last one. A list linked by hand may not
+ * keep that up,its tail is found by walking it once. */
+static cJSON *get_list_tail(cJSON*const child){
+    cJSON *tail=child;
+
+    if(child->prev!=NULL){
+        return child->prev;
+    }
+    while(tail->next!=NULL){
+        tail=tail->next;
+    }
+
+    return tail;
+}
+
+//Utility for array list handing
+static cJSON *create_reference(const cJSON*item,const internal_hooks*const hooks){
+    cJSON *reference=NULL;
+
+    if(item==NULL){
+        return NULL;
+    }
+
+    reference=cJSON_NEW_Item(hooks);
+    if(reference==NULL){
+        return NULL;
+    }
+
+    memcpy(reference,item,sizeof(cJSON));
+    reference->string=NULL;
+    reference->type|=cJSON_IsReference;
+    reference->type&=~cJSON_HasShape;
+    reference->shares=0;
+    reference->next=reference->prev=NULL;
+
+    return reference;
+}
+
+static cJSON_bool add_item_to_array(cJSON*array,cJSON*item){
+    cJSON *child=NULL;
+
+    if((item==NULL)||(array==NULL)||(item==array)||share_is_frozen(item)){
+        return false;
+    }
+    if(!own_children(array,NULL)){
+        return false;
+    }
+
+    child=array->child;
+
+    if(child==NULL){
+        //list is empty,start new one
+        array->child=item;
+        item->prev=item;
+        item->next=NULL;
+    }else{
+        //append after the tail,which the first item's prev points to
+        suffix_object(get_list_tail(child),item);
+        item->next=NULL;
+        child->prev=item;
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(void)cJSON_AddItemToArray(cJSON*array,cJSON*item){
+    add_item_to_array(array,item);
+}
+
+/* Attach a chain linked through next,which may have been built by hand. The
+ * chain is checked first,so nothing is attached if any item can't be. */
+static cJSON_bool add_chain_to_array(cJSON*const array,cJSON*const chain,const cJSON_bool named){
+    cJSON *current_item=NULL;
+    cJSON *tail=NULL;
+    cJSON *child=NULL;
+
+    if((array==NULL)||(chain==NULL)){
+        return false;
+    }
+    for(current_item=chain;current_item!=NULL;current_item=current_item->next){
+        if((current_item==array)||share_is_frozen(current_item)||(named&&(current_item->string==NULL))){
+            return false;
+        }
+        tail=current_item;
+    }
+    if(!own_children(array,NULL)){
+        return false;
+    }
+
+    //fix up prev,the chain may only be linked forwards
+    for(current_item=chain;current_item->next!=NULL;current_item=current_item->next){
+        current_item->next->prev=current_item;
+    }
+
+    child=array->child;
+    if(child==NULL){
+        array->child=chain;
+    }else{
+        suffix_object(get_list_tail(child),chain);
+    }
+    array->child->prev=tail;
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_AddChainToArray(cJSON*const array,cJSON*const chain){
+    return add_chain_to_array(array,chain,false);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_AddChainToObject(cJSON*const object,cJSON*const chain){
+    return add_chain_to_array(object,chain,true);
+}
+
+//link the items through next back to front,so the chain is built in one pass
+static cJSON *link_items(cJSON*const*const items,const int count){
+    cJSON *chain=NULL;
+    int index=0;
+
+    for(index=count-1;index>=0;index--){
+        if(items[index]==NULL){
+            //leave the items unlinked,as they were passed in
+            for(index++;index<count;index++){
+                items[index]->next=NULL;
+            }
+            return NULL;
+        }
+        items[index]->next=chain;
+        chain=items[index];
+    }
+
+    return chain;
+}
+
+static void unlink_items(cJSON*const*const items,const int count){
+    int index=0;
+
+    for(index=0;index<count;index++){
+        items[index]->next=NULL;
+        items[index]->prev=NULL;
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_AddItemsToArray(cJSON*const array,cJSON*const*const items,const int count){
+    cJSON *chain=NULL;
+
+    if((array==NULL)||(count<0)||((items==NULL)&&(count>0))){
+        return false;
+    }
+    if(count==0){
+        return true;
+    }
+
+    chain=link_items(items,count);
+    if(chain==NULL){
+        return false;
+    }
+    if(!add_chain_to_array(array,chain,false)){
+        unlink_items(items,count);
+        return false;
+    }
+
+    return true;
+}
+
+#if defined(__clang__)||(defined(__GNUC__)&&((__GNUC__>4)||((__GNUC__==4)&&(__GNUC_MINOR__>5))))
+    #pragma GCC diagnostic push
+#endif
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#endif
+//helper function to cast away const
+static void *cast_away_const(const void*string){
+    return (void*)string;
+}
+#if defined(__clang__)||(defined(__GNUC__)&&((__GNUC__>4)||((__GNUC__==4)&&(__GNUC_MINOR__>5))))
+    #pragma GCC diagnostic pop
+#endif
+
+static cJSON_bool add_item_to_object(cJSON*const object,const char*const string,cJSON*const item,const internal_hooks*const hooks,const cJSON_bool constant_key){
+    char *new_key=NULL;
+    int new_type=cJSON_Invalid;
+
+    if((object==NULL)||(string==NULL)||(item==NULL)||(item==object)||share_is_frozen(item)){
+        return false;
+    }
+    if(!own_children(object,NULL)){
+        return false;
+    }
+
+    if(constant_key){
+        new_key=(char*)cast_away_const(string);
+        new_type=item->type|cJSON_StringIsConst;
+    }else{
+        new_key=(char*)cJSON_strdup((const unsigned char*)string,hooks);
+        if(new_key==NULL){
+            return false;
+        }
+        new_type=item->type&~cJSON_StringIsConst;
+    }
+
+    if(!(item->type&cJSON_StringIsConst)&&(item->string!=NULL)){
+        hooks->deallcoate(item->string);
+    }
+
+    item->string=new_key;
+    item->type=new_type;
+
+    return add_item_to_array(object,item);
+}
+
+CJSON_PUBLIC(void)cJSON_AddItemToObject(cJSON*object,const char*string,cJSON*item){
+    add_item_to_object(object,string,item,&global_hooks,false);
+}
+
+//Add an item to an object with constant string as key
+CJSON_PUBLIC(void)cJSON_AddItemToObjectCS(cJSON*object,const char*string,cJSON*item){
+    add_item_to_object(object,string,item,&global_hooks,true);
+}
+
+/* The keys are all copied before anything is attached,so on failure the object
+ * and the items are left as they were. */
+CJSON_PUBLIC(cJSON_bool)cJSON_AddItemsToObject(cJSON*const object,const char*const*const names,cJSON*const*const items,const int count){
+    char **keys=NULL;
+    cJSON *chain=NULL;
+    int index=0;
+
+    if((object==NULL)||(count<0)||(((names==NULL)||(items==NULL))&&(count>0))){
+        return false;
+    }
+    if(count==0){
+        return true;
+    }
+
+    keys=(char**)global_hooks.allocate((size_t)count*sizeof(char*));
+    if(keys==NULL){
+        return false;
+    }
+    for(index=0;index<count;index++){
+        keys[index]=(names[index]!=NULL)?(char*)cJSON_strdup((const unsigned char*)names[index],&global_hooks):NULL;
+        if(keys[index]==NULL){
+            goto fail;
+        }
+    }
+
+    chain=link_items(items,count);
+    if(chain==NULL){
+        goto fail;
+    }
+    if(!add_chain_to_array(object,chain,false)){
+        unlink_items(items,count);
+        goto fail;
+    }
+
+    for(index=0;index<count;index++){
+        if(!(items[index]->type&cJSON_StringIsConst)&&(items[index]->string!=NULL)){
+            global_hooks.deallcoate(items[index]->string);
+        }
+        items[index]->string=keys[index];
+        items[index]->type&=~cJSON_StringIsConst;
+    }
+    global_hooks.deallcoate(keys);
+
+    return true;
+
+fail:
+    while(index>0){
+        index--;
+        global_hooks.deallcoate(keys[index]);
+    }
+    global_hooks.deallcoate(keys);
+
+    return false;
+}
+
+CJSON_PUBLIC(void)cJSON_AddItemRefernceToArray(cJSON*array,cJSON*item){
+    cJSON *reference=NULL;
+
+    if(array==NULL){
+        return;
+    }
+
+    reference=create_reference(item,&global_hooks);
+    if(!add_item_to_array(array,reference)){
+        cJSON_Delete(reference);
+    }
+}
+
+CJSON_PUBLIC(void)cJSON_AddItemRefernceToObject(cJSON*object,const char*string,cJSON*item){
+    cJSON *reference=NULL;
+
+    if((object==NULL)||(string==NULL)){
+        return;
+    }
+
+    reference=create_reference(item,&global_hooks);
+    if(!add_item_to_object(object,string,reference,&global_hooks,false)){
+        cJSON_Delete(reference);
+    }
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_DetachItemViaPointer(cJSON*parent,cJSON*const item){
+    cJSON *to_detach=item;
+
+    if((parent==NULL)||(item==NULL)){
+        return NULL;
+    }
+    //an item of a shared list is detached from the private copy
+    if(!own_children(parent,&to_detach)||share_is_frozen(to_detach)){
+        return NULL;
+    }
+
+    if(to_detach!=parent->child){
+        //not the first element
+        to_detach->prev->next=to_detach->next;
+    }
+    if(to_detach->next!=NULL){
+        //not the last element
+        to_detach->next->prev=to_detach->prev;
+    }
+
+    if(to_detach==parent->child){
+        //first element,the next one took over the tail above
+        parent->child=to_detach->next;
+    }else if(to_detach->next==NULL){
+        //last element
+        parent->child->prev=to_detach->prev;
+    }
+    //make sure the detached item doesn't point anywhere anymore
+    to_detach->prev=NULL;
+    to_detach->next=NULL;
+
+    return to_detach;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_DetachItemFromArray(cJSON*array,int which){
+    if(which<0){
+        return NULL;
+    }
+
+    return cJSON_DetachItemViaPointer(array,get_array_item(array,(size_t)which));
+}
+
+CJSON_PUBLIC(void)cJSON_DeleteItemFromArray(cJSON*array,int which){
+    cJSON_Delete(cJSON_DetachItemFromArray(array,which));
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_DetachItemFromObject(cJSON*object,const char*string){
+    cJSON *to_detach=cJSON_getObjectItem(object,string);
+
+    return cJSON_DetachItemViaPointer(object,to_detach);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_DetachItemFromObjectCaseSensitive(cJSON*object,const char*string){
+    cJSON *to_detach=cJSON_getObjectItemCaseSensitive(object,string);
+
+    return cJSON_DetachItemViaPointer(object,to_detach);
+}
+
+CJSON_PUBLIC(void)cJSON_DeleteItemFromObject(cJSON*object,const char*string){
+    cJSON_Delete(cJSON_DetachItemFromObject(object,string));
+}
+
+CJSON_PUBLIC(void)cJSON_DeleteItemFromObjectCaseSensitive(cJSON*object,const char*string){
+    cJSON_Delete(cJSON_DetachItemFromObjectCaseSensitive(object,string));
+}
+
+//Replace array/object items with new ones
+CJSON_PUBLIC(void)cJSON_InsertItemInArray(cJSON*array,int which,cJSON*newitem){
+    cJSON *after_inserted=NULL;
+
+    if((which<0)||(newitem==NULL)||(newitem==array)||share_is_frozen(newitem)){
+        return;
+    }
+    if(!own_children(array,NULL)){
+        return;
+    }
+
+    after_inserted=get_array_item(array,(size_t)which);
+    if(after_inserted==NULL){
+        add_item_to_array(array,newitem);
+        return;
+    }
+
+    if((after_inserted!=array->child)&&(after_inserted->prev==NULL)){
+        //corrupted array,only the first item may lack prev
+        return;
+    }
+
+    newitem->next=after_inserted;
+    newitem->prev=after_inserted->prev;
+    after_inserted->prev=newitem;
+    if(after_inserted==array->child){
+        array->child=newitem;
+        if(newitem->prev==NULL){
+            //a list linked by hand,keep its tail reachable from the new first item
+            newitem->prev=get_list_tail(newitem);
+        }
+    }else{
+        newitem->prev->next=newitem;
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_ReplaceItemViaPointer(cJSON*const parent,cJSON*const item,cJSON*replacement){
+    cJSON *to_replace=item;
+
+    if((parent==NULL)||(replacement==NULL)||(item==NULL)||share_is_frozen(replacement)){
+        return false;
+    }
+
+    if(replacement==item){
+        return true;
+    }
+
+    if(!own_children(parent,&to_replace)||share_is_frozen(to_replace)){
+        return false;
+    }
+
+    replacement->next=to_replace->next;
+    replacement->prev=to_replace->prev;
+
+    if(replacement->next!=NULL){
+        replacement->next->prev=replacement;
+    }
+    if(parent->child==to_replace){
+        if(parent->child->prev==to_replace){
+            //the only item is its own tail
+            replacement->prev=replacement;
+        }
+        parent->child=replacement;
+    }else{
+        replacement->prev->next=replacement;
+        if(replacement->next==NULL){
+            //the last item,update the tail
+            parent->child->prev=replacement;
+        }
+    }
+
+    to_replace->next=NULL;
+    to_replace->prev=NULL;
+    cJSON_Delete(to_replace);
+
+    return true;
+}
+
+CJSON_PUBLIC(void)cJSON_ReplaceItemInArray(cJSON*array,int which,cJSON*newitem){
+    if(which<0){
+        return;
+    }
+
+    cJSON_ReplaceItemViaPointer(array,get_array_item(array,(size_t)which),newitem);
+}
+
+static cJSON_bool replace_item_in_object(cJSON*object,const char*string,cJSON*replacement,cJSON_bool case_sensitive){
+    if((replacement==NULL)||(string==NULL)||share_is_frozen(replacement)){
+        return false;
+    }
+
+    //replace the name in the replacement
+    if(!(replacement->type&cJSON_StringIsConst)&&(replacement->string!=NULL)){
+        cJSON_free(replacement->string);
+    }
+    replacement->string=(char*)cJSON_strdup((const unsigned char*)string,&global_hooks);
+    replacement->type&=~cJSON_StringIsConst;
+
+    return cJSON_ReplaceItemViaPointer(object,get_object_item(object,string,case_sensitive),replacement);
+}
+
+CJSON_PUBLIC(void)cJSON_ReplaceItemInObject(cJSON*object,const char*string,cJSON*newitem){
+    replace_item_in_object(object,string,newitem,false);
+}
+
+CJSON_PUBLIC(void)cJSON_ReplaceItemInObjectCaseSensitive(cJSON*object,const char*string,cJSON*newitem){
+    replace_item_in_object(object,string,newitem,true);
+}
+
+//Create basic types
+CJSON_PUBLIC(cJSON*)cJSON_CreateNull(void){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_NULL;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateTrue(void){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_True;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateFalse(void){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_False;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateBool(cJSON_bool boolean){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=boolean?cJSON_True:cJSON_False;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateNumber(double num){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_Number;
+        assign_number(item,num);
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateString(const char*string){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_String;
+        item->valuestring=(char*)cJSON_strdup((const unsigned char*)string,&global_hooks);
+        if(item->valuestring==NULL){
+            cJSON_Delete(item);
+            return NULL;
+        }
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateStringReference(const char*string){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_String|cJSON_IsReference;
+        item->valuestring=(char*)cast_away_const(string);
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateObjectReference(const cJSON*child){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_Object|cJSON_IsReference;
+        item->child=(cJSON*)cast_away_const(child);
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateArrayReference(const cJSON*child){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_Array|cJSON_IsReference;
+        item->child=(cJSON*)cast_away_const(child);
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateRaw(const char*raw){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_Raw;
+        item->valuestring=(char*)cJSON_strdup((const unsigned char*)raw,&global_hooks);
+        if(item->valuestring==NULL){
+            cJSON_Delete(item);
+            return NULL;
+        }
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateArray(void){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_Array;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateObject(void){
+    cJSON *item=cJSON_NEW_Item(&global_hooks);
+    if(item!=NULL){
+        item->type=cJSON_Object;
+    }
+
+    return item;
+}
+
+/* Create Arrays. The items are linked in a single pass,keeping the tail instead
+ * of appending one by one. */
+static cJSON *create_array_of(const void*const values,const int count,cJSON*(*create)(const void*const values,const int index)){
+    cJSON *array=NULL;
+    cJSON *current_item=NULL;
+    cJSON *new_item=NULL;
+    int index=0;
+
+    if((count<0)||(values==NULL)){
+        return NULL;
+    }
+
+    array=cJSON_CreateArray();
+    if(array==NULL){
+        return NULL;
+    }
+
+    for(index=0;index<count;index++){
+        new_item=create(values,index);
+        if(new_item==NULL){
+            cJSON_Delete(array);
+            return NULL;
+        }
+        if(current_item==NULL){
+            array->child=new_item;
+        }else{
+            suffix_object(current_item,new_item);
+        }
+        current_item=new_item;
+    }
+    if(array->child!=NULL){
+        array->child->prev=current_item;
+    }
+
+    return array;
+}
+
+static cJSON *create_int_at(const void*const values,const int index){
+    return cJSON_CreateNumber((double)((const int*)values)[index]);
+}
+
+static cJSON *create_float_at(const void*const values,const int index){
+    return cJSON_CreateNumber((double)((const float*)values)[index]);
+}
+
+static cJSON *create_double_at(const void*const values,const int index){
+    return cJSON_CreateNumber(((const double*)values)[index]);
+}
+
+static cJSON *create_string_at(const void*const values,const int index){
+    return cJSON_CreateString(((const char*const*)values)[index]);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateIntArray(const int*numbers,int count){
+    return create_array_of(numbers,count,create_int_at);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateFloatArray(const float*numbers,int count){
+    return create_array_of(numbers,count,create_float_at);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateDoubleArray(const double*numbers,int count){
+    return create_array_of(numbers,count,create_double_at);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_CreateStringArray(const char*const*strings,int count){
+    return create_array_of(strings,count,create_string_at);
+}
+
+//add item under name,deleting it if that fails
+static cJSON *add_created_to_object(cJSON*const object,const char*const name,cJSON*const item){
+    if(add_item_to_object(object,name,item,&global_hooks,false)){
+        return item;
+    }
+
+    cJSON_Delete(item);
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddNullToObject(cJSON*const object,const char*const name){
+    return add_created_to_object(object,name,cJSON_CreateNull());
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddTrueToObject(cJSON*const object,const char*const name){
+    return add_created_to_object(object,name,cJSON_CreateTrue());
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddFalseToObject(cJSON*const object,const char*const name){
+    return add_created_to_object(object,name,cJSON_CreateFalse());
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddBoolToObject(cJSON*const object,const char*const name,const cJSON_bool boolean){
+    return add_created_to_object(object,name,cJSON_CreateBool(boolean));
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddNumberToObject(cJSON*const object,const char*const name,double number){
+    return add_created_to_object(object,name,cJSON_CreateNumber(number));
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddStringToObject(cJSON*const object,const char*const name,const char*const string){
+    return add_created_to_object(object,name,cJSON_CreateString(string));
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddRawToObject(cJSON*const object,const char*const name,const char*const raw){
+    return add_created_to_object(object,name,cJSON_CreateRaw(raw));
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddArrayToObject(cJSON*const object,const char*const name){
+    return add_created_to_object(object,name,cJSON_CreateArray());
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_AddObjectToObject(cJSON*const object,const char*const name){
+    return add_created_to_object(object,name,cJSON_CreateObject());
+}
+
+//copy the value and name of item into a new item without children
+static cJSON *duplicate_item(const cJSON*const item){
+    cJSON *newitem=cJSON_NEW_Item(&global_hooks);
+
+    if(newitem==NULL){
+        return NULL;
+    }
+
+    //copy over all vars
+    newitem->type=item->type&(~(cJSON_IsReference|cJSON_HasShape));
+    newitem->valueint=item->valueint;
+    newitem->valuedouble=item->valuedouble;
+    if(item->valuestring!=NULL){
+        newitem->valuestring=(char*)cJSON_strdup((unsigned char*)item->valuestring,&global_hooks);
+        if(newitem->valuestring==NULL){
+            goto fail;
+        }
+    }
+    if(item->string!=NULL){
+        newitem->string=(item->type&cJSON_StringIsConst)?item->string:(char*)cJSON_strdup((unsigned char*)item->string,&global_hooks);
+        if(newitem->string==NULL){
+            goto fail;
+        }
+    }
+
+    return newitem;
+
+fail:
+    cJSON_Delete(newitem);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_Duplicate(const cJSON*item,cJSON_bool recurse){
+    cJSON *newitem=NULL;
+    cJSON *child=NULL;
+    cJSON *next=NULL;
+    cJSON *newchild=NULL;
+
+    //bail on bad ptr
+    if(item==NULL){
+        goto fail;
+    }
+
+    newitem=duplicate_item(item);
+    if(newitem==NULL){
+        goto fail;
+    }
+    //if non-recursive,then we're done
+    if(!recurse){
+        return newitem;
+    }
+    //walk the ->next chain for the child
+    child=item->child;
+    while(child!=NULL){
+        newchild=cJSON_Duplicate(child,true);
+        if(newchild==NULL){
+            goto fail;
+        }
+        if(next!=NULL){
+            //if newitem->child already set,then crosswire ->prev and ->next and move on
+            next->next=newchild;
+            newchild->prev=next;
+            next=newchild;
+        }else{
+            //set newitem->child and move to it
+            newitem->child=newchild;
+            next=newchild;
+        }
+        child=child->next;
+    }
+    if(newitem->child!=NULL){
+        newitem->child->prev=next;
+    }
+
+    return newitem;
+
+fail:
+    if(newitem!=NULL){
+        cJSON_Delete(newitem);
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_DuplicateShared(const cJSON*item){
+    cJSON *newitem=NULL;
+
+    if(item==NULL){
+        return NULL;
+    }
+
+    newitem=duplicate_item(item);
+    if(newitem==NULL){
+        return NULL;
+    }
+
+    if(item->child!=NULL){
+        share_freeze(item->child);
+        share_add_owner(item->child);
+        newitem->child=item->child;
+    }
+
+    return newitem;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_IsShared(const cJSON*const item){
+    if(item==NULL){
+        return false;
+    }
+
+    return share_is_frozen(item);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_GetArrayItemMutable(cJSON*array,int index){
+    if((index<0)||!own_children(array,NULL)){
+        return NULL;
+    }
+
+    return get_array_item(array,(size_t)index);
+}
+
+static cJSON *get_object_item_mutable(cJSON*const object,const char*const string,const cJSON_bool case_sensitive){
+    if(!own_children(object,NULL)){
+        return NULL;
+    }
+
+    return get_object_item(object,string,case_sensitive);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_GetObjectItemMutable(cJSON*object,const char*string){
+    return get_object_item_mutable(object,string,false);
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_GetObjectItemMutableCaseSensitive(cJSON*object,const char*string){
+    return get_object_item_mutable(object,string,true);
+}
+
+//skip a comment starting at input,a '/' that does not start a comment is copied to the output
+static unsigned char *skip_comment(unsigned char*input,const unsigned char*const end,unsigned char**const output){
+    if(((end-input)>1)&&(input[1]=='/')){
+        //line comment,the newline is removed as whitespace
+        input+=2;
+        while((input<end)&&(*input!='\n')){
+            input++;
+        }
+        return input;
+    }
+
+    if(((end-input)>1)&&(input[1]=='*')){
+        //multiline comment,an unterminated one runs until the end
+        input+=2;
+        while(((end-input)>1)&&!((input[0]=='*')&&(input[1]=='/'))){
+            input++;
+        }
+        return ((end-input)>1)?input+2:(unsigned char*)end;
+    }
+
+    *(*output)++=*input++;
+    return input;
+}
+
+//copy the bytes selected by keep from a block to the output
+static unsigned char *compact_block(unsigned char*output,const unsigned char*const block,uint64_t keep){
+    size_t i=0;
+
+    if(keep==~(uint64_t)0){
+        memmove(output,block,BLOCK_SIZE);
+        return output+BLOCK_SIZE;
+    }
+
+    //runs of kept bytes are common,so work on 8 bytes at a time
+    for(i=0;(i<BLOCK_SIZE)&&(keep!=0);i+=8,keep>>=8){
+        unsigned int group=(unsigned int)(keep&0xFF);
+        if(group==0xFF){
+            uint64_t word;
+            memcpy(&word,block+i,sizeof(word));
+            memcpy(output,&word,sizeof(word));
+            output+=8;
+            continue;
+        }
+        while(group!=0){
+            *output++=block[i+trailing_zeroes(group)];
+            group&=group-1;
+        }
+    }
+
+    return output;
+}
+
+CJSON_PUBLIC(size_t)cJSON_MinifyWithLength(char*json,size_t length){
+    unsigned char *input=(unsigned char*)json;
+    unsigned char *output=(unsigned char*)json;
+    const unsigned char*const end=(unsigned char*)json+length;
+    block_state state={0,0};
+    cJSON_bool in_string=false;
+    cJSON_bool escaped=false;
+
+    if(json==NULL){
+        return 0;
+    }
+
+    while((size_t)(end-input)>=BLOCK_SIZE){
+        block_masks masks;
+        uint64_t in_string_mask=0;
+        uint64_t keep=0;
+        uint64_t comments=0;
+
+        classify_block(input,&masks);
+        in_string_mask=string_mask(&masks,&state);
+        keep=~(masks.whitespace&~in_string_mask);
+        comments=masks.slash&~in_string_mask;
+
+        if(comments!=0){
+            //copy up to the first '/' outside a string and handle the comment byte by byte
+            unsigned int position=trailing_zeroes(comments);
+            output=compact_block(output,input,keep&((((uint64_t)1)<<position)-1));
+            input=skip_comment(input+position,end,&output);
+            state.escaped_carry=0;
+            state.in_string_carry=0;
+            continue;
+        }
+
+        output=compact_block(output,input,keep);
+        input+=BLOCK_SIZE;
+    }
+
+    //finish the tail byte by byte,continuing the block state
+    in_string=(state.in_string_carry!=0);
+    escaped=(state.escaped_carry!=0);
+    while(input<end){
+        if(in_string){
+            if(escaped){
+                escaped=false;
+            }
+            else if(*input=='\\'){
+                escaped=true;
+            }
+            else if(*input=='\"'){
+                in_string=false;
+            }
+            *output++=*input++;
+            continue;
+        }
+
+        //like the block masks,a backslash outside a string keeps the next quote from opening one
+        if(escaped){
+            escaped=false;
+            if((*input=='\"')||(*input=='\\')){
+                *output++=*input++;
+                continue;
+            }
+        }
+
+        switch(*input)
+        {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            input++;
+            break;
+        case '/':
+            input=skip_comment(input,end,&output);
+            break;
+        case '\"':
+            in_string=true;
+            *output++=*input++;
+            break;
+        case '\\':
+            escaped=true;
+            *output++=*input++;
+            break;
+        default:
+            *output++=*input++;
+            break;
+        }
+    }
+
+    return (size_t)(output-(unsigned char*)json);
+}
+
+CJSON_PUBLIC(void)cJSON_Minify(char*json){
+    size_t length=0;
+
+    if(json==NULL){
+        return;
+    }
+
+    length=cJSON_MinifyWithLength(json,strlen(json));
+    json[length]='\0';
+}
+
+CJSON_PUBLIC(void*)cJSON_malloc(size_t size){
+    return global_hooks.allocate(size);
+}
+
+CJSON_PUBLIC(void)cJSON_free(void*object){
+    global_hooks.deallcoate(object);
+}
+
+/* CBOR (RFC 8949) encoding of cJSON trees. Integral numbers are stored as CBOR
+ * integers and everything else as float64,strings are length prefixed and
+ * arrays/objects carry their element count. Raw items are text strings tagged
+ * 262 (embedded JSON). */
+#define CBOR_UNSIGNED 0
+#define CBOR_NEGATIVE 1
+#define CBOR_BYTES 2
+#define CBOR_TEXT 3
+#define CBOR_ARRAY 4
+#define CBOR_MAP 5
+#define CBOR_TAG 6
+#define CBOR_SIMPLE 7
+
+#define CBOR_FALSE 20
+#define CBOR_TRUE 21
+#define CBOR_NULL 22
+#define CBOR_UNDEFINED 23
+#define CBOR_FLOAT16 25
+#define CBOR_FLOAT32 26
+#define CBOR_FLOAT64 27
+
+#define CBOR_TAG_EMBEDDED_JSON 262
+
+//write a major type with its argument in the shortest form
+static cJSON_bool cbor_write_head(printbuffer*const output_buffer,const unsigned char major,const uint64_t argument){
+    unsigned char *output=ensure(output_buffer,9);
+    size_t length=0;
+    size_t i=0;
+
+    if(output==NULL){
+        return false;
+    }
+
+    if(argument<24){
+        output[0]=(unsigned char)((major<<5)|argument);
+        output_buffer->offset++;
+        return true;
+    }
+
+    if(argument<=0xFF){
+        output[0]=(unsigned char)((major<<5)|24);
+        length=1;
+    }
+    else if(argument<=0xFFFF){
+        output[0]=(unsigned char)((major<<5)|25);
+        length=2;
+    }
+    else if(argument<=0xFFFFFFFFULL){
+        output[0]=(unsigned char)((major<<5)|26);
+        length=4;
+    }
+    else{
+        output[0]=(unsigned char)((major<<5)|27);
+        length=8;
+    }
+
+    //arguments are big endian
+    for(i=0;i<length;i++){
+        output[length-i]=(unsigned char)(argument>>(8*i));
+    }
+    output_buffer->offset+=length+1;
+
+    return true;
+}
+
+static cJSON_bool cbor_encode_number(const double d,printbuffer*const output_buffer){
+    unsigned char *output=NULL;
+    uint64_t bits=0;
+    size_t i=0;
+
+    //integral values that fit 64 bits are stored as integers,-0.0 keeps its sign as a float
+    if((d>=-9223372036854775808.0)&&(d<9223372036854775808.0)&&(d==(double)(int64_t)d)&&!((d==0)&&signbit(d))){
+        const int64_t integer=(int64_t)d;
+        if(integer>=0){
+            return cbor_write_head(output_buffer,CBOR_UNSIGNED,(uint64_t)integer);
+        }
+        return cbor_write_head(output_buffer,CBOR_NEGATIVE,(uint64_t)(-1-integer));
+    }
+
+    output=ensure(output_buffer,9);
+    if(output==NULL){
+        return false;
+    }
+
+    memcpy(&bits,&d,sizeof(bits));
+    output[0]=(unsigned char)((CBOR_SIMPLE<<5)|CBOR_FLOAT64);
+    for(i=0;i<8;i++){
+        output[8-i]=(unsigned char)(bits>>(8*i));
+    }
+    output_buffer->offset+=9;
+
+    return true;
+}
+
+static cJSON_bool cbor_encode_text(const char*const string,printbuffer*const output_buffer){
+    const size_t length=(string==NULL)?0:strlen(string);
+    unsigned char *output=NULL;
+
+    if(!cbor_write_head(output_buffer,CBOR_TEXT,(uint64_t)length)){
+        return false;
+    }
+
+    output=ensure(output_buffer,length);
+    if(output==NULL){
+        return false;
+    }
+    if(length>0){
+        memcpy(output,string,length);
+    }
+    output_buffer->offset+=length;
+
+    return true;
+}
+
+static cJSON_bool cbor_encode_value(const cJSON*const item,printbuffer*const output_buffer){
+    const cJSON *child=NULL;
+    size_t count=0;
+
+    if((item==NULL)||(output_buffer==NULL)){
+        return false;
+    }
+
+    switch((item->type)&0xFF)
+    {
+    case cJSON_NULL:
+        return cbor_write_head(output_buffer,CBOR_SIMPLE,CBOR_NULL);
+    case cJSON_False:
+        return cbor_write_head(output_buffer,CBOR_SIMPLE,CBOR_FALSE);
+    case cJSON_True:
+        return cbor_write_head(output_buffer,CBOR_SIMPLE,CBOR_TRUE);
+    case cJSON_Number:
+        return cbor_encode_number(number_value(item),output_buffer);
+    case cJSON_String:
+        return cbor_encode_text(item->valuestring,output_buffer);
+    case cJSON_Raw:
+        if(item->valuestring==NULL){
+            return false;
+        }
+        return cbor_write_head(output_buffer,CBOR_TAG,CBOR_TAG_EMBEDDED_JSON)&&cbor_encode_text(item->valuestring,output_buffer);
+    case cJSON_Array:
+    case cJSON_Object:
+        for(child=item->child;child!=NULL;child=child->next){
+            count++;
+        }
+        if(!cbor_write_head(output_buffer,(((item->type)&0xFF)==cJSON_Array)?CBOR_ARRAY:CBOR_MAP,(uint64_t)count)){
+            return false;
+        }
+        output_buffer->depth++;
+        for(child=item->child;child!=NULL;child=child->next){
+            if((((item->type)&0xFF)==cJSON_Object)&&!cbor_encode_text(child->string,output_buffer)){
+                return false;
+            }
+            if(!cbor_encode_value(child,output_buffer)){
+                return false;
+            }
+        }
+        output_buffer->depth--;
+        return true;
+    default:
+        return false;
+    }
+}
+
+CJSON_PUBLIC(unsigned char*)cJSON_EncodeCBOR(const cJSON*const item,size_t*const length){
+    static const size_t default_buffer_size=256;
+    printbuffer p={0,0,0,0,0,0,{0,0,0},0};
+
+    p.buffer=(unsigned char*)global_hooks.allocate(default_buffer_size);
+    if(p.buffer==NULL){
+        return NULL;
+    }
+    p.length=default_buffer_size;
+    p.hooks=global_hooks;
+
+    if(!cbor_encode_value(item,&p)){
+        if(p.buffer!=NULL){
+            global_hooks.deallcoate(p.buffer);
+        }
+        return NULL;
+    }
+
+    if(length!=NULL){
+        *length=p.offset;
+    }
+
+    return p.buffer;
+}
+
+CJSON_PUBLIC(const unsigned char*)cJSON_PrinterEncodeCBOR(cJSON_Printer*const printer,const cJSON*const item,size_t*const length){
+    return printer_render(printer,item,false,true,length);
+}
+
+//read a major type and its argument,indefinite lengths are not supported
+static cJSON_bool cbor_read_head(parse_buffer*const input_buffer,unsigned char*const major,unsigned char*const additional,uint64_t*const argument){
+    size_t length=0;
+    size_t i=0;
+
+    if(cannot_access_at_index(input_buffer,0)){
+        return false;
+    }
+
+    *major=(unsigned char)(buffer_at_offset(input_buffer)[0]>>5);
+    *additional=(unsigned char)(buffer_at_offset(input_buffer)[0]&0x1F);
+    input_buffer->offset++;
+
+    if(*additional<24){
+        *argument=*additional;
+        return true;
+    }
+
+    switch(*additional)
+    {
+    case 24:
+        length=1;
+        break;
+    case 25:
+        length=2;
+        break;
+    case 26:
+        length=4;
+        break;
+    case 27:
+        length=8;
+        break;
+    default:
+        input_buffer->offset--;
+        return false;
+    }
+
+    if(!can_read(input_buffer,length)){
+        input_buffer->offset--;
+        return false;
+    }
+
+    *argument=0;
+    for(i=0;i<length;i++){
+        *argument=(*argument<<8)|buffer_at_offset(input_buffer)[i];
+    }
+    input_buffer->offset+=length;
+
+    return true;
+}
+
+static double cbor_half_to_double(const unsigned int half){
+    const int exponent=(int)((half>>10)&0x1F);
+    const double mantissa=(double)(half&0x3FF);
+    double value=0;
+
+    if(exponent==0){
+        value=ldexp(mantissa,-24);
+    }
+    else if(exponent!=31){
+        value=ldexp(mantissa+1024,exponent-25);
+    }
+    else{
+        value=(mantissa==0)?HUGE_VAL:(HUGE_VAL-HUGE_VAL);
+    }
+
+    return (half&0x8000)?-value:value;
+}
+
+static cJSON_bool cbor_decode_value(cJSON*const item,parse_buffer*const input_buffer);
+
+static cJSON_bool cbor_decode_text(char**const string,parse_buffer*const input_buffer){
+    unsigned char major=0;
+    unsigned char additional=0;
+    uint64_t length=0;
+
+    if(!cbor_read_head(input_buffer,&major,&additional,&length)||(major!=CBOR_TEXT)){
+        return false;
+    }
+    if((length>(uint64_t)(input_buffer->length-input_buffer->offset))){
+        return false;
+    }
+
+    *string=(char*)input_buffer->hooks.allocate((size_t)length+sizeof(""));
+    if(*string==NULL){
+        return false;
+    }
+    memcpy(*string,buffer_at_offset(input_buffer),(size_t)length);
+    (*string)[length]='\0';
+    input_buffer->offset+=(size_t)length;
+
+    return true;
+}
+
+static cJSON_bool cbor_decode_container(cJSON*const item,parse_buffer*const input_buffer,const unsigned char major,uint64_t count){
+    cJSON *head=NULL;
+    cJSON *current_item=NULL;
+
+    if(input_buffer->depth>=CJSON_NESTING_LIMIT){
+        return false;//to deeply nested
+    }
+    //every element takes at least one byte,reject counts the input cannot hold
+    if(count>(uint64_t)(input_buffer->length-input_buffer->offset)){
+        return false;
+    }
+    input_buffer->depth++;
+
+    for(;count>0;count--){
+        cJSON *new_item=cJSON_NEW_Item(&(input_buffer->hooks));
+        if(new_item==NULL){
+            goto fail;
+        }
+
+        if(head==NULL){
+            current_item=head=new_item;
+        }
+        else{
+            current_item->next=new_item;
+            new_item->prev=current_item;
+            current_item=new_item;
+        }
+
+        if((major==CBOR_MAP)&&!cbor_decode_text(&current_item->string,input_buffer)){
+            goto fail;
+        }
+        if(!cbor_decode_value(current_item,input_buffer)){
+            goto fail;
+        }
+    }
+
+    input_buffer->depth--;
+    if(head!=NULL){
+        head->prev=current_item;
+    }
+    item->type=(major==CBOR_ARRAY)?cJSON_Array:cJSON_Object;
+    item->child=head;
+
+    return true;
+
+fail:
+    if(head!=NULL){
+        cJSON_Delete(head);
+    }
+
+    return false;
+}
+
+static cJSON_bool cbor_decode_value(cJSON*const item,parse_buffer*const input_buffer){
+    unsigned char major=0;
+    unsigned char additional=0;
+    uint64_t argument=0;
+    size_t start=0;
+
+    //tags other than embedded JSON are dropped and their content kept,a run of
+    //them is read here rather than by recursion
+    do
+    {
+        start=input_buffer->offset;
+        if(!cbor_read_head(input_buffer,&major,&additional,&argument)){
+            return false;
+        }
+    }
+    while((major==CBOR_TAG)&&(argument!=CBOR_TAG_EMBEDDED_JSON));
+
+    switch(major)
+    {
+    case CBOR_UNSIGNED:
+        item->type=cJSON_Number;
+        assign_number(item,(double)argument);
+        return true;
+    case CBOR_NEGATIVE:
+        item->type=cJSON_Number;
+        assign_number(item,-1.0-(double)argument);
+        return true;
+    case CBOR_TEXT:
+        input_buffer->offset=start;
+        if(!cbor_decode_text(&item->valuestring,input_buffer)){
+            return false;
+        }
+        item->type=cJSON_String;
+        return true;
+    case CBOR_ARRAY:
+    case CBOR_MAP:
+        return cbor_decode_container(item,input_buffer,major,argument);
+    case CBOR_TAG:
+        //embedded JSON becomes a raw item
+        if(!cbor_decode_text(&item->valuestring,input_buffer)){
+            return false;
+        }
+        item->type=cJSON_Raw;
+        return true;
+    case CBOR_SIMPLE:
+        switch(additional)
+        {
+        case CBOR_FALSE:
+            item->type=cJSON_False;
+            return true;
+        case CBOR_TRUE:
+            item->type=cJSON_True;
+            item->valueint=1;
+            return true;
+        case CBOR_NULL:
+        case CBOR_UNDEFINED:
+            item->type=cJSON_NULL;
+            return true;
+        case CBOR_FLOAT16:
+            item->type=cJSON_Number;
+            assign_number(item,cbor_half_to_double((unsigned int)argument));
+            return true;
+        case CBOR_FLOAT32:
+        {
+            const uint32_t bits=(uint32_t)argument;
+            float f=0;
+            memcpy(&f,&bits,sizeof(f));
+            item->type=cJSON_Number;
+            assign_number(item,(double)f);
+            return true;
+        }
+        case CBOR_FLOAT64:
+        {
+            double d=0;
+            memcpy(&d,&argument,sizeof(d));
+            item->type=cJSON_Number;
+            assign_number(item,d);
+            return true;
+        }
+        default:
+            break;
+        }
+        break;
+    default:
+        //byte strings have no JSON counterpart
+        break;
+    }
+
+    input_buffer->offset=start;
+    return false;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_DecodeCBOR(const unsigned char*const data,const size_t length,size_t*const consumed){
+    parse_buffer buffer={0,0,0,0,{0,0,0},0,NULL,NULL};
+    cJSON *item=NULL;
+
+    if((data==NULL)||(length==0)){
+        goto fail;
+    }
+
+    buffer.content=data;
+    buffer.length=length;
+    buffer.offset=0;
+    buffer.hooks=global_hooks;
+
+    item=cJSON_NEW_Item(&global_hooks);
+    if(item==NULL){
+        goto fail;
+    }
+
+    if(!cbor_decode_value(item,&buffer)){
+        goto fail;
+    }
+
+    if(consumed!=NULL){
+        *consumed=buffer.offset;
+    }
+
+    return item;
+
+fail:
+    if(item!=NULL){
+        cJSON_Delete(item);
+    }
+    if(consumed!=NULL){
+        *consumed=buffer.offset;
+    }
+
+    return NULL;
+}
+
+/* Snapshots: a tree flattened into one position independent image that can be used
+ * read-only straight from memory or mmap. Items are fixed size records,the children of
+ * an array/object are contiguous,and every reference is an offset relative to the item
+ * holding it,so the image needs no fixups when loaded at any address.
+ * Objects with SNAPSHOT_INDEX_MINIMUM or more members are preceded by a hash index:
+ * 2*count rounded up to a power of two uint32 slots,right before the first child,each
+ * 0 or 1+the index of a member. Names are hashed case folded,so the index serves both
+ * lookups,and linear probing finds duplicate names in member order. */
+#define SNAPSHOT_MAGIC "cJSONimg"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_ENDIAN 0x01020304UL
+#define SNAPSHOT_ALIGNMENT 8
+#define SNAPSHOT_INDEX_MINIMUM 8
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;//written natively,rejects images from machines with another byte order
+    uint64_t size;//the whole image,header included
+    uint64_t checksum;//FNV-1a over everything behind the header
+}snapshot_header;
+
+struct cJSON_SnapshotItem
+{
+    uint32_t type;
+    uint32_t string;//offset of the '\0' terminated name,0 if none
+    uint32_t count;//number of children,or the length of the string
+    uint32_t child;//offset of the first child,or of the string
+    double valuedouble;
+};
+
+static uint64_t snapshot_checksum(const unsigned char*data,size_t length){
+    uint64_t hash=0xCBF29CE484222325ULL;
+
+    while(length-->0){
+        hash^=*data++;
+        hash*=0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+//append length bytes (zeroed when data is NULL) and return their offset
+static size_t snapshot_append(printbuffer*const output_buffer,const void*const data,const size_t length,const size_t alignment){
+    unsigned char *output=NULL;
+    size_t padding=(alignment-(output_buffer->offset%alignment))%alignment;
+    size_t position=0;
+
+    output=ensure(output_buffer,padding+length);
+    if(output==NULL){
+        return 0;
+    }
+
+    memset(output,0,padding);
+    position=output_buffer->offset+padding;
+    if(data!=NULL){
+        memcpy(output+padding,data,length);
+    }
+    else{
+        memset(output+padding,0,length);
+    }
+    output_buffer->offset+=padding+length;
+
+    return position;
+}
+
+#define snapshot_item_at(output_buffer,position) ((cJSON_SnapshotItem*)((output_buffer)->buffer+(position)))
+
+static uint32_t snapshot_name_hash(const unsigned char*name){
+    uint32_t hash=0x811C9DC5UL;
+
+    for(;*name!='\0';name++){
+        hash^=(uint32_t)tolower(*name);
+        hash*=0x01000193UL;
+    }
+
+    return hash;
+}
+
+//number of index slots of an object with count members,0 if it has no index
+static size_t snapshot_index_slots(const size_t count){
+    size_t slots=2*SNAPSHOT_INDEX_MINIMUM;
+
+    if(count<SNAPSHOT_INDEX_MINIMUM){
+        return 0;
+    }
+    while(slots<2*count){
+        slots*=2;
+    }
+
+    return slots;
+}
+
+//fill the record at position for item,then append its name,string and children
+static cJSON_bool snapshot_write_item(printbuffer*const output_buffer,const cJSON*const item,const size_t position){
+    const cJSON *child=NULL;
+    size_t data=0;
+    size_t count=0;
+    size_t slots=0;
+    size_t index=0;
+    size_t i=0;
+
+    snapshot_item_at(output_buffer,position)->type=(uint32_t)(item->type&0xFF);
+    snapshot_item_at(output_buffer,position)->valuedouble=number_value(item);
+
+    if(item->string!=NULL){
+        data=snapshot_append(output_buffer,item->string,strlen(item->string)+sizeof(""),1);
+        if((data==0)||((data-position)>UINT32_MAX)){
+            return false;
+        }
+        snapshot_item_at(output_buffer,position)->string=(uint32_t)(data-position);
+    }
+
+    switch(item->type&0xFF)
+    {
+    case cJSON_String:
+    case cJSON_Raw:
+        count=(item->valuestring==NULL)?0:strlen(item->valuestring);
+        data=snapshot_append(output_buffer,(item->valuestring==NULL)?"":item->valuestring,count+sizeof(""),1);
+        break;
+    case cJSON_Array:
+    case cJSON_Object:
+        for(child=item->child;child!=NULL;child=child->next){
+            count++;
+        }
+        if(count==0){
+            return true;
+        }
+        if((item->type&0xFF)==cJSON_Object){
+            slots=snapshot_index_slots(count);
+        }
+        if(slots>0){
+            //a multiple of the alignment,so the children follow without padding
+            index=snapshot_append(output_buffer,NULL,slots*sizeof(uint32_t),SNAPSHOT_ALIGNMENT);
+            if(index==0){
+                return false;
+            }
+        }
+        data=snapshot_append(output_buffer,NULL,count*sizeof(cJSON_SnapshotItem),SNAPSHOT_ALIGNMENT);
+        break;
+    default:
+        return true;
+    }
+
+    if((data==0)||((data-position)>UINT32_MAX)||(count>UINT32_MAX)){
+        return false;
+    }
+    snapshot_item_at(output_buffer,position)->count=(uint32_t)count;
+    snapshot_item_at(output_buffer,position)->child=(uint32_t)(data-position);
+
+    if(((item->type&0xFF)==cJSON_Array)||((item->type&0xFF)==cJSON_Object)){
+        for(child=item->child,i=0;child!=NULL;child=child->next,i++){
+            if(!snapshot_write_item(output_buffer,child,data+i*sizeof(cJSON_SnapshotItem))){
+                return false;
+            }
+        }
+    }
+
+    //the buffer may have moved while the children were written
+    for(child=item->child,i=0;(slots>0)&&(child!=NULL);child=child->next,i++){
+        uint32_t *const table=(uint32_t*)(output_buffer->buffer+index);
+        size_t slot=snapshot_name_hash((const unsigned char*)((child->string!=NULL)?child->string:""))&(slots-1);
+        while(table[slot]!=0){
+            slot=(slot+1)&(slots-1);
+        }
+        table[slot]=(uint32_t)(i+1);
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(void*)cJSON_CreateSnapshot(const cJSON*const item,size_t*const length){
+    static const size_t default_buffer_size=256;
+    printbuffer p={0,0,0,0,0,0,{0,0,0},0};
+    snapshot_header header;
+    size_t root=0;
+
+    if(item==NULL){
+        return NULL;
+    }
+
+    p.buffer=(unsigned char*)global_hooks.allocate(default_buffer_size);
+    if(p.buffer==NULL){
+        return NULL;
+    }
+    p.length=default_buffer_size;
+    p.hooks=global_hooks;
+
+    memset(&header,0,sizeof(header));
+    if(snapshot_append(&p,&header,sizeof(header),SNAPSHOT_ALIGNMENT)!=0){
+        goto fail;
+    }
+    root=snapshot_append(&p,NULL,sizeof(cJSON_SnapshotItem),SNAPSHOT_ALIGNMENT);
+    if((root==0)||!snapshot_write_item(&p,item,root)){
+        goto fail;
+    }
+
+    memcpy(header.magic,SNAPSHOT_MAGIC,sizeof(header.magic));
+    header.version=SNAPSHOT_VERSION;
+    header.endian=SNAPSHOT_ENDIAN;
+    header.size=p.offset;
+    header.checksum=snapshot_checksum(p.buffer+sizeof(header),p.offset-sizeof(header));
+    memcpy(p.buffer,&header,sizeof(header));
+
+    if(length!=NULL){
+        *length=p.offset;
+    }
+
+    return p.buffer;
+
+fail:
+    if(p.buffer!=NULL){
+        global_hooks.deallcoate(p.buffer);
+    }
+
+    return NULL;
+}
+
+//check that every offset of item stays inside [image,end)
+static cJSON_bool snapshot_verify_item(const unsigned char*const image,const unsigned char*const end,const cJSON_SnapshotItem*const item,const cJSON_bool named,const size_t depth){
+    const unsigned char*const base=(const unsigned char*)item;
+    uint32_t i=0;
+
+    if((depth>CJSON_NESTING_LIMIT)||(((size_t)(base-image))%SNAPSHOT_ALIGNMENT!=0)||((size_t)(end-base)<sizeof(cJSON_SnapshotItem))){
+        return false;
+    }
+
+    if(named&&(item->string==0)){
+        //object members need a name
+        return false;
+    }
+    if((item->string!=0)&&(((size_t)(end-base)<=item->string)||(memchr(base+item->string,'\0',(size_t)(end-base)-item->string)==NULL))){
+        return false;
+    }
+
+    switch(item->type)
+    {
+    case cJSON_False:
+    case cJSON_True:
+    case cJSON_NULL:
+    case cJSON_Number:
+        return true;
+    case cJSON_String:
+    case cJSON_Raw:
+        return (item->child!=0)&&(item->child<(size_t)(end-base))&&(((size_t)(end-base)-item->child)>item->count)&&(base[item->child+item->count]=='\0');
+    case cJSON_Array:
+    case cJSON_Object:
+        if(item->count==0){
+            return true;
+        }
+        if((item->child==0)||(item->child>=(size_t)(end-base))||(((size_t)(end-base)-item->child)/sizeof(cJSON_SnapshotItem)<item->count)){
+            return false;
+        }
+        if(item->type==cJSON_Object){
+            const size_t slots=snapshot_index_slots(item->count);
+            const uint32_t*const table=(const uint32_t*)(base+item->child)-slots;
+            size_t used=0;
+            if(item->child<slots*sizeof(uint32_t)){
+                return false;
+            }
+            //lookups stop at an empty slot,so there must be one
+            for(i=0;i<slots;i++){
+                if(table[i]>item->count){
+                    return false;
+                }
+                used+=(table[i]!=0);
+            }
+            if(used>item->count){
+                return false;
+            }
+        }
+        for(i=0;i<item->count;i++){
+            const cJSON_SnapshotItem*const child=(const cJSON_SnapshotItem*)(base+item->child)+i;
+            if(!snapshot_verify_item(image,end,child,item->type==cJSON_Object,depth+1)){
+                return false;
+            }
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+CJSON_PUBLIC(const cJSON_SnapshotItem*)cJSON_SnapshotOpen(const void*const image,const size_t size,const cJSON_bool verify){
+    const unsigned char*const bytes=(const unsigned char*)image;
+    const cJSON_SnapshotItem *root=NULL;
+    snapshot_header header;
+
+    if((image==NULL)||(size<(sizeof(header)+sizeof(cJSON_SnapshotItem)))||((((size_t)bytes)%SNAPSHOT_ALIGNMENT)!=0)){
+        return NULL;
+    }
+
+    //reject images from another version or machine before touching anything else
+    memcpy(&header,image,sizeof(header));
+    if((memcmp(header.magic,SNAPSHOT_MAGIC,sizeof(header.magic))!=0)||(header.version!=SNAPSHOT_VERSION)||(header.endian!=SNAPSHOT_ENDIAN)||(header.size>size)||(header.size<(sizeof(header)+sizeof(cJSON_SnapshotItem)))){
+        return NULL;
+    }
+
+    root=(const cJSON_SnapshotItem*)(bytes+sizeof(header));
+
+    //the checksum and bounds walk read the whole image,so they are optional
+    if(verify){
+        if(snapshot_checksum(bytes+sizeof(header),(size_t)header.size-sizeof(header))!=header.checksum){
+            return NULL;
+        }
+        if(!snapshot_verify_item(bytes,bytes+header.size,root,false,0)){
+            return NULL;
+        }
+    }
+
+    return root;
+}
+
+CJSON_PUBLIC(int)cJSON_SnapshotGetArraySize(const cJSON_SnapshotItem*const array){
+    if((array==NULL)||((array->type!=cJSON_Array)&&(array->type!=cJSON_Object))){
+        return 0;
+    }
+
+    return (int)array->count;
+}
+
+CJSON_PUBLIC(const cJSON_SnapshotItem*)cJSON_SnapshotGetArrayItem(const cJSON_SnapshotItem*const array,const int index){
+    if((array==NULL)||((array->type!=cJSON_Array)&&(array->type!=cJSON_Object))||(index<0)||((uint32_t)index>=array->count)){
+        return NULL;
+    }
+
+    //children are contiguous,so this is a single load
+    return (const cJSON_SnapshotItem*)((const unsigned char*)array+array->child)+index;
+}
+
+static const cJSON_SnapshotItem *snapshot_get_object_item(const cJSON_SnapshotItem*const object,const char*const name,const cJSON_bool case_sensitive){
+    const cJSON_SnapshotItem *child=NULL;
+    uint32_t i=0;
+
+    if((object==NULL)||(name==NULL)||(object->type!=cJSON_Object)||(object->count==0)){
+        return NULL;
+    }
+
+    child=(const cJSON_SnapshotItem*)((const unsigned char*)object+object->child);
+    if(object->count>=SNAPSHOT_INDEX_MINIMUM){
+        const size_t slots=snapshot_index_slots(object->count);
+        const uint32_t*const table=(const uint32_t*)child-slots;
+        size_t slot=snapshot_name_hash((const unsigned char*)name)&(slots-1);
+        for(;table[slot]!=0;slot=(slot+1)&(slots-1)){
+            const cJSON_SnapshotItem*const member=child+(table[slot]-1);
+            const char*const string=(const char*)member+member->string;
+            if(case_sensitive?(strcmp(name,string)==0):(case_insensitive_strcmp((const unsigned char*)name,(const unsigned char*)string)==0)){
+                return member;
+            }
+        }
+        return NULL;
+    }
+
+    for(i=0;i<object->count;i++,child++){
+        const char*const string=(const char*)child+child->string;
+        if(case_sensitive?(strcmp(name,string)==0):(case_insensitive_strcmp((const unsigned char*)name,(const unsigned char*)string)==0)){
+            return child;
+        }
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(const cJSON_SnapshotItem*)cJSON_SnapshotGetObjectItem(const cJSON_SnapshotItem*const object,const char*const string){
+    return snapshot_get_object_item(object,string,false);
+}
+
+CJSON_PUBLIC(const cJSON_SnapshotItem*)cJSON_SnapshotGetObjectItemCaseSensitive(const cJSON_SnapshotItem*const object,const char*const string){
+    return snapshot_get_object_item(object,string,true);
+}
+
+CJSON_PUBLIC(const char*)cJSON_SnapshotGetName(const cJSON_SnapshotItem*const item){
+    if((item==NULL)||(item->string==0)){
+        return NULL;
+    }
+
+    return (const char*)item+item->string;
+}
+
+CJSON_PUBLIC(const char*)cJSON_SnapshotGetStringValue(const cJSON_SnapshotItem*const item){
+    if((item==NULL)||((item->type!=cJSON_String)&&(item->type!=cJSON_Raw))){
+        return NULL;
+    }
+
+    return (const char*)item+item->child;
+}
+
+CJSON_PUBLIC(double)cJSON_SnapshotGetNumberValue(const cJSON_SnapshotItem*const item){
+    if((item==NULL)||(item->type!=cJSON_Number)){
+        return 0;
+    }
+
+    return item->valuedouble;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsInvalid(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_Invalid);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsFalse(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_False);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsTrue(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_True);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsBool(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&((item->type&(cJSON_True|cJSON_False))!=0);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsNULL(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_NULL);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsNumber(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_Number);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsString(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_String);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsArray(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_Array);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsObject(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_Object);
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_SnapshotIsRaw(const cJSON_SnapshotItem*const item){
+    return (item!=NULL)&&(item->type==cJSON_Raw);
+}
+
+/* Frozen documents: a snapshot with its indexes,shared by reference counting. A
+ * frozen document is never written after cJSON_Freeze returns,so any number of
+ * threads can read it without locking. A slot publishes a new version RCU style:
+ * readers take a reference to the current version inside a short read section,
+ * counted per epoch. The publisher swaps the version,flips the epoch and waits for
+ * the read sections of the old epoch to end; after that no reader can still be
+ * taking a reference to the old version,and the publisher drops its own. */
+struct cJSON_Frozen
+{
+    size_t refcount;
+    void *image;
+    const cJSON_SnapshotItem *root;
+};
+
+struct cJSON_FrozenSlot
+{
+    cJSON_Frozen *current;
+    size_t epoch;
+    size_t readers[2];//readers inside a read section,per epoch
+    size_t publishing;//serializes publishers
+};
+
+CJSON_PUBLIC(cJSON_Frozen*)cJSON_Freeze(const cJSON*const item){
+    cJSON_Frozen *frozen=NULL;
+    size_t length=0;
+
+    frozen=(cJSON_Frozen*)global_hooks.allocate(sizeof(cJSON_Frozen));
+    if(frozen==NULL){
+        return NULL;
+    }
+
+    frozen->image=cJSON_CreateSnapshot(item,&length);
+    if(frozen->image==NULL){
+        global_hooks.deallcoate(frozen);
+        return NULL;
+    }
+    frozen->root=cJSON_SnapshotOpen(frozen->image,length,false);
+    frozen->refcount=1;
+
+    return frozen;
+}
+
+CJSON_PUBLIC(const cJSON_SnapshotItem*)cJSON_FrozenGetRoot(const cJSON_Frozen*const frozen){
+    if(frozen==NULL){
+        return NULL;
+    }
+
+    return frozen->root;
+}
+
+CJSON_PUBLIC(cJSON_Frozen*)cJSON_FrozenRetain(cJSON_Frozen*const frozen){
+    if(frozen!=NULL){
+        atomic_add_size(&frozen->refcount,1);
+    }
+
+    return frozen;
+}
+
+CJSON_PUBLIC(void)cJSON_FrozenRelease(cJSON_Frozen*const frozen){
+    if((frozen==NULL)||(atomic_sub_size(&frozen->refcount,1)!=0)){
+        return;
+    }
+
+    global_hooks.deallcoate(frozen->image);
+    global_hooks.deallcoate(frozen);
+}
+
+CJSON_PUBLIC(cJSON_FrozenSlot*)cJSON_CreateFrozenSlot(cJSON_Frozen*const initial){
+    cJSON_FrozenSlot *slot=(cJSON_FrozenSlot*)global_hooks.allocate(sizeof(cJSON_FrozenSlot));
+
+    if(slot==NULL){
+        return NULL;
+    }
+
+    memset(slot,0,sizeof(cJSON_FrozenSlot));
+    slot->current=initial;
+
+    return slot;
+}
+
+CJSON_PUBLIC(cJSON_Frozen*)cJSON_FrozenSlotAcquire(cJSON_FrozenSlot*const slot){
+    cJSON_Frozen *frozen=NULL;
+    size_t epoch=0;
+
+    if(slot==NULL){
+        return NULL;
+    }
+
+    //enter a read section of the current epoch,retry if it flipped meanwhile
+    for(;;){
+        epoch=atomic_load_size(&slot->epoch);
+        atomic_add_size(&slot->readers[epoch],1);
+        if(atomic_load_size(&slot->epoch)==epoch){
+            break;
+        }
+        atomic_sub_size(&slot->readers[epoch],1);
+    }
+
+    frozen=cJSON_FrozenRetain((cJSON_Frozen*)atomic_load_pointer(&slot->current));
+
+    atomic_sub_size(&slot->readers[epoch],1);
+
+    return frozen;
+}
+
+CJSON_PUBLIC(void)cJSON_FrozenSlotPublish(cJSON_FrozenSlot*const slot,cJSON_Frozen*const next){
+    cJSON_Frozen *previous=NULL;
+    size_t epoch=0;
+
+    if(slot==NULL){
+        return;
+    }
+
+    while(atomic_exchange_size(&slot->publishing,1)!=0){
+        //another publisher is waiting for its readers
+    }
+
+    previous=(cJSON_Frozen*)atomic_exchange_pointer(&slot->current,next);
+
+    //readers that enter from now on see the new epoch and the new version
+    epoch=atomic_load_size(&slot->epoch);
+    atomic_store_size(&slot->epoch,epoch^1);
+    while(atomic_load_size(&slot->readers[epoch])!=0){
+        //read sections are a few instructions long
+    }
+
+    atomic_store_size(&slot->publishing,0);
+
+    cJSON_FrozenRelease(previous);
+}
+
+CJSON_PUBLIC(void)cJSON_DeleteFrozenSlot(cJSON_FrozenSlot*const slot){
+    if(slot==NULL){
+        return;
+    }
+
+    cJSON_FrozenRelease(slot->current);
+    global_hooks.deallcoate(slot);
+}
+
+/* Pooled allocator for cJSON_InitHooks. Every thread allocates from its own pool:
+ * blocks of a few size classes (one fits a cJSON item,the others small strings)
+ * carved from 64KB chunks and recycled through per class free lists,without any
+ * locking or atomic operation. A block records its pool in a header,so a block
+ * freed by another thread is collected into a batch for its pool,and a full batch
+ * is pushed onto the pool's remote list with one atomic operation. The pool takes
+ * the remote list back in one exchange when a free list runs empty. Larger sizes
+ * go to malloc. A thread that ends,or calls cJSON_PoolReleaseThread,releases its
+ * pool: the chunks are freed as soon as no block carved from them is in use,which
+ * may be when the last one is freed by another thread.
+ * cJSON_InitPooledHooks installs the pool in place of the hooks. */
+
+#define POOL_CHUNK_SIZE 65536
+#define POOL_BATCH_SIZE 64
+#define POOL_CLASSES 6
+#define POOL_LARGE POOL_CLASSES
+
+typedef struct pool pool;
+
+typedef union
+{
+    struct
+    {
+        pool *owner;//NULL for blocks from malloc
+        size_t size_class;
+    }header;
+    double alignment;//blocks are aligned like malloc's for doubles and pointers
+}pool_header;
+
+//payload of a free block
+typedef struct pool_link
+{
+    struct pool_link *next;
+}pool_link;
+
+struct pool
+{
+    pool_link *free_list[POOL_CLASSES];
+    pool_link *remote;//blocks freed by other threads,pushed atomically
+    unsigned char *chunk;//the chunk being carved,the first header of each links the one before
+    size_t chunk_used;
+    size_t live;//blocks handed out and not freed by the owner,only touched by the owner
+    /* 0 minus the blocks freed by other threads,changed atomically. A release adds
+     * live,and whoever brings it back to 0 frees the pool. */
+    size_t balance;
+};
+
+static const size_t pool_class_size[POOL_CLASSES]={16,32,64,sizeof(cJSON),128,256};
+
+#if defined(CJSON_THREAD_LOCAL)
+static CJSON_THREAD_LOCAL pool *thread_pool=NULL;
+//blocks of another pool freed by this thread,not yet returned
+static CJSON_THREAD_LOCAL pool *thread_batch_owner=NULL;
+static CJSON_THREAD_LOCAL pool_link *thread_batch_head=NULL;
+static CJSON_THREAD_LOCAL pool_link *thread_batch_tail=NULL;
+static CJSON_THREAD_LOCAL size_t thread_batch_count=0;
+
+//chunks and large blocks of the pooled allocator not yet freed
+static size_t pool_held=0;
+
+/* A thread that ends without cJSON_PoolReleaseThread releases its pool from a
+ * thread exit callback,registered the first time the thread holds a pool or a
+ * batch. The key is created by cJSON_InitPooledHooks. */
+static CJSON_THREAD_LOCAL cJSON_bool thread_registered=false;
+static cJSON_bool pool_key_ready=false;
+#if defined(_WIN32)
+static DWORD pool_key=FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI pool_thread_exit(PVOID value){
+    (void)value;
+    //the key's value is cleared,a pool taken by a later callback registers again
+    thread_registered=false;
+    cJSON_PoolReleaseThread();
+}
+#else
+static pthread_key_t pool_key;
+
+static void pool_thread_exit(void*value){
+    (void)value;
+    //the key's value is cleared,a pool taken by a later callback registers again
+    thread_registered=false;
+    cJSON_PoolReleaseThread();
+}
+#endif
+
+static void pool_register_thread(void){
+    if(thread_registered||!pool_key_ready){
+        return;
+    }
+    //any value but NULL makes the callback run
+#if defined(_WIN32)
+    thread_registered=FlsSetValue(pool_key,(PVOID)&pool_key)?true:false;
+#else
+    thread_registered=(pthread_setspecific(pool_key,&pool_key)==0);
+#endif
+}
+
+#define pool_payload(block) ((void*)((pool_header*)(block)+1))
+#define pool_block(payload) ((pool_header*)(payload)-1)
+#define pool_previous_chunk(chunk) (*(unsigned char**)(chunk))
+#if defined(__GNUC__)||defined(__clang__)
+#define pool_prefetch(block) __builtin_prefetch((block),1)
+#else
+#define pool_prefetch(block) ((void)(block))
+#endif
+
+static size_t pool_size_class(const size_t size){
+    size_t size_class=0;
+    size_t best=POOL_LARGE;
+
+    //the classes are sorted except for the one of cJSON items,so look for the tightest fit
+    for(size_class=0;size_class<POOL_CLASSES;size_class++){
+        if((size<=pool_class_size[size_class])&&((best==POOL_LARGE)||(pool_class_size[size_class]<pool_class_size[best]))){
+            best=size_class;
+        }
+    }
+
+    return best;
+}
+
+static pool *pool_for_thread(void){
+    pool *current=thread_pool;
+
+    if(current!=NULL){
+        return current;
+    }
+
+    current=(pool*)malloc(sizeof(pool));
+    if(current==NULL){
+        return NULL;
+    }
+    memset(current,0,sizeof(pool));
+    thread_pool=current;
+    pool_register_thread();
+
+    return current;
+}
+
+//free a released pool once none of its blocks is in use
+static void pool_delete(pool*const current){
+    unsigned char *chunk=current->chunk;
+
+    while(chunk!=NULL){
+        unsigned char *const previous=pool_previous_chunk(chunk);
+        free(chunk);
+        atomic_sub_size(&pool_held,1);
+        chunk=previous;
+    }
+    free(current);
+}
+
+//give the pending batch back to its pool
+static void pool_flush_batch(void){
+    pool *const owner=thread_batch_owner;
+    pool_link *head=NULL;
+
+    if(owner==NULL){
+        return;
+    }
+
+    head=(pool_link*)atomic_load_pointer(&owner->remote);
+    do{
+        thread_batch_tail->next=head;
+    }while(!atomic_compare_exchange_pointer(&owner->remote,head,thread_batch_head));
+    //the owner cannot reach 0 before it is released,after that these were its last blocks
+    if(atomic_sub_size(&owner->balance,thread_batch_count)==0){
+        pool_delete(owner);
+    }
+
+    thread_batch_owner=NULL;
+    thread_batch_head=NULL;
+    thread_batch_tail=NULL;
+    thread_batch_count=0;
+}
+
+//sort the blocks freed by other threads into the free lists
+static void pool_collect_remote(pool*const current){
+    pool_link *block=(pool_link*)atomic_exchange_pointer(&current->remote,NULL);
+
+    while(block!=NULL){
+        pool_link *const next=block->next;
+        const size_t size_class=pool_block(block)->header.size_class;
+        block->next=current->free_list[size_class];
+        current->free_list[size_class]=block;
+        block=next;
+    }
+}
+
+static void *CJSON_CDECL pool_malloc(size_t size){
+    const size_t size_class=pool_size_class(size);
+    const size_t block_size=sizeof(pool_header)+((size_class==POOL_LARGE)?size:pool_class_size[size_class]);
+    pool *const current=(size_class==POOL_LARGE)?NULL:pool_for_thread();
+    pool_header *block=NULL;
+    pool_link *free_block=NULL;
+
+    if(current==NULL){
+        if(block_size<size){
+            return NULL;
+        }
+        block=(pool_header*)malloc(block_size);
+        if(block==NULL){
+            return NULL;
+        }
+        atomic_add_size(&pool_held,1);
+        block->header.owner=NULL;
+        block->header.size_class=POOL_LARGE;
+        return pool_payload(block);
+    }
+
+    //a load is enough to see the remote list is empty,which is the case while chunks are carved
+    if((current->free_list[size_class]==NULL)&&(atomic_load_pointer(&current->remote)!=NULL)){
+        pool_collect_remote(current);
+    }
+    free_block=current->free_list[size_class];
+    if(free_block!=NULL){
+        current->free_list[size_class]=free_block->next;
+        //popping waits on the block,so start loading the next one now
+        pool_prefetch(free_block->next);
+        current->live++;
+        return free_block;
+    }
+
+    //carve a new block,block sizes are multiples of the header size
+    if((current->chunk==NULL)||((POOL_CHUNK_SIZE-current->chunk_used)<block_size)){
+        unsigned char *const chunk=(unsigned char*)malloc(POOL_CHUNK_SIZE);
+        if(chunk==NULL){
+            return NULL;
+        }
+        atomic_add_size(&pool_held,1);
+        pool_previous_chunk(chunk)=current->chunk;
+        current->chunk=chunk;
+        current->chunk_used=sizeof(pool_header);
+    }
+    block=(pool_header*)(current->chunk+current->chunk_used);
+    current->chunk_used+=(block_size+sizeof(pool_header)-1)/sizeof(pool_header)*sizeof(pool_header);
+    block->header.owner=current;
+    block->header.size_class=size_class;
+    current->live++;
+
+    return pool_payload(block);
+}
+
+static void CJSON_CDECL pool_free(void*pointer){
+    pool_header *block=NULL;
+    pool_link *link=(pool_link*)pointer;
+    pool *owner=NULL;
+
+    if(pointer==NULL){
+        return;
+    }
+
+    block=pool_block(pointer);
+    owner=block->header.owner;
+    if(owner==NULL){
+        free(block);
+        atomic_sub_size(&pool_held,1);
+        return;
+    }
+
+    if(owner==thread_pool){
+        link->next=owner->free_list[block->header.size_class];
+        owner->free_list[block->header.size_class]=link;
+        owner->live--;
+        return;
+    }
+
+    //a block of another thread's pool,or of this thread's released one,joins the batch for that pool
+    if(thread_batch_owner!=owner){
+        pool_flush_batch();
+        thread_batch_owner=owner;
+        thread_batch_tail=link;
+        pool_register_thread();
+    }
+    link->next=thread_batch_head;
+    thread_batch_head=link;
+    thread_batch_count++;
+    if(thread_batch_count>=POOL_BATCH_SIZE){
+        pool_flush_batch();
+    }
+}
+
+static cJSON_bool pool_holds_memory(void){
+    return (global_hooks.allocate==pool_malloc)&&(atomic_load_size(&pool_held)!=0);
+}
+
+CJSON_PUBLIC(void)cJSON_PoolReleaseThread(void){
+    pool *const current=thread_pool;
+
+    pool_flush_batch();
+    if(current==NULL){
+        return;
+    }
+
+    thread_pool=NULL;
+    //blocks still in use keep the pool until the last of them is freed
+    if(atomic_add_size(&current->balance,current->live)==0){
+        pool_delete(current);
+    }
+}
+
+CJSON_PUBLIC(void)cJSON_InitPooledHooks(void){
+    if(!pool_key_ready){
+#if defined(_WIN32)
+        pool_key=FlsAlloc(pool_thread_exit);
+        pool_key_ready=(pool_key!=FLS_OUT_OF_INDEXES);
+#else
+        pool_key_ready=(pthread_key_create(&pool_key,pool_thread_exit)==0);
+#endif
+    }
+    global_hooks.allocate=pool_malloc;
+    global_hooks.deallcoate=pool_free;
+    global_hooks.realloccate=NULL;
+}
+#else
+//without thread local storage the default allocator is kept
+static cJSON_bool pool_holds_memory(void){
+    return false;
+}
+
+CJSON_PUBLIC(void)cJSON_PoolReleaseThread(void){
+}
+
+CJSON_PUBLIC(void)cJSON_InitPooledHooks(void){
+    cJSON_InitHooks(NULL);
+}
+#endif
+
+/* Subtree digests. Object digests combine their members with a sum,which does not
+ * depend on member order,and hash names case folded,so one digest serves both
+ * comparison modes. They are cached by item,see digest_forget. */
+static uint64_t digest_mix(uint64_t hash){
+    hash^=hash>>33;
+    hash*=0xFF51AFD7ED558CCDULL;
+    hash^=hash>>33;
+    hash*=0xC4CEB9FE1A85EC53ULL;
+    hash^=hash>>33;
+    return hash;
+}
+
+static uint64_t digest_string(const unsigned char*string,const cJSON_bool fold_case){
+    uint64_t hash=0xCBF29CE484222325ULL;
+
+    if(string==NULL){
+        return 0;
+    }
+
+    for(;*string!='\0';string++){
+        hash^=fold_case?(uint64_t)tolower(*string):(uint64_t)*string;
+        hash*=0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+static uint64_t item_digest(const cJSON*const item){
+    const cJSON *child=NULL;
+    uint64_t hash=(uint64_t)(item->type&0xFF);
+    double number=0;
+
+    switch(item->type&0xFF)
+    {
+    case cJSON_Number:
+        //-0.0 and 0.0 compare equal
+        number=read_number_value(item);
+        number=(number==0)?0:number;
+        memcpy(&hash,&number,sizeof(hash));
+        break;
+    case cJSON_String:
+    case cJSON_Raw:
+        hash=digest_string((const unsigned char*)item->valuestring,false);
+        break;
+    case cJSON_Array:
+        for(child=item->child;child!=NULL;child=child->next){
+            hash=digest_mix(hash+item_digest(child));
+        }
+        break;
+    case cJSON_Object:
+        for(child=item->child;child!=NULL;child=child->next){
+            hash+=digest_mix(digest_string((const unsigned char*)child->string,true)^(item_digest(child)*0x9E3779B97F4A7C15ULL));
+        }
+        break;
+    default:
+        break;
+    }
+
+    return digest_mix(hash^((uint64_t)(item->type&0xFF)<<56));
+}
+
+#if defined(CJSON_THREAD_LOCAL)
+static CJSON_THREAD_LOCAL digest_entry digest_cache[DIGEST_CACHE_SIZE];
+
+static uint64_t cached_digest(const cJSON*const item){
+    digest_entry *const entry=&digest_cache[(size_t)(((uint64_t)(uintptr_t)item*0x9E3779B97F4A7C15ULL)>>32)&(DIGEST_CACHE_SIZE-1)];
+    size_t epoch=0;
+
+    if(atomic_load_size(&digest_cached)==0){
+        atomic_store_size(&digest_cached,1);
+    }
+    //read before the walk,a change meanwhile leaves the entry stale
+    epoch=atomic_load_size(&digest_epoch);
+    if((entry->item!=item)||(entry->epoch!=epoch)){
+        entry->digest=item_digest(item);
+        entry->item=item;
+        entry->epoch=epoch;
+    }
+
+    return entry->digest;
+}
+#else
+#define cached_digest(item) item_digest(item)
+#endif
+
+CJSON_PUBLIC(unsigned long long)cJSON_Digest(const cJSON*const item){
+    if(item==NULL){
+        return 0;
+    }
+
+    return (unsigned long long)cached_digest(item);
+}
+
+static cJSON_bool compare_items(const cJSON*const a,const cJSON*const b,const cJSON_bool case_sensitive);
+
+static cJSON_bool compare_object_member(const cJSON*const member,const cJSON*const object,const cJSON_bool case_sensitive){
+    const cJSON *candidate=NULL;
+
+    for(candidate=object->child;candidate!=NULL;candidate=candidate->next){
+        if((candidate->string==NULL)||(member->string==NULL)){
+            continue;
+        }
+        if((case_sensitive?strcmp(member->string,candidate->string):case_insensitive_strcmp((const unsigned char*)member->string,(const unsigned char*)candidate->string))!=0){
+            continue;
+        }
+        if(compare_items(member,candidate,case_sensitive)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static cJSON_bool compare_items(const cJSON*const a,const cJSON*const b,const cJSON_bool case_sensitive){
+    const cJSON *a_element=NULL;
+    const cJSON *b_element=NULL;
+
+    if((a==NULL)||(b==NULL)||((a->type&0xFF)!=(b->type&0xFF))){
+        return false;
+    }
+
+    //check if type is valid
+    switch(a->type&0xFF)
+    {
+    case cJSON_False:
+    case cJSON_True:
+    case cJSON_NULL:
+    case cJSON_Number:
+    case cJSON_String:
+    case cJSON_Raw:
+    case cJSON_Array:
+    case cJSON_Object:
+        break;
+    default:
+        return false;
+    }
+
+    //identical items are equal to each other
+    if(a==b){
+        return true;
+    }
+
+    switch(a->type&0xFF)
+    {
+    //in these cases and equal type is enough
+    case cJSON_False:
+    case cJSON_True:
+    case cJSON_NULL:
+        return true;
+    case cJSON_Number:
+        return read_number_value(a)==read_number_value(b);
+    case cJSON_String:
+    case cJSON_Raw:
+        if((a->valuestring==NULL)||(b->valuestring==NULL)){
+            return false;
+        }
+        return strcmp(a->valuestring,b->valuestring)==0;
+    case cJSON_Array:
+        for(a_element=a->child,b_element=b->child;(a_element!=NULL)&&(b_element!=NULL);a_element=a_element->next,b_element=b_element->next){
+            if(!compare_items(a_element,b_element,case_sensitive)){
+                return false;
+            }
+        }
+        //one of the arrays is longer than the other
+        return a_element==b_element;
+    case cJSON_Object:
+        //members usually come in the same order,so walk both lists side by side first
+        for(a_element=a->child,b_element=b->child;(a_element!=NULL)&&(b_element!=NULL);a_element=a_element->next,b_element=b_element->next){
+            if((a_element->string==NULL)||(b_element->string==NULL)||((case_sensitive?strcmp(a_element->string,b_element->string):case_insensitive_strcmp((const unsigned char*)a_element->string,(const unsigned char*)b_element->string))!=0)||!compare_items(a_element,b_element,case_sensitive)){
+                break;
+            }
+        }
+        if((a_element==NULL)&&(b_element==NULL)){
+            return true;
+        }
+        if(cJSON_GetArraySize(a)!=cJSON_GetArraySize(b)){
+            return false;
+        }
+
+        //then look the remaining members up by name,both ways
+        for(;a_element!=NULL;a_element=a_element->next){
+            if(!compare_object_member(a_element,b,case_sensitive)){
+                return false;
+            }
+        }
+        for(b_element=b->child;b_element!=NULL;b_element=b_element->next){
+            if(!compare_object_member(b_element,a,case_sensitive)){
+                return false;
+            }
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_Compare(const cJSON*const a,const cJSON*const b,const cJSON_bool case_sensitive){
+    //containers are first told apart by their cached digests
+    if((a!=NULL)&&(b!=NULL)&&(a!=b)&&((a->type&0xFF)==(b->type&0xFF))&&((a->type&(cJSON_Array|cJSON_Object))!=0)&&(cached_digest(a)!=cached_digest(b))){
+        return false;
+    }
+
+    return compare_items(a,b,case_sensitive);
+}
+
+/* Queries over newline-delimited JSON. The paths a query names form a tree of
+ * member names and array indexes. A record is scanned once along that tree: the
+ * values at query paths are parsed into a worker's cJSON_Parser storage,which is
+ * rewound for every record,and everything else is validated and skipped without
+ * allocating. A value below a captured one is looked up in the captured tree.
+ * Records are split into ranges at line ends,each range keeps its own rows and
+ * groups,and the ranges are merged in input order. */
+#ifndef CJSON_QUERY_MIN_RANGE
+#define CJSON_QUERY_MIN_RANGE 65536
+#endif
+//a reader's records are gathered in a window of at least this size
+#ifndef CJSON_QUERY_WINDOW
+#define CJSON_QUERY_WINDOW ((size_t)1<<20)
+#endif
+
+typedef struct query_node
+{
+    char *name;//the decoded path segment,NULL for the root
+    size_t length;
+    size_t index;//the segment as an array index,SIZE_MAX if it is not one
+    int slot;//where the value is captured,-1 if the path is not part of the query
+    struct query_node *child;
+    struct query_node *next;
+}query_node;
+
+typedef struct
+{
+    int slot;
+    int operation;
+    cJSON *operand;
+    char *needle;//the operand as a string literal,NULL if records can't be prefiltered on it
+    size_t needle_length;
+}query_predicate;
+
+typedef struct
+{
+    int function;
+    int slot;//-1 for count without a path
+    char *name;
+}query_aggregate;
+
+struct cJSON_Query
+{
+    query_node root;
+    char **paths;//the path of each slot
+    size_t slot_count;
+    query_predicate *predicates;
+    size_t predicate_count;
+    int *projections;
+    size_t projection_count;
+    query_aggregate *aggregates;
+    size_t aggregate_count;
+    int group_slot;//-1 without group-by
+    int flags;
+};
+
+typedef struct
+{
+    double value;//sum,minimum or maximum
+    size_t count;//numbers seen,or records for count
+}query_accumulator;
+
+typedef struct
+{
+    cJSON **keys;//the key of each group in order of appearance
+    uint64_t *hashes;
+    query_accumulator *accumulators;//aggregate_count per group
+    size_t count;
+    size_t capacity;
+    size_t *table;//1+group index,0 for a free slot
+    size_t table_size;//a power of two
+}query_groups;
+
+//the rows and groups of one range or of the whole run
+typedef struct
+{
+    cJSON *rows;
+    query_groups groups;
+}query_result;
+
+typedef struct
+{
+    const cJSON_Query *query;
+    cJSON_Parser *storage;//the captured values of the current record
+    cJSON **values;//per slot,NULL if the record has no value there
+    cJSON *record;//the whole record when rows are whole records
+    cJSON null_key;//group key of records without a value at the group path
+}query_worker;
+
+typedef struct
+{
+    size_t start;
+    size_t end;
+    query_result result;
+    size_t error_offset;//SIZE_MAX if every record of the range was read
+}query_range;
+
+typedef struct
+{
+    const cJSON_Query *query;
+    const unsigned char *content;
+    size_t base;//offset of content in the input
+    query_range *ranges;
+    size_t range_count;
+    size_t next_range;
+}query_job;
+
+//replace *array of count elements by one with room for capacity
+static cJSON_bool query_resize(void**const array,const size_t count,const size_t capacity,const size_t size){
+    void *grown=global_hooks.allocate(capacity*size);
+    if(grown==NULL){
+        return false;
+    }
+    if(*array!=NULL){
+        memcpy(grown,*array,count*size);
+        global_hooks.deallcoate(*array);
+    }
+    *array=grown;
+
+    return true;
+}
+
+static void query_delete_nodes(query_node*node){
+    while(node!=NULL){
+        query_node *const next=node->next;
+        query_delete_nodes(node->child);
+        global_hooks.deallcoate(node->name);
+        global_hooks.deallcoate(node);
+        node=next;
+    }
+}
+
+//the child of parent for a segment of length bytes,which is created if needed
+static query_node *query_child(query_node*const parent,const char*const segment,const size_t length){
+    query_node *node=NULL;
+    size_t position=0;
+
+    for(node=parent->child;node!=NULL;node=node->next){
+        if((node->length==length)&&(memcmp(node->name,segment,length)==0)){
+            return node;
+        }
+    }
+
+    node=(query_node*)global_hooks.allocate(sizeof(query_node));
+    if(node==NULL){
+        return NULL;
+    }
+    memset(node,0,sizeof(query_node));
+    node->name=(char*)global_hooks.allocate(length+sizeof(""));
+    if(node->name==NULL){
+        global_hooks.deallcoate(node);
+        return NULL;
+    }
+    memcpy(node->name,segment,length);
+    node->name[length]='\0';
+    node->length=length;
+    node->slot=-1;
+
+    //array indexes are written without leading zeroes
+    node->index=SIZE_MAX;
+    if((length>0)&&((segment[0]!='0')||(length==1))){
+        size_t index=0;
+        for(position=0;(position<length)&&(segment[position]>='0')&&(segment[position]<='9');position++){
+            if(index>(SIZE_MAX-10)/10){
+                break;
+            }
+            index=index*10+(size_t)(segment[position]-'0');
+        }
+        if(position==length){
+            node->index=index;
+        }
+    }
+
+    node->next=parent->child;
+    parent->child=node;
+
+    return node;
+}
+
+//the slot of a JSON Pointer,-1 if it is malformed or memory ran out
+static int query_slot(cJSON_Query*const query,const char*const path){
+    query_node *node=&query->root;
+    const char *segment=path;
+    char *decoded=NULL;
+    char *copy=NULL;
+    size_t length=0;
+
+    if((path==NULL)||((path[0]!='\0')&&(path[0]!='/'))){
+        return -1;
+    }
+
+    decoded=(char*)global_hooks.allocate(strlen(path)+sizeof(""));
+    if(decoded==NULL){
+        return -1;
+    }
+    while(*segment=='/'){
+        segment++;
+        //~0 stands for '~' and ~1 for '/'
+        for(length=0;(*segment!='\0')&&(*segment!='/');segment++){
+            if(*segment=='~'){
+                if((segment[1]!='0')&&(segment[1]!='1')){
+                    goto fail;
+                }
+                decoded[length++]=(segment[1]=='0')?'~':'/';
+                segment++;
+            }else{
+                decoded[length++]=*segment;
+            }
+        }
+        node=query_child(node,decoded,length);
+        if(node==NULL){
+            goto fail;
+        }
+    }
+    global_hooks.deallcoate(decoded);
+    decoded=NULL;
+
+    if(node->slot>=0){
+        return node->slot;
+    }
+    copy=(char*)cJSON_strdup((const unsigned char*)path,&global_hooks);
+    if((copy==NULL)||!query_resize((void**)&query->paths,query->slot_count,query->slot_count+1,sizeof(char*))){
+        goto fail;
+    }
+    query->paths[query->slot_count]=copy;
+    node->slot=(int)query->slot_count++;
+
+    return node->slot;
+
+fail:
+    if(decoded!=NULL){
+        global_hooks.deallcoate(decoded);
+    }
+    if(copy!=NULL){
+        global_hooks.deallcoate(copy);
+    }
+
+    return -1;
+}
+
+CJSON_PUBLIC(cJSON_Query*)cJSON_CreateQuery(int flags){
+    cJSON_Query *query=(cJSON_Query*)global_hooks.allocate(sizeof(cJSON_Query));
+    if(query==NULL){
+        return NULL;
+    }
+    memset(query,0,sizeof(cJSON_Query));
+    query->root.index=SIZE_MAX;
+    query->root.slot=-1;
+    query->group_slot=-1;
+    //numbers are converted as they are read
+    query->flags=flags&~cJSON_ParseLazyNumbers;
+
+    return query;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_QueryWhere(cJSON_Query*const query,const char*path,int operation,const cJSON*operand){
+    query_predicate predicate;
+    const unsigned char *character=NULL;
+
+    if((query==NULL)||(operation<cJSON_QueryEqual)||(operation>cJSON_QueryExists)){
+        return false;
+    }
+    memset(&predicate,0,sizeof(predicate));
+    predicate.operation=operation;
+
+    if(operation!=cJSON_QueryExists){
+        switch((operand!=NULL)?(operand->type&0xFF):cJSON_Invalid)
+        {
+        case cJSON_Number:
+            predicate.operand=cJSON_CreateNumber(cJSON_GetNumberValue(operand));
+            break;
+        case cJSON_String:
+            predicate.operand=cJSON_CreateString(operand->valuestring);
+            break;
+        case cJSON_True:
+        case cJSON_False:
+        case cJSON_NULL:
+            predicate.operand=cJSON_Duplicate(operand,false);
+            break;
+        default:
+            return false;
+        }
+        if(predicate.operand==NULL){
+            return false;
+        }
+    }
+
+    /* A record without backslashes writes the string as is,so it can only equal
+     * the operand if it holds the literal; operands with characters that need
+     * escaping are never written as is. */
+    if((operation==cJSON_QueryEqual)&&cJSON_IsString(predicate.operand)){
+        for(character=(const unsigned char*)predicate.operand->valuestring;(*character>=32)&&(*character!='\"')&&(*character!='\\');character++){
+        }
+        if(*character=='\0'){
+            predicate.needle_length=(size_t)(character-(const unsigned char*)predicate.operand->valuestring)+2;
+            predicate.needle=(char*)global_hooks.allocate(predicate.needle_length);
+            if(predicate.needle==NULL){
+                goto fail;
+            }
+            predicate.needle[0]='\"';
+            memcpy(predicate.needle+1,predicate.operand->valuestring,predicate.needle_length-2);
+            predicate.needle[predicate.needle_length-1]='\"';
+        }
+    }
+
+    predicate.slot=query_slot(query,path);
+    if((predicate.slot<0)||!query_resize((void**)&query->predicates,query->predicate_count,query->predicate_count+1,sizeof(query_predicate))){
+        goto fail;
+    }
+    query->predicates[query->predicate_count++]=predicate;
+
+    return true;
+
+fail:
+    cJSON_Delete(predicate.operand);
+    if(predicate.needle!=NULL){
+        global_hooks.deallcoate(predicate.needle);
+    }
+
+    return false;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_QuerySelect(cJSON_Query*const query,const char*path){
+    int slot=0;
+
+    if(query==NULL){
+        return false;
+    }
+    slot=query_slot(query,path);
+    if((slot<0)||!query_resize((void**)&query->projections,query->projection_count,query->projection_count+1,sizeof(int))){
+        return false;
+    }
+    query->projections[query->projection_count++]=slot;
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool)cJSON_QueryAggregate(cJSON_Query*const query,int function,const char*path){
+    static const char *const names[]={"count","sum","min","max"};
+    query_aggregate aggregate;
+
+    if((query==NULL)||(function<cJSON_QueryCount)||(function>cJSON_QueryMax)||((path==NULL)&&(function!=cJSON_QueryCount))){
+        return false;
+    }
+    aggregate.function=function;
+    aggregate.slot=-1;
+    if(path!=NULL){
+        aggregate.slot=query_slot(query,path);
+        if(aggregate.slot<0){
+            return false;
+        }
+    }
+
+    //count,or the function and its path as in "sum(/price)"
+    aggregate.name=(char*)global_hooks.allocate(strlen(names[function])+((path!=NULL)?strlen(path):0)+sizeof("()"));
+    if(aggregate.name==NULL){
+        return false;
+    }
+    if(path!=NULL){
+        sprintf(aggregate.name,"%s(%s)",names[function],path);
+    }else{
+        strcpy(aggregate.name,names[function]);
+    }
 
-    return sequence_length;
+    if(!query_resize((void**)&query->aggregates,query->aggregate_count,query->aggregate_count+1,sizeof(query_aggregate))){
+        global_hooks.deallcoate(aggregate.name);
+        return false;
+    }
+    query->aggregates[query->aggregate_count++]=aggregate;
 
-    
+    return true;
+}
 
-fail:
-    return 0;
+CJSON_PUBLIC(cJSON_bool)cJSON_QueryGroupBy(cJSON_Query*const query,const char*path){
+    int slot=0;
+
+    if(query==NULL){
+        return false;
+    }
+    slot=query_slot(query,path);
+    if(slot<0){
+        return false;
+    }
+    query->group_slot=slot;
+
+    return true;
 }
 
+CJSON_PUBLIC(void)cJSON_DeleteQuery(cJSON_Query*query){
+    size_t index=0;
 
-static cJSON_bool parse_string(cJSON*const item,parse_buffer*const input_buffer){
-    const unsigned char *input_pointer=buffer_at_offset(input_buffer)+1;
-    const unsigned char*input_end=buffer_at_offset(input_buffer)+1;
-    unsigned char *output_pointer=NULL;
-    unsigned char *output=NULL;
+    if(query==NULL){
+        return;
+    }
+    query_delete_nodes(query->root.child);
+    for(index=0;index<query->slot_count;index++){
+        global_hooks.deallcoate(query->paths[index]);
+    }
+    for(index=0;index<query->predicate_count;index++){
+        cJSON_Delete(query->predicates[index].operand);
+        if(query->predicates[index].needle!=NULL){
+            global_hooks.deallcoate(query->predicates[index].needle);
+        }
+    }
+    for(index=0;index<query->aggregate_count;index++){
+        global_hooks.deallcoate(query->aggregates[index].name);
+    }
+    if(query->paths!=NULL){
+        global_hooks.deallcoate(query->paths);
+    }
+    if(query->predicates!=NULL){
+        global_hooks.deallcoate(query->predicates);
+    }
+    if(query->projections!=NULL){
+        global_hooks.deallcoate(query->projections);
+    }
+    if(query->aggregates!=NULL){
+        global_hooks.deallcoate(query->aggregates);
+    }
+    global_hooks.deallcoate(query);
+}
 
-    if(buffer_at_offset(input_buffer)[0]!='\"'){
-        goto fail;
+/* Whether a record of length bytes can hold the string literal needle. A record
+ * with a backslash may write the value with escapes,so it always can. */
+static cJSON_bool query_may_contain(const unsigned char*const record,const size_t length,const unsigned char*const needle,const size_t needle_length){
+    unsigned char padded[BLOCK_SIZE];
+    const unsigned char *block=NULL;
+    size_t position=0;
+
+    for(position=0;position<length;position+=BLOCK_SIZE){
+        uint64_t candidates=0;
+
+        block=record+position;
+        if((length-position)<BLOCK_SIZE){
+            memset(padded,0,BLOCK_SIZE);
+            memcpy(padded,block,length-position);
+            block=padded;
+        }
+        if(equal_mask(block,'\\')!=0){
+            return true;
+        }
+
+        //candidates are the first character after the opening quote
+        for(candidates=equal_mask(block,needle[1]);candidates!=0;candidates&=candidates-1){
+            const size_t at=position+trailing_zeroes(candidates);
+            if((at>0)&&((at-1+needle_length)<=length)&&(memcmp(record+at-1,needle,needle_length)==0)){
+                return true;
+            }
+        }
     }
 
-    
-    //calculate approximate sizeof the output(overestimate)
-    size_t allocation_length=0;
-    size_t skipped_bytes=0;
-    while(((size_t)(input_end-input_buffer->content)<input_buffer->length)&&(*input_end!='\"')){
-        if(input_end[0]=='\\'){
-            if((size_t)(input_end+1-input_buffer->content)>=input_buffer->length){
-                goto fail;
+    return false;
+}
+
+//fill the slots below node from the captured tree item
+static void query_resolve(query_worker*const worker,const query_node*const node,const cJSON*const item){
+    const query_node *child=NULL;
+
+    for(child=node->child;child!=NULL;child=child->next){
+        cJSON *value=NULL;
+
+        if(cJSON_IsObject(item)){
+            value=get_object_item(item,child->name,true);
+        }else if(cJSON_IsArray(item)&&(child->index!=SIZE_MAX)){
+            value=get_array_item(item,child->index);
+        }
+        if(value==NULL){
+            continue;
+        }
+        if((child->slot>=0)&&(worker->values[child->slot]==NULL)){
+            worker->values[child->slot]=value;
+        }
+        query_resolve(worker,child,value);
+    }
+}
+
+static cJSON_bool query_walk(query_worker*const worker,const query_node*const node,parse_buffer*const input_buffer);
+
+//parse the value into the worker's storage and capture what lies below it
+static cJSON *query_capture(query_worker*const worker,const query_node*const node,parse_buffer*const input_buffer){
+    cJSON *const item=parse_new_item(input_buffer);
+
+    if((item==NULL)||!parse_value(item,input_buffer)){
+        return NULL;
+    }
+    if(node->slot>=0){
+        worker->values[node->slot]=item;
+    }
+    query_resolve(worker,node,item);
+
+    return item;
+}
+
+//the child of node named by the string that was parsed from start up to the offset
+static const query_node *query_find_member(const query_node*const node,parse_buffer*const input_buffer,const size_t start){
+    const unsigned char *name=input_buffer->content+start+1;
+    size_t length=input_buffer->offset-start-2;
+    const query_node *child=NULL;
+
+    if(memchr(name,'\\',length)!=NULL){
+        //decode the escapes,the storage is rewound with the record
+        cJSON key;
+        const size_t end=input_buffer->offset;
+
+        memset(&key,0,sizeof(key));
+        input_buffer->offset=start;
+        if(!parse_string(&key,input_buffer)){
+            input_buffer->offset=end;
+            return NULL;
+        }
+        name=(const unsigned char*)key.valuestring;
+        length=strlen(key.valuestring);
+    }
+
+    for(child=node->child;child!=NULL;child=child->next){
+        if((child->length==length)&&(memcmp(child->name,name,length)==0)){
+            return child;
+        }
+    }
+
+    return NULL;
+}
+
+//like parse_object,but only the members on query paths are looked at
+static cJSON_bool query_walk_object(query_worker*const worker,const query_node*const node,parse_buffer*const input_buffer){
+    if(input_buffer->depth>=CJSON_NESTING_LIMIT){
+        return false;//to deeply nested
+    }
+    input_buffer->depth++;
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='}')){
+        goto success;
+    }
+    if(cannot_access_at_index(input_buffer,0)){
+        input_buffer->offset--;
+        return false;
+    }
+
+    input_buffer->offset--;
+    do
+    {
+        const query_node *child=NULL;
+        size_t start=0;
+
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        start=input_buffer->offset;
+        if(cannot_access_at_index(input_buffer,0)||!parse_string(NULL,input_buffer)){
+            return false;
+        }
+        child=query_find_member(node,input_buffer,start);
+        buffer_skip_whitespace(input_buffer);
+
+        if(cannot_access_at_index(input_buffer,0)||(buffer_at_offset(input_buffer)[0]!=':')){
+            return false;
+        }
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if(!((child!=NULL)?query_walk(worker,child,input_buffer):parse_value(NULL,input_buffer))){
+            return false;
+        }
+        buffer_skip_whitespace(input_buffer);
+    }
+    while(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]==','));
+
+    if(cannot_access_at_index(input_buffer,0)||(buffer_at_offset(input_buffer)[0]!='}')){
+        return false;
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return true;
+}
+
+//like parse_array,but only the elements on query paths are looked at
+static cJSON_bool query_walk_array(query_worker*const worker,const query_node*const node,parse_buffer*const input_buffer){
+    size_t index=0;
+
+    if(input_buffer->depth>=CJSON_NESTING_LIMIT){
+        return false;//to deeply nested
+    }
+    input_buffer->depth++;
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]==']')){
+        goto success;
+    }
+    if(cannot_access_at_index(input_buffer,0)){
+        input_buffer->offset--;
+        return false;
+    }
+
+    input_buffer->offset--;
+    do
+    {
+        const query_node *child=NULL;
+
+        for(child=node->child;(child!=NULL)&&(child->index!=index);child=child->next){
+        }
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if(!((child!=NULL)?query_walk(worker,child,input_buffer):parse_value(NULL,input_buffer))){
+            return false;
+        }
+        buffer_skip_whitespace(input_buffer);
+        index++;
+    }
+    while(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]==','));
+
+    if(cannot_access_at_index(input_buffer,0)||(buffer_at_offset(input_buffer)[0]!=']')){
+        return false;
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return true;
+}
+
+static cJSON_bool query_walk(query_worker*const worker,const query_node*const node,parse_buffer*const input_buffer){
+    if((node->slot>=0)&&(worker->values[node->slot]==NULL)){
+        return query_capture(worker,node,input_buffer)!=NULL;
+    }
+    if(can_access_at_index(input_buffer,0)&&(node->child!=NULL)){
+        if(buffer_at_offset(input_buffer)[0]=='{'){
+            return query_walk_object(worker,node,input_buffer);
+        }
+        if(buffer_at_offset(input_buffer)[0]=='['){
+            return query_walk_array(worker,node,input_buffer);
+        }
+    }
+
+    return parse_value(NULL,input_buffer);
+}
+
+static cJSON_bool query_test(const query_predicate*const predicate,const cJSON*const value){
+    const cJSON *const operand=predicate->operand;
+    int order=2;//the value and the operand are not ordered
+
+    if(value==NULL){
+        return false;
+    }
+    if(predicate->operation==cJSON_QueryExists){
+        return true;
+    }
+
+    if(cJSON_IsNumber(value)&&cJSON_IsNumber(operand)){
+        const double number=number_value(value);
+        if(number<operand->valuedouble){
+            order=-1;
+        }else if(number>operand->valuedouble){
+            order=1;
+        }else if(number==operand->valuedouble){
+            order=0;
+        }
+    }else if(cJSON_IsString(value)&&cJSON_IsString(operand)){
+        order=strcmp(value->valuestring,operand->valuestring);
+        order=(order<0)?-1:((order>0)?1:0);
+    }else if(((value->type&0xFF)==(operand->type&0xFF))&&!cJSON_IsArray(value)&&!cJSON_IsObject(value)){
+        //true,false and null only equal themselves
+        return (predicate->operation==cJSON_QueryEqual)||(predicate->operation==cJSON_QueryLessEqual)||(predicate->operation==cJSON_QueryGreaterEqual);
+    }
+
+    switch(predicate->operation)
+    {
+    case cJSON_QueryEqual:
+        return order==0;
+    case cJSON_QueryNotEqual:
+        return order!=0;
+    case cJSON_QueryLess:
+        return order==-1;
+    case cJSON_QueryLessEqual:
+        return (order==-1)||(order==0);
+    case cJSON_QueryGreater:
+        return order==1;
+    case cJSON_QueryGreaterEqual:
+        return (order==1)||(order==0);
+    default:
+        return false;
+    }
+}
+
+static void query_delete_groups(query_groups*const groups){
+    size_t index=0;
+
+    for(index=0;index<groups->count;index++){
+        cJSON_Delete(groups->keys[index]);
+    }
+    if(groups->keys!=NULL){
+        global_hooks.deallcoate(groups->keys);
+    }
+    if(groups->hashes!=NULL){
+        global_hooks.deallcoate(groups->hashes);
+    }
+    if(groups->accumulators!=NULL){
+        global_hooks.deallcoate(groups->accumulators);
+    }
+    if(groups->table!=NULL){
+        global_hooks.deallcoate(groups->table);
+    }
+    memset(groups,0,sizeof(query_groups));
+}
+
+static cJSON_bool query_rehash(query_groups*const groups){
+    const size_t table_size=(groups->table_size==0)?16:(groups->table_size*2);
+    size_t *table=(size_t*)global_hooks.allocate(table_size*sizeof(size_t));
+    size_t index=0;
+
+    if(table==NULL){
+        return false;
+    }
+    memset(table,0,table_size*sizeof(size_t));
+    for(index=0;index<groups->count;index++){
+        size_t slot=(size_t)groups->hashes[index]&(table_size-1);
+        while(table[slot]!=0){
+            slot=(slot+1)&(table_size-1);
+        }
+        table[slot]=index+1;
+    }
+
+    if(groups->table!=NULL){
+        global_hooks.deallcoate(groups->table);
+    }
+    groups->table=table;
+    groups->table_size=table_size;
+
+    return true;
+}
+
+/* The accumulators of the group of key (NULL without group-by),which is added if
+ * it is new. An owned key is kept by a new group and deleted otherwise,a new group
+ * gets a copy of a key that is not owned. */
+static query_accumulator *query_group(query_groups*const groups,const size_t aggregate_count,cJSON*const key,const cJSON_bool owned){
+    const uint64_t hash=(key!=NULL)?item_digest(key):0;
+    size_t slot=0;
+    size_t index=0;
+
+    if(groups->table!=NULL){
+        for(slot=(size_t)hash&(groups->table_size-1);groups->table[slot]!=0;slot=(slot+1)&(groups->table_size-1)){
+            index=groups->table[slot]-1;
+            if((groups->hashes[index]==hash)&&((key==NULL)||compare_items(groups->keys[index],key,true))){
+                if(owned){
+                    cJSON_Delete(key);
+                }
+                return groups->accumulators+index*aggregate_count;
             }
-            skipped_bytes++;
-            input_end++;
         }
-        input_end++;
     }
-    if(((size_t)(input_end-input_buffer->content)>=input_buffer->length)||(*input_end!='\"')){
+
+    if(groups->count==groups->capacity){
+        const size_t capacity=(groups->capacity==0)?8:(groups->capacity*2);
+        if(!query_resize((void**)&groups->keys,groups->count,capacity,sizeof(cJSON*))||!query_resize((void**)&groups->hashes,groups->count,capacity,sizeof(uint64_t))||!query_resize((void**)&groups->accumulators,groups->count*aggregate_count,capacity*aggregate_count,sizeof(query_accumulator))){
+            goto fail;
+        }
+        groups->capacity=capacity;
+    }
+    //keep the table at most half full
+    if(((groups->count+1)*2>groups->table_size)&&!query_rehash(groups)){
         goto fail;
     }
 
-    allocation_length=(size_t)(input_end-buffer_at_offset(input_buffer))-skipped_bytes;
-    output=(unsigned char*)input_buffer->hooks.allocate(allocation_length+sizeof(""));
-    if(output==NULL){
-        goto fail;
+    index=groups->count;
+    groups->keys[index]=key;
+    if((key!=NULL)&&!owned){
+        groups->keys[index]=cJSON_Duplicate(key,true);
+        if(groups->keys[index]==NULL){
+            return NULL;
+        }
+    }
+    groups->hashes[index]=hash;
+    memset(groups->accumulators+index*aggregate_count,0,aggregate_count*sizeof(query_accumulator));
+    for(slot=(size_t)hash&(groups->table_size-1);groups->table[slot]!=0;slot=(slot+1)&(groups->table_size-1)){
     }
+    groups->table[slot]=index+1;
+    groups->count++;
 
+    return groups->accumulators+index*aggregate_count;
 
-    output_pointer=output;
-    while (input_pointer<input_end)
+fail:
+    if(owned){
+        cJSON_Delete(key);
+    }
+
+    return NULL;
+}
+
+static void query_accumulate(query_accumulator*const accumulator,const int function,const double number){
+    switch(function)
     {
-        if(*input_pointer!='\\'){
-            *output_pointer++ = *input_pointer++;
+    case cJSON_QuerySum:
+        accumulator->value+=number;
+        break;
+    case cJSON_QueryMin:
+        if((accumulator->count==0)||(number<accumulator->value)){
+            accumulator->value=number;
         }
-        else{
-            unsigned char sequence_length=2;
-            if((input_end-input_pointer)<1){
-                goto fail;
-            }
-            switch (input_pointer[1])
-            {
-            case 'b':
-                *output_pointer++='\b';
-                break;
-            case 'f':
-                *output_pointer++='\f';
-                break;
-            case 'n':
-                *output_pointer++='\n';
-                break;
-            case 'r':
-                *output_pointer++='\r';
-                break;
-            case 't':
-                *output_pointer++='\t';
-                break;
-            case '\"':
-            case '\\':
-            case '/':
-                *output_pointer++ = input_pointer[1];
-                break;
-            case 'u':
-            sequence_length=utf16_literal_to_uft8(input_pointer,input_end,&input_buffer);
-            if(sequence_length==0)
-            {
-                goto fail;
-            }
-                break;
-            default:
-                goto fail;
-            }
-            input_pointer+=sequence_length;
-         
+        break;
+    case cJSON_QueryMax:
+        if((accumulator->count==0)||(number>accumulator->value)){
+            accumulator->value=number;
+        }
+        break;
+    default:
+        break;
+    }
+    accumulator->count++;
+}
+
+//the row of a matching record: the whole record,or an object of the selected paths
+static cJSON *query_row(const query_worker*const worker){
+    const cJSON_Query *const query=worker->query;
+    cJSON *row=NULL;
+    size_t index=0;
+
+    if(query->projection_count==0){
+        return cJSON_Duplicate(worker->record,true);
+    }
+
+    row=cJSON_CreateObject();
+    if(row==NULL){
+        return NULL;
+    }
+    for(index=0;index<query->projection_count;index++){
+        const int slot=query->projections[index];
+        cJSON *value=NULL;
+
+        if(worker->values[slot]==NULL){
+            continue;
+        }
+        value=cJSON_Duplicate(worker->values[slot],true);
+        if((value==NULL)||!add_item_to_object(row,query->paths[slot],value,&global_hooks,false)){
+            cJSON_Delete(value);
+            cJSON_Delete(row);
+            return NULL;
+        }
+    }
+
+    return row;
+}
+
+/* Run the query over the record of length bytes at record,which ends with a '\n'
+ * if terminated. On failure the offset of the error in the record is stored. */
+static cJSON_bool query_record(query_worker*const worker,query_result*const result,const unsigned char*record,size_t length,const cJSON_bool terminated,size_t*const error_offset){
+    const cJSON_Query *const query=worker->query;
+    parse_buffer buffer={0,0,0,0,{0,0,0},0,NULL,NULL};
+    cJSON_bool rejected=false;//by the prefilter,the record is only validated
+    size_t start=0;
+    size_t index=0;
+
+    //empty lines are skipped
+    while((start<length)&&(record[start]<=32)){
+        start++;
+    }
+    if(start==length){
+        return true;
+    }
+
+    for(index=0;(index<query->predicate_count)&&!rejected;index++){
+        const query_predicate *const predicate=&query->predicates[index];
+        if((predicate->needle!=NULL)&&!query_may_contain(record+start,length-start,(const unsigned char*)predicate->needle,predicate->needle_length)){
+            rejected=true;
+        }
+    }
+
+    parser_rewind(worker->storage);
+    memset(worker->values,0,query->slot_count*sizeof(cJSON*));
+    if(!terminated){
+        //the parser has to see where the last record ends
+        unsigned char *const copy=(unsigned char*)parser_allocate(worker->storage,length+1);
+        if(copy==NULL){
+            *error_offset=start;
+            return false;
+        }
+        memcpy(copy,record,length);
+        copy[length++]='\n';
+        record=copy;
+    }
+
+    buffer.content=record;
+    buffer.length=length;
+    buffer.offset=start;
+    buffer.hooks=global_hooks;
+    buffer.flags=query->flags;
+    buffer.parser=worker->storage;
+
+    if(rejected){
+        if(!parse_value(NULL,&buffer)){
+            goto fail;
+        }
+    }else if((query->aggregate_count==0)&&(query->projection_count==0)){
+        worker->record=query_capture(worker,&query->root,&buffer);
+        if(worker->record==NULL){
+            goto fail;
+        }
+    }else if(!query_walk(worker,&query->root,&buffer)){
+        goto fail;
+    }
+    //only whitespace may follow on the line
+    while((buffer.offset<length)&&(buffer_at_offset(&buffer)[0]<=32)){
+        buffer.offset++;
+    }
+    if(buffer.offset<length){
+        goto fail;
+    }
+    if(rejected){
+        return true;
+    }
+
+    for(index=0;index<query->predicate_count;index++){
+        if(!query_test(&query->predicates[index],worker->values[query->predicates[index].slot])){
+            return true;
         }
+    }
+
+    if(query->aggregate_count>0){
+        cJSON *key=NULL;
+        query_accumulator *accumulators=NULL;
 
+        if(query->group_slot>=0){
+            key=(worker->values[query->group_slot]!=NULL)?worker->values[query->group_slot]:&worker->null_key;
+        }
+        accumulators=query_group(&result->groups,query->aggregate_count,key,false);
+        if(accumulators==NULL){
+            *error_offset=start;
+            return false;
+        }
+        for(index=0;index<query->aggregate_count;index++){
+            const query_aggregate *const aggregate=&query->aggregates[index];
+            const cJSON *const value=(aggregate->slot>=0)?worker->values[aggregate->slot]:NULL;
+
+            if(aggregate->function==cJSON_QueryCount){
+                if((aggregate->slot<0)||((value!=NULL)&&!cJSON_IsNULL(value))){
+                    accumulators[index].count++;
+                }
+            }else if(cJSON_IsNumber(value)){
+                query_accumulate(&accumulators[index],aggregate->function,number_value(value));
+            }
+        }
+    }else{
+        cJSON *const row=query_row(worker);
+        if((row==NULL)||!add_item_to_array(result->rows,row)){
+            cJSON_Delete(row);
+            *error_offset=start;
+            return false;
+        }
     }
-       *output_pointer='\0';
 
-        item->type=cJSON_String;
-        item->valuestring=(char*)output;
-        input_buffer->offset=(size_t)(input_end-input_buffer->content);
-        input_buffer->offset++;
-        return true;
-    
+    return true;
 
 fail:
-    if(output!=NULL){
-        input_buffer->hooks.deallcoate(output);
-    }
-    if(input_buffer!=NULL){
-        input_buffer->offset=(size_t)(input_pointer-input_buffer->content);
-    }
+    *error_offset=(buffer.offset<length)?buffer.offset:(length-1);
 
-    
     return false;
-
 }
 
-//Render the cstring provided to an secaped version that can be printed
-static cJSON_bool print_string_ptr(const unsigned char* const input,printbuffer*const output_buffer){
-    const unsigned char* input_pointer=NULL;
-    unsigned char* output=NULL;
-    unsigned char* output_pointer=NULL;
-    size_t output_length=0;
-
-    //numbers of additional characters needed for escaping
-    //即需要避免的额外的词汇
-    size_t escape_characters=0;
+static void query_run_range(query_worker*const worker,const query_job*const job,query_range*const range){
+    size_t position=range->start;
 
-    if(output_buffer==NULL){
-        return  false;
+    range->result.rows=cJSON_CreateArray();
+    if(range->result.rows==NULL){
+        range->error_offset=job->base+position;
+        return;
     }
 
-    //empty string
-    if(input==NULL){
-        output=ensure(output_buffer,sizeof("\"\""));
-        if(output==NULL){
-            return false;
+    while(position<range->end){
+        const unsigned char *const record=job->content+position;
+        const unsigned char *const newline=(const unsigned char*)memchr(record,'\n',range->end-position);
+        const size_t length=(newline!=NULL)?(size_t)(newline-record+1):(range->end-position);
+        size_t error_offset=0;
+
+        if(!query_record(worker,&range->result,record,length,newline!=NULL,&error_offset)){
+            range->error_offset=job->base+position+error_offset;
+            return;
         }
-        strcpy((char*)output,"\"\"");
-        return true;
+        position+=length;
     }
-    
-    for(input_pointer=input;*input_pointer;*input_pointer++){
-        switch (*input_pointer)
-        {
-        case '\"':
-        case '\\':
-        case '\b':
-        case '\f':
-        case '\n':
-        case '\r':
-        case '\t':
-            escape_characters++;
-            break;
-        
-        default:
-            //若ASCII值小于32，即无法找到对应的字符类型组成字符串
-            if(*input_pointer<32){
-                //utf16 escape sequence uXXXX
-                escape_characters+=5;
-            }
+}
+
+static void query_ranges(void*argument){
+    query_job *const job=(query_job*)argument;
+    query_worker worker;
+
+    memset(&worker,0,sizeof(worker));
+    worker.query=job->query;
+    worker.null_key.type=cJSON_NULL;
+    worker.storage=cJSON_CreateParser(0,job->query->flags);
+    worker.values=(cJSON**)global_hooks.allocate((job->query->slot_count+1)*sizeof(cJSON*));
+
+    for(;;){
+        const size_t range=atomic_add_size(&job->next_range,1)-1;
+
+        if(range>=job->range_count){
             break;
         }
+        if((worker.storage==NULL)||(worker.values==NULL)){
+            job->ranges[range].error_offset=job->base+job->ranges[range].start;
+            continue;
+        }
+        query_run_range(&worker,job,&job->ranges[range]);
     }
-    //以上确定输出长度
-    output_length=(size_t)(input_pointer-input)+escape_characters;
 
-    output=ensure(output_buffer,output_length+sizeof("\"\""));
-    if(output==NULL){
-        return false;
+    cJSON_DeleteParser(worker.storage);
+    if(worker.values!=NULL){
+        global_hooks.deallcoate(worker.values);
     }
+}
 
-    //没有字符需要被跳过
-    if(escape_characters==0){
-        output[0]='\"';
-        memcpy(output+1,input,output_length);
-        output[output_length+1]='\"';
-        output[output_length+2]='\0';
-        return true;
+//add the rows and groups of a range to the result,which takes them over
+static cJSON_bool query_merge(const cJSON_Query*const query,query_result*const result,query_result*const partial){
+    size_t group=0;
+    size_t index=0;
+
+    if((partial->rows!=NULL)&&(partial->rows->child!=NULL)){
+        cJSON *const chain=partial->rows->child;
+        partial->rows->child=NULL;
+        add_chain_to_array(result->rows,chain,false);
     }
 
-    output[0]='\"';
-    output_pointer=output+1;
+    for(group=0;group<partial->groups.count;group++){
+        const query_accumulator *const from=partial->groups.accumulators+group*query->aggregate_count;
+        query_accumulator *const to=query_group(&result->groups,query->aggregate_count,partial->groups.keys[group],true);
 
-    for(input_pointer=input;*input_pointer!='\0';(void)input_pointer++,output_pointer++){
-        if((*input_pointer>31)&&(*input_pointer!='\"')&&(*input_pointer!='\\')){
-            *output_pointer=*input_pointer;
+        //the result kept or deleted the key
+        partial->groups.keys[group]=NULL;
+        if(to==NULL){
+            return false;
         }
-        else{
-            *output_pointer++ ='\\';
-            switch (*input_pointer)
-            {
-            case '\\':
-                *output_pointer='\\';
-                break;
-            case '\"':
-                *output_pointer='\"';
-                break;
-            case '\b':
-                *output_pointer='b';
-                break;
-            case '\f':
-                *output_pointer='f';
-                break;
-            case '\n':
-                *output_pointer='n';
-                break;
-            case '\r':
-                *output_pointer='r';
-                break;
-            case '\t':
-                *output_pointer='t';
-                break;
-            default:
-                sprintf((char*)output_pointer,"u%04x",*input_pointer);
-                output_pointer+=4;
-                break;
+
+        for(index=0;index<query->aggregate_count;index++){
+            if(from[index].count==0){
+                continue;
+            }
+            if(query->aggregates[index].function==cJSON_QueryCount){
+                to[index].count+=from[index].count;
+            }else if(to[index].count==0){
+                to[index]=from[index];
+            }else{
+                //combine the two as one value,then count all of them
+                query_accumulate(&to[index],query->aggregates[index].function,from[index].value);
+                to[index].count+=from[index].count-1;
             }
         }
     }
 
-    output[output_length+1]='\"';
-    output[output_length+2]='\0';
     return true;
 }
 
-static cJSON_bool print_string(const cJSON*const item,printbuffer*const p){
-    return print_string_ptr((unsigned*)item->valuestring,p);
+static void query_delete_result(query_result*const result){
+    cJSON_Delete(result->rows);
+    result->rows=NULL;
+    query_delete_groups(&result->groups);
 }
 
-//Predeclare these prototypes
-static cJSON_bool parse_value(cJSON*const item,parse_buffer*const input_buffer);
-static cJSON_bool print_value(const cJSON *const item,printbuffer*const output_buffer);
-static cJSON_bool parse_array(cJSON*const item,parse_buffer *const input_buffer);
-static cJSON_bool print_array(const cJSON*const item,printbuffer*const output_buffer);
-static cJSON_bool parse_object(cJSON*const item,parse_buffer*const input_buffer);
-static cJSON_bool print_object(const cJSON*const item,printbuffer *const output_buffer);
+/* Run the query over the records in length bytes at content,which start at base
+ * in the input,and add what they yield to result. */
+static cJSON_bool query_run(const cJSON_Query*const query,query_result*const result,const unsigned char*const content,const size_t length,const size_t base,const int threads,size_t*const error_offset){
+    query_job job;
+    size_t range=0;
+    size_t range_count=1;
+    cJSON_bool success=true;
+
+    memset(&job,0,sizeof(job));
+    job.query=query;
+    job.content=content;
+    job.base=base;
+#if defined(CJSON_PARALLEL)
+    if(threads>1){
+        range_count=cjson_min((size_t)threads*4,length/CJSON_QUERY_MIN_RANGE);
+        if(range_count==0){
+            range_count=1;
+        }
+    }
+#else
+    (void)threads;
+#endif
 
-static parse_buffer *buffer_skip_whitespace(parse_buffer*const buffer){
-    if((buffer==NULL)||(buffer->content==NULL)){
-        return NULL;
+    job.ranges=(query_range*)global_hooks.allocate(range_count*sizeof(query_range));
+    if(job.ranges==NULL){
+        *error_offset=base;
+        return false;
     }
-    //将offset指针移动至第一个字符的位置
-    while (can_access_at_index(buffer,0)&&(buffer_at_offset(buffer)[0]<=32))
-    {
-        buffer->offset++;
+    memset(job.ranges,0,range_count*sizeof(query_range));
+    job.range_count=range_count;
+
+    //every range but the last ends behind a '\n',so no record is split
+    for(range=0;range<range_count;range++){
+        const size_t start=(range==0)?0:job.ranges[range-1].end;
+        size_t end=length;
+
+        if(range+1<range_count){
+            const unsigned char *newline=NULL;
+            end=length/range_count*(range+1);
+            if(end<start){
+                end=start;
+            }
+            newline=(const unsigned char*)memchr(content+end,'\n',length-end);
+            end=(newline!=NULL)?(size_t)(newline-content+1):length;
+        }
+        job.ranges[range].start=start;
+        job.ranges[range].end=end;
+        job.ranges[range].error_offset=SIZE_MAX;
     }
 
-    if(buffer->offset==buffer->length){
-        buffer->offset--;
+#if defined(CJSON_PARALLEL)
+    parallel_run(query_ranges,&job,cjson_min((size_t)((threads>1)?threads:1),range_count));
+#else
+    query_ranges(&job);
+#endif
+
+    for(range=0;range<range_count;range++){
+        if(job.ranges[range].error_offset!=SIZE_MAX){
+            //the first error in the input,as a serial run would report it
+            *error_offset=job.ranges[range].error_offset;
+            success=false;
+            break;
+        }
+        if(!query_merge(query,result,&job.ranges[range].result)){
+            *error_offset=base+job.ranges[range].start;
+            success=false;
+            break;
+        }
     }
 
-    return buffer;
-    
+    for(range=0;range<range_count;range++){
+        query_delete_result(&job.ranges[range].result);
+    }
+    global_hooks.deallcoate(job.ranges);
+
+    return success;
 }
 
-//skip the utf8 bom(byte order mark) if it is at the beginning of a buffer
-static parse_buffer *skip_utf8_bom(parse_buffer*const buffer){
-    if((buffer==NULL)||(buffer->content==NULL)||(buffer->offset!=0)){
-        return NULL;
+//the rows,the aggregates or the groups with their aggregates
+static cJSON *query_output(const cJSON_Query*const query,query_result*const result){
+    cJSON *output=NULL;
+    size_t group=0;
+    size_t index=0;
+
+    if(query->aggregate_count==0){
+        output=result->rows;
+        result->rows=NULL;
+        return output;
     }
-    //\xEF\xBF\xBB即bom文件的标记，用来指出这个文件是UTF8编码
-    if(can_access_at_index(buffer,4)&&(strncmp((const char *)buffer_at_offset(buffer),"\xEF\xBB\xBF",3)==0)){
-        buffer->offset+=3;
+
+    //aggregates over no records at all
+    if((query->group_slot<0)&&(result->groups.count==0)&&(query_group(&result->groups,query->aggregate_count,NULL,false)==NULL)){
+        return NULL;
     }
 
-    return buffer;
-}
+    if(query->group_slot>=0){
+        output=cJSON_CreateArray();
+        if(output==NULL){
+            return NULL;
+        }
+    }
+    for(group=0;group<result->groups.count;group++){
+        const query_accumulator *const accumulators=result->groups.accumulators+group*query->aggregate_count;
+        cJSON *const object=cJSON_CreateObject();
 
-//Parse an object -create a new root ,and populate
-CJSON_PUBLIC(cJSON*) cJSON_ParseWithOpts(const char*value,const char**return_parse_end,cJSON_bool require_null_terminated){
-    parse_buffer buffer={0,0,0,0,{0,0,0}};
-    cJSON *item=NULL;
+        if(object==NULL){
+            goto fail;
+        }
+        if(query->group_slot>=0){
+            if(!add_item_to_object(object,"key",result->groups.keys[group],&global_hooks,false)){
+                cJSON_Delete(object);
+                goto fail;
+            }
+            result->groups.keys[group]=NULL;
+            if(!add_item_to_array(output,object)){
+                cJSON_Delete(object);
+                goto fail;
+            }
+        }else{
+            output=object;
+        }
 
-    //reset error position
-    global_error.json=NULL;
-    global_error.position=0;
+        for(index=0;index<query->aggregate_count;index++){
+            cJSON *value=NULL;
 
-    if(value==NULL){
-        goto fail;
+            if(query->aggregates[index].function==cJSON_QueryCount){
+                value=cJSON_CreateNumber((double)accumulators[index].count);
+            }else if(accumulators[index].count==0){
+                value=cJSON_CreateNull();
+            }else{
+                value=cJSON_CreateNumber(accumulators[index].value);
+            }
+            if((value==NULL)||!add_item_to_object(object,query->aggregates[index].name,value,&global_hooks,false)){
+                cJSON_Delete(value);
+                goto fail;
+            }
+        }
     }
 
-    buffer.content=(const unsigned char*)value;
-    buffer.length=strlen((const char*)value)+sizeof("");
-    buffer.offset=0;
-    buffer.hooks=global_hooks;
+    return output;
 
-    item=cJSON_NEW_Item(&global_hooks);
-    if(item==NULL)
-    {
+fail:
+    cJSON_Delete(output);
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*)cJSON_QueryRun(const cJSON_Query*const query,const char*json,size_t length,int threads,size_t*error_offset){
+    query_result result;
+    cJSON *output=NULL;
+    size_t error=0;
+
+    memset(&result,0,sizeof(result));
+    if((query==NULL)||((json==NULL)&&(length>0))){
         goto fail;
     }
-
-    if(!parse_value(item,buffer_skip_whitespace(skip_utf8_bom(&buffer)))){
-        
+    result.rows=cJSON_CreateArray();
+    if(result.rows==NULL){
         goto fail;
     }
 
-    //if we require null-terminated JSON without appended garbage ,skip and then check fo a null terminator
-    if(require_null_terminated){
-        buffer_skip_whitespace(&buffer);
-        if((buffer.offset>=buffer.length)||buffer_at_offset(&buffer)[0]!='\0'){
-            goto fail;
-        }
+    if(!query_run(query,&result,(const unsigned char*)json,length,0,threads,&error)){
+        goto fail;
+    }
+    output=query_output(query,&result);
+    if(output==NULL){
+        goto fail;
     }
+    query_delete_result(&result);
 
-    if(return_parse_end){
-        *return_parse_end=(const char*)buffer_at_offset(&buffer);
+    return output;
+
+fail:
+    query_delete_result(&result);
+    if(error_offset!=NULL){
+        *error_offset=error;
     }
 
-    return item;
+    return NULL;
+}
 
+CJSON_PUBLIC(cJSON*)cJSON_QueryRunReader(const cJSON_Query*const query,cJSON_StreamReader read,void*context,int threads,size_t*error_offset){
+    query_result result;
+    cJSON *output=NULL;
+    unsigned char *window=NULL;
+    size_t capacity=CJSON_QUERY_WINDOW;
+    size_t length=0;
+    size_t base=0;//offset of the window in the input
+    size_t error=0;
+    cJSON_bool end_of_input=false;
 
-fail:
-    if(item!=NULL){
-        cJSON_Delete(item);
+    memset(&result,0,sizeof(result));
+    if((query==NULL)||(read==NULL)){
+        goto fail;
+    }
+    result.rows=cJSON_CreateArray();
+    window=(unsigned char*)global_hooks.allocate(capacity);
+    if((result.rows==NULL)||(window==NULL)){
+        goto fail;
     }
-    
-    if(value!=NULL){
-        error local_error;
-        local_error.json=(const unsigned char*)value;
-        local_error.position=0;
 
-        if(buffer.offset<buffer.length){
-            local_error.position=buffer.offset;
+    while(!end_of_input||(length>0)){
+        size_t complete=0;
+
+        while(!end_of_input&&(length<capacity)){
+            const size_t received=read(context,(char*)window+length,capacity-length);
+            if(received==(size_t)-1){
+                error=base+length;
+                goto fail;
+            }
+            if(received==0){
+                end_of_input=true;
+            }
+            length+=received;
         }
-        else if(buffer.length>0){
-            local_error.position=buffer.length-1;
+
+        //the records up to the last '\n',all that is left at the end of the input
+        complete=length;
+        if(!end_of_input){
+            while((complete>0)&&(window[complete-1]!='\n')){
+                complete--;
+            }
         }
-        if(return_parse_end!=NULL){
-            *return_parse_end=(const char *)local_error.json+local_error.position;
+        if(complete==0){
+            //a record longer than the window
+            unsigned char *grown=NULL;
+            if(global_hooks.realloccate!=NULL){
+                grown=(unsigned char*)global_hooks.realloccate(window,capacity*2);
+            }else{
+                grown=(unsigned char*)global_hooks.allocate(capacity*2);
+                if(grown!=NULL){
+                    memcpy(grown,window,length);
+                    global_hooks.deallcoate(window);
+                }
+            }
+            if(grown==NULL){
+                error=base+length;
+                goto fail;
+            }
+            window=grown;
+            capacity*=2;
+            continue;
+        }
+
+        if(!query_run(query,&result,window,complete,base,threads,&error)){
+            goto fail;
         }
-        global_error=local_error;
+        memmove(window,window+complete,length-complete);
+        length-=complete;
+        base+=complete;
     }
 
-    return NULL;
+    output=query_output(query,&result);
+    if(output==NULL){
+        goto fail;
+    }
+    query_delete_result(&result);
+    global_hooks.deallcoate(window);
+
+    return output;
 
+fail:
+    query_delete_result(&result);
+    if(window!=NULL){
+        global_hooks.deallcoate(window);
+    }
+    if(error_offset!=NULL){
+        *error_offset=error;
+    }
 
+    return NULL;
 }
 
+/* Columns extracted from an array of objects. The paths of the columns form a
+ * query tree,each element of the array is walked along it like a record of a
+ * query and the values found are appended to the column buffers in the layout
+ * of Apache Arrow: a validity bitmap,then fixed width values or string offsets
+ * and data. Numbers are kept as text until a column converts them,so int64
+ * columns keep every digit. */
+typedef struct
+{
+    int type;
+    int slot;
+    unsigned char *validity;
+    size_t validity_capacity;//in bytes,like the other capacities
+    unsigned char *values;//double,long long,a bit per row or length+1 string offsets
+    size_t values_capacity;
+    char *data;
+    size_t data_length;
+    size_t data_capacity;
+    size_t null_count;
+}column_buffer;
+
+struct cJSON_Columns
+{
+    cJSON_Query *query;
+    column_buffer *columns;
+    size_t column_count;
+    size_t rows;
+    cJSON_ColumnMismatch *mismatches;
+    size_t mismatch_count;
+    size_t mismatch_capacity;
+    query_worker worker;
+    size_t value_count;//slots the worker's values have room for
+};
+
+//grow a zeroed buffer of *capacity bytes to hold needed bytes
+static cJSON_bool column_reserve(void**const buffer,size_t*const capacity,const size_t needed){
+    size_t grown=(*capacity>0)?*capacity:64;
+
+    if(needed<=*capacity){
+        return true;
+    }
+    while(grown<needed){
+        if(grown>(SIZE_MAX/2)){
+            return false;
+        }
+        grown*=2;
+    }
+    if(!query_resize(buffer,*capacity,grown,1)){
+        return false;
+    }
+    memset((unsigned char*)*buffer+*capacity,0,grown-*capacity);
+    *capacity=grown;
 
-CJSON_PUBLIC(cJSON*)cJSON_Parse(const char *value){
-    return cJSON_ParseWithOpts(value,0,0);
+    return true;
 }
 
-#define cjson_min(a,b) ((a<b)?a:b)
-
-static unsigned char*print(const cJSON* const item,cJSON_bool format,const internal_hooks*const hooks){
-    static const size_t default_buffer_size=256;
-    printbuffer buffer[1];
-    unsigned char*printed=NULL;
-    //memset 将一段内存空间全部设置为某个字符
-    memset(buffer,0,sizeof(buffer));
-    
-    //create buffer
-    buffer->buffer=(unsigned char*)hooks->allocate(default_buffer_size);
-    buffer->length=default_buffer_size;
-    buffer->format=format;
-    buffer->hooks=*hooks;
-    if(buffer->buffer==NULL){
-        goto fail;
+static void column_set_bit(unsigned char*const bitmap,const size_t index,const cJSON_bool set){
+    if(set){
+        bitmap[index/8]|=(unsigned char)(1U<<(index%8));
+    }else{
+        bitmap[index/8]&=(unsigned char)~(1U<<(index%8));
     }
+}
 
-    if(!print_value(item,buffer)){
-        goto fail;
+//append value (NULL if the row has none) to the column as row,false if memory ran out
+static cJSON_bool column_append(cJSON_Columns*const columns,const size_t index,const size_t row,const cJSON*const value){
+    column_buffer *const column=&columns->columns[index];
+    cJSON_bool valid=false;
+    size_t needed=0;
+
+    if(!column_reserve((void**)&column->validity,&column->validity_capacity,row/8+1)){
+        return false;
+    }
+    switch(column->type)
+    {
+    case cJSON_ColumnBool:
+        needed=row/8+1;
+        break;
+    case cJSON_ColumnString:
+        needed=(row+2)*sizeof(long long);
+        break;
+    default:
+        needed=(row+1)*sizeof(double);
+        break;
+    }
+    if(!column_reserve((void**)&column->values,&column->values_capacity,needed)){
+        return false;
     }
-    update_offset(buffer);
 
-    if(hooks->realloccate!=NULL){
-        printed=(unsigned char*)hooks->realloccate(buffer->buffer,buffer->offset+1);
-        if(printed==NULL){
-            goto fail;
+    switch(column->type)
+    {
+    case cJSON_ColumnDouble:
+    {
+        double number=0;
+        if(cJSON_IsNumber(value)){
+            number=number_value(value);
+            valid=true;
         }
-        buffer->buffer=NULL;
+        memcpy(column->values+row*sizeof(double),&number,sizeof(double));
+        break;
     }
-    else
+    case cJSON_ColumnInt64:
     {
-        printed=(unsigned char*)hooks->allocate(buffer->offset+1);
-        if(printed==NULL){
-            goto fail;
+        long long number=0;
+        valid=cJSON_GetInt64Value(value,&number);
+        if(!valid){
+            number=0;
         }
-        memcpy(printed,buffer->buffer,cjson_min(buffer->length,buffer->offset+1));
-        printed[buffer->offset]='\0';
-
-        hooks->deallcoate(buffer->buffer);
+        memcpy(column->values+row*sizeof(long long),&number,sizeof(long long));
+        break;
     }
-
-    return printed;
-    
-
-fail:
-    if(buffer->buffer!=NULL){
-        hooks->deallcoate(buffer->buffer);
+    case cJSON_ColumnBool:
+        valid=cJSON_IsBool(value);
+        column_set_bit(column->values,row,valid&&cJSON_IsTrue(value));
+        break;
+    case cJSON_ColumnString:
+    {
+        long long *const offsets=(long long*)column->values;
+        if(cJSON_IsString(value)){
+            const size_t length=strlen(value->valuestring);
+            if(!column_reserve((void**)&column->data,&column->data_capacity,column->data_length+length)){
+                return false;
+            }
+            memcpy(column->data+column->data_length,value->valuestring,length);
+            column->data_length+=length;
+            valid=true;
+        }
+        offsets[row+1]=(long long)column->data_length;
+        break;
+    }
+    default:
+        break;
+    }
+    column_set_bit(column->validity,row,valid);
+    if(valid){
+        return true;
     }
 
-    if(printed!=NULL){
-        hooks->deallcoate(printed);
+    column->null_count++;
+    if((value!=NULL)&&!cJSON_IsNULL(value)){
+        //a value of another type is a null that is reported
+        if(columns->mismatch_count==columns->mismatch_capacity){
+            const size_t capacity=(columns->mismatch_capacity>0)?columns->mismatch_capacity*2:16;
+            if(!query_resize((void**)&columns->mismatches,columns->mismatch_count,capacity,sizeof(cJSON_ColumnMismatch))){
+                return false;
+            }
+            columns->mismatch_capacity=capacity;
+        }
+        columns->mismatches[columns->mismatch_count].row=row;
+        columns->mismatches[columns->mismatch_count].column=index;
+        columns->mismatches[columns->mismatch_count].type=value->type&0xFF;
+        columns->mismatch_count++;
     }
-    return NULL;                                           
-}
 
-CJSON_PUBLIC(char*)cJSON_Print(const cJSON*item){
-    return (char *)print(item,true,&global_hooks);
+    return true;
 }
 
-CJSON_PUBLIC(char*)cJSON_PrintUnformatted(const cJSON*item){
-    return (char*)print(item,false,&global_hooks);
+//drop the rows from rows on,as after a failed extraction
+static void columns_truncate(cJSON_Columns*const columns,const size_t rows,const size_t mismatch_count){
+    size_t index=0;
+
+    for(index=0;index<columns->column_count;index++){
+        column_buffer *const column=&columns->columns[index];
+        size_t row=0;
+
+        column->null_count=0;
+        for(row=0;row<rows;row++){
+            if((column->validity[row/8]&(1U<<(row%8)))==0){
+                column->null_count++;
+            }
+        }
+        if(column->type==cJSON_ColumnString){
+            column->data_length=(rows>0)?(size_t)((const long long*)column->values)[rows]:0;
+        }
+    }
+    columns->rows=rows;
+    columns->mismatch_count=mismatch_count;
 }
 
-CJSON_PUBLIC(char*)cJSON_PrintBuffered(const cJSON *item,int prebuffer,cJSON_bool fmt){
-    printbuffer p={0,0,0,0,0,0,{0,0,0}};
-    if(prebuffer<0){
+CJSON_PUBLIC(cJSON_Columns*)cJSON_CreateColumns(int flags){
+    cJSON_Columns *columns=(cJSON_Columns*)global_hooks.allocate(sizeof(cJSON_Columns));
+    if(columns==NULL){
         return NULL;
     }
-    p.buffer=(unsigned char*)global_hooks.allocate((size_t)prebuffer);
-    if(!p.buffer){
-        return NULL;
+    memset(columns,0,sizeof(cJSON_Columns));
+
+    columns->query=cJSON_CreateQuery(flags);
+    if(columns->query==NULL){
+        goto fail;
+    }
+    //numbers are converted by the column they go to
+    columns->query->flags|=cJSON_ParseLazyNumbers;
+    columns->worker.query=columns->query;
+    columns->worker.storage=cJSON_CreateParser(0,columns->query->flags);
+    if(columns->worker.storage==NULL){
+        goto fail;
     }
 
-    p.length=(size_t)prebuffer;
-    p.offset=0;
-    p.noalloc=false;
-    p.format=fmt;
-    p.hooks=global_hooks;
+    return columns;
 
-    if(!print_value(item,&p)){
-        global_hooks.deallcoate(p.buffer);
-        return NULL;
-    }
+fail:
+    cJSON_DeleteColumns(columns);
 
-    return (char*)p.buffer;
+    return NULL;
 }
 
-CJSON_PUBLIC(cJSON_bool)cJSON_PrintPreallocated(cJSON*item,char *buf,const int len,const cJSON_bool fmt){
-     printbuffer p={0,0,0,0,0,0,{0,0,0}};
-     if((len<0)||(buf==NULL)){
-         return false;
-     }
+CJSON_PUBLIC(int)cJSON_ColumnsAdd(cJSON_Columns*const columns,const char*path,int type){
+    column_buffer *column=NULL;
+    int slot=-1;
 
-     p.buffer=(unsigned char*)buf;
-     p.length=(size_t)len;
-     p.offset=0;
-     p.format=fmt;
-     p.hooks=global_hooks;
+    if((columns==NULL)||(type<cJSON_ColumnDouble)||(type>cJSON_ColumnBool)){
+        return -1;
+    }
+    //columns added later would be short of the rows already extracted
+    if((columns->rows>0)||(columns->column_count>=INT_MAX)){
+        return -1;
+    }
+    slot=query_slot(columns->query,path);
+    if((slot<0)||!query_resize((void**)&columns->columns,columns->column_count,columns->column_count+1,sizeof(column_buffer))){
+        return -1;
+    }
 
-     return print_value(item,&p);
+    column=&columns->columns[columns->column_count];
+    memset(column,0,sizeof(column_buffer));
+    column->type=type;
+    column->slot=slot;
+
+    return (int)columns->column_count++;
 }
 
-//Parser core -when encountering text,process appropriately
-static cJSON_bool parse_value(cJSON*const item,parse_buffer *const input_buffer){
-    if((input_buffer==NULL)||(input_buffer->content==NULL)){
+CJSON_PUBLIC(cJSON_bool)cJSON_ColumnsExtract(cJSON_Columns*const columns,const char*json,size_t length,size_t*error_offset){
+    parse_buffer buffer={0,0,0,0,{0,0,0},0,NULL,NULL};
+    query_worker *worker=NULL;
+    const size_t rows=(columns!=NULL)?columns->rows:0;
+    const size_t mismatch_count=(columns!=NULL)?columns->mismatch_count:0;
+    size_t index=0;
+
+    if((columns==NULL)||(json==NULL)||(length==0)){
+        if(error_offset!=NULL){
+            *error_offset=0;
+        }
         return false;
     }
+    worker=&columns->worker;
 
-    //parse the different types of values
-    //NULL
-    if(can_read(input_buffer,4)&&(strncmp((const char*)buffer_at_offset(input_buffer),"null",4)==0)){
-        item->type=cJSON_NULL;
-        input_buffer->offset+=4;
-        return true;
+    if(columns->value_count<columns->query->slot_count){
+        if(worker->values!=NULL){
+            global_hooks.deallcoate(worker->values);
+            worker->values=NULL;
+        }
+        if(!query_resize((void**)&worker->values,0,columns->query->slot_count,sizeof(cJSON*))){
+            columns->value_count=0;
+            goto fail;
+        }
+        columns->value_count=columns->query->slot_count;
     }
 
-    //false
-    if(can_read(input_buffer,5)&&(strcmp((const char*)buffer_at_offset(input_buffer),"false",5)==0)){
-        item->type=cJSON_False;
-        input_buffer->offset+=5;
-        return true;
+    buffer.content=(const unsigned char*)json;
+    buffer.length=length;
+    buffer.hooks=global_hooks;
+    buffer.flags=columns->query->flags;
+    buffer.parser=worker->storage;
+
+    buffer_skip_whitespace(&buffer);
+    if(cannot_access_at_index(&buffer,0)||(buffer_at_offset(&buffer)[0]!='[')){
+        goto fail;
+    }
+    //like parse_array,but each element is walked and appended as a row
+    buffer.depth++;
+    buffer.offset++;
+    buffer_skip_whitespace(&buffer);
+    if(can_access_at_index(&buffer,0)&&(buffer_at_offset(&buffer)[0]==']')){
+        goto success;
+    }
+    if(cannot_access_at_index(&buffer,0)){
+        goto fail;
     }
 
-    //true
-    if(can_read(input_buffer,4)&&(strcmp((const char*)buffer_at_offset(input_buffer),"true",4)==0)){
-        item->type=cJSON_True;
-        item->valueint=1;
-        input_buffer->offset+=4;
-        return true;
+    buffer.offset--;
+    do
+    {
+        buffer.offset++;
+        buffer_skip_whitespace(&buffer);
+        parser_rewind(worker->storage);
+        if(worker->values!=NULL){
+            memset(worker->values,0,columns->query->slot_count*sizeof(cJSON*));
+        }
+        if(!query_walk(worker,&columns->query->root,&buffer)){
+            goto fail;
+        }
+        for(index=0;index<columns->column_count;index++){
+            if(!column_append(columns,index,columns->rows,worker->values[columns->columns[index].slot])){
+                goto fail;
+            }
+        }
+        columns->rows++;
+        buffer_skip_whitespace(&buffer);
     }
+    while(can_access_at_index(&buffer,0)&&(buffer_at_offset(&buffer)[0]==','));
 
-    //string
-    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='\"')){
-        return parse_string(item,input_buffer);
+    if(cannot_access_at_index(&buffer,0)||(buffer_at_offset(&buffer)[0]!=']')){
+        goto fail;
     }
 
-    //number
-    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='-')&&(buffer_at_offset(input_buffer)[0]>='0')&&(buffer_at_offset(input_buffer)[0]<='9')){
-        return parse_number(item,input_buffer);
+success:
+    buffer.offset++;
+    //only whitespace may follow the array
+    while((buffer.offset<length)&&(buffer_at_offset(&buffer)[0]<=32)){
+        buffer.offset++;
     }
+    if(buffer.offset<length){
+        goto fail;
+    }
+    parser_rewind(worker->storage);
 
-    //array
-    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='[')){
+    return true;
 
-        return parse_array(item,input_buffer);
-    }
-    
-    //object
-    if(can_access_at_index(input_buffer,0)&&(buffer_at_offset(input_buffer)[0]=='{')){
-        return parse_object(item,input_buffer);
+fail:
+    columns_truncate(columns,rows,mismatch_count);
+    parser_rewind(worker->storage);
+    if(error_offset!=NULL){
+        *error_offset=(buffer.offset<length)?buffer.offset:length;
     }
 
     return false;
 }
 
-//Render a value to text
+CJSON_PUBLIC(size_t)cJSON_ColumnsRows(const cJSON_Columns*const columns){
+    return (columns!=NULL)?columns->rows:0;
+}
 
-static cJSON_bool print_value(const cJSON* const item ,printbuffer *const output_buffer){
-    unsigned char *output=NULL;
+CJSON_PUBLIC(cJSON_bool)cJSON_ColumnsGet(const cJSON_Columns*const columns,size_t index,cJSON_Column*column){
+    const column_buffer *buffer=NULL;
 
-    if((item==NULL)||(output_buffer==NULL)){
+    if((columns==NULL)||(column==NULL)||(index>=columns->column_count)){
         return false;
     }
-
-    switch ((item->type)&0xFF)
-    {
-    case cJSON_NULL:
-        output=ensure(output_buffer,5);
-        if(output==NULL){
-            return false;
-        }
-        strcpy((char*)output,"null");
-        return true;
-    case cJSON_False:
-        output=ensure(output_buffer,6);
-        if(output==NULL){
-            return false;
-        }
-        strcpy((char*)output,"false");
-        return true;
-    case cJSON_True:
-        output=ensure(output_buffer,5);
-        if(output==NULL){
-            return false;
-        }
-        strcpy((char *)output,"true");
-        return true;
-    case cJSON_Number:
-        return print_number(item,output_buffer);
-    case cJSON_Raw:
-        size_t raw_lenght=0;
-        if(item->valuestring==NULL)
-        {
-            return false;
-        }
-        raw_lenght=strlen(item->valuestring)+sizeof("");
-        output=ensure(output_buffer,raw_lenght);
-        if(output==NULL){
-            return false;
-        }
-        memcpy(output,item->valuestring,raw_lenght);
-        return true;
-    case cJSON_String:
-        return print_string(item,output_buffer);
-    case cJSON_Array:
-        return print_array(item,output_buffer);
-    case cJSON_Object:
-        return print_object(item,output_buffer);
-    default:
-        return false;
+    buffer=&columns->columns[index];
+
+    memset(column,0,sizeof(cJSON_Column));
+    column->type=buffer->type;
+    column->length=columns->rows;
+    column->null_count=buffer->null_count;
+    column->validity=buffer->validity;
+    if(buffer->type==cJSON_ColumnString){
+        //no rows still have the leading offset 0
+        static const long long no_offsets[1]={0};
+        column->offsets=(buffer->values!=NULL)?(const long long*)buffer->values:no_offsets;
+        column->data=buffer->data;
+        column->data_length=buffer->data_length;
+    }else{
+        column->values=buffer->values;
     }
+
+    return true;
 }
 
-//build an array from input text
-static cJSON_bool parse_array(cJSON*const item,parse_buffer*const input_buffer){
-    cJSON*head=NULL;//head of the linked list
-    cJSON*current_item=NULL;
+CJSON_PUBLIC(const cJSON_ColumnMismatch*)cJSON_ColumnsMismatches(const cJSON_Columns*const columns,size_t*count){
+    if(count!=NULL){
+        *count=(columns!=NULL)?columns->mismatch_count:0;
+    }
 
-    
+    return (columns!=NULL)?columns->mismatches:NULL;
 }
 
+CJSON_PUBLIC(void)cJSON_ColumnsClear(cJSON_Columns*const columns){
+    if(columns!=NULL){
+        columns_truncate(columns,0,0);
+    }
+}
 
+CJSON_PUBLIC(void)cJSON_DeleteColumns(cJSON_Columns*columns){
+    size_t index=0;
 
+    if(columns==NULL){
+        return;
+    }
+    for(index=0;index<columns->column_count;index++){
+        column_buffer *const column=&columns->columns[index];
+        if(column->validity!=NULL){
+            global_hooks.deallcoate(column->validity);
+        }
+        if(column->values!=NULL){
+            global_hooks.deallcoate(column->values);
+        }
+        if(column->data!=NULL){
+            global_hooks.deallcoate(column->data);
+        }
+    }
+    if(columns->columns!=NULL){
+        global_hooks.deallcoate(columns->columns);
+    }
+    if(columns->mismatches!=NULL){
+        global_hooks.deallcoate(columns->mismatches);
+    }
+    if(columns->worker.values!=NULL){
+        global_hooks.deallcoate(columns->worker.values);
+    }
+    cJSON_DeleteParser(columns->worker.storage);
+    cJSON_DeleteQuery(columns->query);
+    global_hooks.deallcoate(columns);
+}
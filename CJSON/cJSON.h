@@ -1,8 +1,8 @@
 #ifndef cJSON_h
 #define cJSON_h
 
-#ifdef _cplusplus
-extern "c"{
+#ifdef __cplusplus
+extern "C"{
 #endif
 
 #if !defined(_WINDOWS_)&&(defined(WIN32)||defined(WIN64)||defined(_MSC_VER)||defined(_WIN32_))
@@ -56,6 +56,9 @@ extern "c"{
 
 #define cJSON_IsReference 256
 #define cJSON_StringIsConst 512
+#define cJSON_NumberIsLazy 2048  //valuestring holds the text of the number,see cJSON_ParseLazyNumbers
+#define cJSON_NumberIsConverted 4096  //valuedouble and valueint of a lazy number are filled in
+#define cJSON_HasShape 8192  //object of a cJSON_Parser that shares a shape,see cJSON_GetFieldItem
 
 typedef struct  cJSON
 {
@@ -68,6 +71,9 @@ typedef struct  cJSON
     struct cJSON *child;
 
     int type;
+    /*copy on write state of cJSON_DuplicateShared,only changed by cJSON with atomic
+    operations; it fills the padding after type on 64 bit targets*/
+    int shares;
 
      /* The item's string, if type==cJSON_String  and type == cJSON_Raw */    
     char *valuestring;
@@ -103,6 +109,18 @@ CJSON_PUBLIC(const char*) cJSON_Version(void);
 /*Supply malloc realloc and free functions to Cjson*/
 CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks *hooks);
 
+/* Use the pooled allocator instead of the hooks; call it before any item is allocated.
+ * Items and small strings come from per thread free lists; blocks freed by another
+ * thread go back to their pool in batches. When a thread ends its pending batch is
+ * returned and its pool released: the pool's memory goes back to the system once
+ * every block from it is freed. cJSON_PoolReleaseThread does that earlier,for
+ * example before a thread of a pool stops using cJSON for good.
+ * cJSON_InitHooks switches back only once the pooled allocator holds no memory,
+ * that is once every item is deleted and every thread that used it has ended or
+ * called cJSON_PoolReleaseThread; until then it is ignored. */
+CJSON_PUBLIC(void) cJSON_InitPooledHooks(void);
+CJSON_PUBLIC(void) cJSON_PoolReleaseThread(void);
+
 /* Memory Management: the caller is always responsible to free the results from
 all variants of cJSON_Parse (with cJSON_Delete) and 
 cJSON_Print (with stdlib free, cJSON_Hooks.free_fn, or cJSON_free as appropriate). 
@@ -112,14 +130,242 @@ CJSON_PUBLIC(cJSON*)cJSON_Parse(const char *value);
 
 CJSON_PUBLIC(cJSON*)cJSON_ParseWithOpts(const char *value,const char **return_parse_end,cJSON_bool require_null_terminated);
 
+/* parse flags,combine with |
+ * cJSON_ParseRequireNullTerminated: only whitespace and a '\0' (inside length) may follow the value
+ * cJSON_ParseValidateUTF8: reject strings that are not valid UTF-8,the error position
+ *                          points at the first byte of the invalid sequence
+ * cJSON_ParseLazyNumbers: keep the text of numbers instead of converting them;
+ *                         they are converted on first use by cJSON_GetNumberValue or
+ *                         cJSON_GetInt64Value and printed as written */
+#define cJSON_ParseRequireNullTerminated 1
+#define cJSON_ParseValidateUTF8 2
+#define cJSON_ParseLazyNumbers 4
+
+/* Parse length bytes of value, which need not be '\0' terminated. */
+CJSON_PUBLIC(cJSON*)cJSON_ParseWithFlags(const char *value,size_t length,const char **return_parse_end,int flags);
+
+/* Parse like cJSON_ParseWithFlags with up to threads threads. A first pass indexes
+ * the brackets and commas outside strings on all threads,then the children of
+ * large arrays and objects are parsed in ranges in parallel. The tree and the
+ * error position are the same as those of a serial parse. Without CJSON_PARALLEL
+ * defined when building cJSON,or for small input,this parses on the calling thread. */
+CJSON_PUBLIC(cJSON*)cJSON_ParseParallel(const char *value,size_t length,const char **return_parse_end,int flags,int threads);
+
+/* Check that length bytes of json hold exactly one JSON value (surrounding whitespace allowed)
+ * without building a tree; nothing is allocated. The buffer need not be '\0' terminated.
+ * Numbers are checked against the RFC 8259 grammar by the scanner the parser uses,so
+ * both reject "01","1.",".5","1e" and "0x1". On failure error_offset (if not NULL) receives the offset where parsing stopped. */
+CJSON_PUBLIC(cJSON_bool)cJSON_Validate(const char *json,size_t length,size_t *error_offset);
+CJSON_PUBLIC(cJSON_bool)cJSON_ValidateWithFlags(const char *json,size_t length,size_t *error_offset,int flags);
+
+/* Array streams parse one top-level array an element at a time,so memory use is
+ * bounded by the largest element instead of the document. cJSON_ArrayStreamNext
+ * returns the next element as its own tree,which the caller deletes,or NULL after
+ * the last element or on error. cJSON_ArrayStreamFailed tells the two apart and
+ * gives the offset of the error in the input.
+ * A stream reads a buffer of length bytes,a file descriptor (not closed by the
+ * stream) or a reader,which fills buffer with up to size bytes and returns their
+ * number,0 at the end of the input or (size_t)-1 on error. */
+typedef struct cJSON_ArrayStream cJSON_ArrayStream;
+typedef size_t (*cJSON_StreamReader)(void *context,char *buffer,size_t size);
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateArrayStream(const char *json,size_t length,int flags);
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateArrayStreamFd(int fd,int flags);
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateArrayStreamReader(cJSON_StreamReader read,void *context,int flags);
+//the reader of cJSON_CreateArrayStreamFd,context points to the int file descriptor
+CJSON_PUBLIC(size_t)cJSON_StreamReadFd(void *context,char *buffer,size_t size);
+CJSON_PUBLIC(cJSON*)cJSON_ArrayStreamNext(cJSON_ArrayStream*const stream);
+CJSON_PUBLIC(cJSON_bool)cJSON_ArrayStreamFailed(const cJSON_ArrayStream*const stream,size_t*const error_offset);
+CJSON_PUBLIC(void)cJSON_DeleteArrayStream(cJSON_ArrayStream*const stream);
+
+/* Record streams read newline-delimited JSON,one value per line with empty lines
+ * skipped,through the array stream calls above. Memory use is bounded by the
+ * longest line. */
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateRecordStream(const char *json,size_t length,int flags);
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateRecordStreamFd(int fd,int flags);
+CJSON_PUBLIC(cJSON_ArrayStream*)cJSON_CreateRecordStreamReader(cJSON_StreamReader read,void *context,int flags);
+
+/* Parse the file at path. A large regular file is mapped and parsed with up to
+ * threads threads as with cJSON_ParseParallel. A top-level array read from a pipe
+ * is parsed an element at a time while the rest of it arrives. With
+ * cJSON_ParseRequireNullTerminated only whitespace may follow the value. On
+ * failure error_offset (if not NULL) receives the offset of the error in the file,
+ * 0 if the file cannot be read. */
+CJSON_PUBLIC(cJSON*)cJSON_ParseFile(const char *path,int flags,int threads,size_t *error_offset);
+
+/* A parser keeps its storage between calls,so parsing many similar messages
+ * reaches a steady state without allocating. Items and strings are carved from
+ * chunks that are reused by the next parse,and object keys are interned in a
+ * table kept for the life of the parser. flags (cJSON_Parse* flags) apply to every
+ * parse,capacity (0 for a default) sizes the first chunk.
+ * cJSON_ParserParse returns a tree that stays valid until the next parse,reset or
+ * delete of the parser. It is read only: do not delete it or change it with the
+ * mutation functions,cJSON_Duplicate gives an ordinary copy. return_parse_end
+ * works as for cJSON_ParseWithFlags,the global error is not touched.
+ * cJSON_ParserReset drops the tree but keeps the storage. */
+typedef struct cJSON_Parser cJSON_Parser;
+CJSON_PUBLIC(cJSON_Parser*)cJSON_CreateParser(size_t capacity,int flags);
+CJSON_PUBLIC(const cJSON*)cJSON_ParserParse(cJSON_Parser*const parser,const char *value,size_t length,const char **return_parse_end);
+CJSON_PUBLIC(void)cJSON_ParserReset(cJSON_Parser*const parser);
+CJSON_PUBLIC(void)cJSON_DeleteParser(cJSON_Parser*parser);
+
+/* Objects from a parser share a shape with the other objects that have the same
+ * keys in the same order,as long as their keys were interned and the parser has
+ * fewer than CJSON_PARSER_SHAPE_LIMIT shapes. A cJSON_Field caches where its key
+ * sits in the last shape it was looked up in,so reading a field of many rows of
+ * the same shape is an indexed load; on another shape,or an object without one,
+ * the members are searched by name as with cJSON_getObjectItemCaseSensitive.
+ * Shapes are kept for the life of the parser and carry its generation,which no
+ * other parser gets,so a hit compares the shape and the generation and no key,
+ * and a field stays correct when a shape of a deleted parser's address is reused.
+ * A field is written by lookups,use one per thread.
+ *
+ *     cJSON_Field host=cJSON_FieldInit("host");
+ *     for(row=rows->child;row!=NULL;row=row->next){
+ *         const cJSON *value=cJSON_GetFieldItem(row,&host); ... } */
+typedef struct cJSON_Shape cJSON_Shape;
+typedef struct cJSON_Field
+{
+    const char *key;
+    const cJSON_Shape *shape;//of the last lookup,NULL before the first
+    size_t index;
+    size_t generation;//of the parser that made shape
+}cJSON_Field;
+#define cJSON_FieldInit(key) {(key),NULL,0,0}
+CJSON_PUBLIC(cJSON*)cJSON_GetFieldItem(const cJSON*const object,cJSON_Field*const field);
+
+/* Queries over newline-delimited JSON that build no tree of a record. Each record
+ * is scanned once: the values at the paths of the query are parsed,everything
+ * else is only validated. Paths are JSON Pointers (RFC 6901),"" is the record.
+ * cJSON_QueryWhere adds a predicate that every record has to pass. A record
+ *   without a value at path fails it. The operand is a number,string,boolean or
+ *   null; numbers are ordered by value,strings bytewise,other types only equal
+ *   themselves. Records that cannot equal a string operand are found by a
+ *   block scan of their text and are only validated,without capturing values.
+ * cJSON_QuerySelect adds a projection.
+ * cJSON_QueryAggregate adds count (of records,or with a path of records with a
+ *   value there that is not null),or sum/min/max of the numbers at path.
+ * cJSON_QueryGroupBy computes the aggregates per value at path,records without
+ *   one are grouped with null.
+ * cJSON_QueryRun runs a query over length bytes of json,cJSON_QueryRunReader over
+ * what a reader returns. Without aggregates the result is an array of the matching
+ * records,or of objects holding the value of each selected path under the path. With
+ * aggregates it is an object holding each aggregate under a name such as "count"
+ * or "sum(/price)",null if it saw no numbers; grouped,an array of such objects with
+ * the group value under "key",in order of appearance. Projections are ignored
+ * then. Records are split across up to threads threads when cJSON is built with
+ * CJSON_PARALLEL; rows and groups keep the input order,sums may round differently
+ * than in a serial run. On an invalid record NULL is
+ * returned and error_offset (if not NULL) receives the offset of the error. A query
+ * can be run by several threads at once. */
+#define cJSON_QueryEqual 0
+#define cJSON_QueryNotEqual 1
+#define cJSON_QueryLess 2
+#define cJSON_QueryLessEqual 3
+#define cJSON_QueryGreater 4
+#define cJSON_QueryGreaterEqual 5
+#define cJSON_QueryExists 6
+
+#define cJSON_QueryCount 0
+#define cJSON_QuerySum 1
+#define cJSON_QueryMin 2
+#define cJSON_QueryMax 3
+
+typedef struct cJSON_Query cJSON_Query;
+CJSON_PUBLIC(cJSON_Query*)cJSON_CreateQuery(int flags);
+CJSON_PUBLIC(cJSON_bool)cJSON_QueryWhere(cJSON_Query*const query,const char *path,int operation,const cJSON *operand);
+CJSON_PUBLIC(cJSON_bool)cJSON_QuerySelect(cJSON_Query*const query,const char *path);
+CJSON_PUBLIC(cJSON_bool)cJSON_QueryAggregate(cJSON_Query*const query,int function,const char *path);
+CJSON_PUBLIC(cJSON_bool)cJSON_QueryGroupBy(cJSON_Query*const query,const char *path);
+CJSON_PUBLIC(cJSON*)cJSON_QueryRun(const cJSON_Query*const query,const char *json,size_t length,int threads,size_t *error_offset);
+CJSON_PUBLIC(cJSON*)cJSON_QueryRunReader(const cJSON_Query*const query,cJSON_StreamReader read,void *context,int threads,size_t *error_offset);
+CJSON_PUBLIC(void)cJSON_DeleteQuery(cJSON_Query*query);
+
+/* Columns extracted from a top-level array of objects in one pass,for analytics
+ * that would otherwise look up every field of every row. Each column takes the
+ * values at a JSON Pointer path within the elements and stores them the way
+ * Apache Arrow lays out a column:
+ *   validity   a bit per row,least significant bit first,set if the row has a value
+ *   values     a double or long long per row,or a bit per row for booleans
+ *   offsets    for strings,length+1 offsets into data (Arrow's large utf8)
+ * A row without a value,or with null,is null. A value of another type is null
+ * as well and is reported as a mismatch with its row,column and cJSON type; an
+ * int64 column takes integral numbers that fit long long,read from their text.
+ * cJSON_ColumnsAdd returns the index of a new column,-1 on error; columns are
+ * added before the first extraction. cJSON_ColumnsExtract appends the elements
+ * of an array as rows; on invalid JSON it returns false,error_offset (if not
+ * NULL) receives the offset of the error and the rows of that call are dropped.
+ * cJSON_ColumnsGet describes a column,its buffers stay valid until the next
+ * extraction,clear or delete. cJSON_ColumnsClear drops the rows and keeps the
+ * buffers for reuse. */
+#define cJSON_ColumnDouble 0
+#define cJSON_ColumnInt64 1
+#define cJSON_ColumnString 2
+#define cJSON_ColumnBool 3
+
+typedef struct cJSON_Column
+{
+    int type;
+    size_t length;//rows
+    size_t null_count;
+    const unsigned char *validity;
+    const void *values;//NULL for strings
+    const long long *offsets;//strings only
+    const char *data;
+    size_t data_length;
+}cJSON_Column;
+
+typedef struct cJSON_ColumnMismatch
+{
+    size_t row;
+    size_t column;
+    int type;//the cJSON type found
+}cJSON_ColumnMismatch;
+
+typedef struct cJSON_Columns cJSON_Columns;
+CJSON_PUBLIC(cJSON_Columns*)cJSON_CreateColumns(int flags);
+CJSON_PUBLIC(int)cJSON_ColumnsAdd(cJSON_Columns*const columns,const char *path,int type);
+CJSON_PUBLIC(cJSON_bool)cJSON_ColumnsExtract(cJSON_Columns*const columns,const char *json,size_t length,size_t *error_offset);
+CJSON_PUBLIC(size_t)cJSON_ColumnsRows(const cJSON_Columns*const columns);
+CJSON_PUBLIC(cJSON_bool)cJSON_ColumnsGet(const cJSON_Columns*const columns,size_t index,cJSON_Column *column);
+CJSON_PUBLIC(const cJSON_ColumnMismatch*)cJSON_ColumnsMismatches(const cJSON_Columns*const columns,size_t *count);
+CJSON_PUBLIC(void)cJSON_ColumnsClear(cJSON_Columns*const columns);
+CJSON_PUBLIC(void)cJSON_DeleteColumns(cJSON_Columns*columns);
+
 CJSON_PUBLIC(char *)cJSON_Print(const cJSON *item);
 
 CJSON_PUBLIC(char*)cJSON_PrintUnformatted(const cJSON *item);
 
+/* Print with up to threads threads,the output is the same as cJSON_Print or
+ * cJSON_PrintUnformatted. The children of large arrays and objects are printed
+ * in chunks in parallel. Without CJSON_PARALLEL defined when building cJSON
+ * this prints on the calling thread. The tree must not change meanwhile. */
+CJSON_PUBLIC(char*)cJSON_PrintParallel(const cJSON *item,cJSON_bool format,int threads);
+
 CJSON_PUBLIC(char*)cJSON_PrintBuffered(const cJSON *item,int prebuffer,cJSON_bool fmt);
 
 CJSON_PUBLIC(cJSON_bool)cJSON_PrintPreallocated(cJSON *item,char *buffer,const int length,const cJSON_bool format);
 
+/* A printer keeps its output buffer between calls, so printing many small items
+ * reaches a steady state without allocating. cJSON_PrinterPrint returns a view
+ * (pointer and length) into the printer's buffer that stays valid until the next
+ * print, reset or delete of the printer; do not free it.
+ * cJSON_PrinterReset drops the view but keeps the high-water capacity. */
+typedef struct cJSON_Printer cJSON_Printer;
+CJSON_PUBLIC(cJSON_Printer*)cJSON_CreatePrinter(size_t capacity);
+CJSON_PUBLIC(const char*)cJSON_PrinterPrint(cJSON_Printer*const printer,const cJSON*const item,const cJSON_bool format,size_t*const length);
+CJSON_PUBLIC(void)cJSON_PrinterReset(cJSON_Printer*const printer);
+CJSON_PUBLIC(void)cJSON_DeletePrinter(cJSON_Printer*printer);
+
+/* Binary encoding as CBOR (RFC 8949): numbers are stored natively, strings are length
+ * prefixed and arrays/objects are size prefixed, so neither side formats or parses text.
+ * cJSON_EncodeCBOR returns a buffer to free with cJSON_free and its length.
+ * cJSON_PrinterEncodeCBOR encodes into the printer's buffer like cJSON_PrinterPrint.
+ * cJSON_DecodeCBOR builds a regular tree from one encoded item, consumed (if not NULL)
+ * receives the number of bytes used, or the failing offset. */
+CJSON_PUBLIC(unsigned char*)cJSON_EncodeCBOR(const cJSON*const item,size_t*const length);
+CJSON_PUBLIC(const unsigned char*)cJSON_PrinterEncodeCBOR(cJSON_Printer*const printer,const cJSON*const item,size_t*const length);
+CJSON_PUBLIC(cJSON*)cJSON_DecodeCBOR(const unsigned char*const data,const size_t length,size_t*const consumed);
+
 CJSON_PUBLIC(void)cJSON_Delete(cJSON *c);
 
 CJSON_PUBLIC(int)cJSON_GetArraySize(const cJSON *array);
@@ -136,6 +382,14 @@ CJSON_PUBLIC(const char*)cJSON_GetErrorPtr(void);
 
 CJSON_PUBLIC(char*)cJSON_GetStringValue(cJSON*item);
 
+/* The value of a number,NAN for other items. A lazy number is converted the first
+ * time,which fills in valuedouble and valueint; until then they must not be read
+ * directly,and threads sharing a tree should not be the first to read a number
+ * at the same time. cJSON_GetInt64Value gives an integral number that fits long
+ * long,reading a lazy number from its text so 64 bit ids keep every digit. */
+CJSON_PUBLIC(double)cJSON_GetNumberValue(const cJSON*const item);
+CJSON_PUBLIC(cJSON_bool)cJSON_GetInt64Value(const cJSON*const item,long long*const value);
+
 //check the type of an item
 CJSON_PUBLIC(cJSON_bool)cJSON_ISInvalid(const cJSON* const item);
 CJSON_PUBLIC(cJSON_bool)cJSON_IsFalse(const cJSON*const item);
@@ -169,7 +423,7 @@ CJSON_PUBLIC(cJSON*) cJSON_CreateObjectReference(const cJSON*child);
 CJSON_PUBLIC(cJSON*)cJSON_CreateFloatArray(const float *numbers,int count);
 CJSON_PUBLIC(cJSON*)cJSON_CreateDoubleArray(const double *number,int count);
 CJSON_PUBLIC(cJSON*)cJSON_CreateIntArray(const int *number,int count);
-CJSON_PUBLIC(cJSON*)cJSON_CreateStringArray(const char *strings,int count);
+CJSON_PUBLIC(cJSON*)cJSON_CreateStringArray(const char *const *strings,int count);
 
 //append item to the specified array/object
 CJSON_PUBLIC(void) cJSON_AddItemToArray(cJSON *array,cJSON *item);
@@ -178,6 +432,18 @@ CJSON_PUBLIC(void) cJSON_AddItemToObjectCS(cJSON *object,const char*string,cJSON
 CJSON_PUBLIC(void) cJSON_AddItemRefernceToArray(cJSON *array,cJSON *item);
 CJSON_PUBLIC(void) cJSON_AddItemRefernceToObject(cJSON *object,const char*string,cJSON *item);
 
+/* Appends are O(1): the prev of the first item of an array or object points to
+ * the last one,whose next is NULL. The bulk appends below attach many items at
+ * once. They return false and attach nothing if any item is NULL,shared or
+ * already the container. Each item may be passed only once.
+ * cJSON_AddChainToArray/Object take the first item of a chain linked through
+ * next,for cJSON_AddChainToObject every item of it needs a name.
+ * cJSON_AddItemsToObject names items[i] with a copy of names[i]. */
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemsToArray(cJSON*const array,cJSON*const*const items,const int count);
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemsToObject(cJSON*const object,const char*const*const names,cJSON*const*const items,const int count);
+CJSON_PUBLIC(cJSON_bool) cJSON_AddChainToArray(cJSON*const array,cJSON*const chain);
+CJSON_PUBLIC(cJSON_bool) cJSON_AddChainToObject(cJSON*const object,cJSON*const chain);
+
 //Remove/Deatch item from Arrays/objects
 CJSON_PUBLIC(cJSON*) cJSON_DetachItemViaPointer(cJSON*parent,cJSON*const item);
 CJSON_PUBLIC(cJSON*) cJSON_DetachItemFromArray(cJSON*array,int which);
@@ -196,10 +462,95 @@ CJSON_PUBLIC(void) cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object,const ch
 
 //Duplicate a cJSON item
 CJSON_PUBLIC(cJSON*) cJSON_Duplicate(const cJSON*item,cJSON_bool recurse);
-
-CJSON_PUBLIC(cJSON*) cJSON_Compare(const cJSON* const a,const cJSON*const b,const cJSON_bool case_sensitive);
-
+/* Duplicate an item sharing its children: the copy and item own the same child
+ * list. Every item below item is frozen,cJSON_IsShared tells,and the mutating
+ * functions and cJSON_setNumberValue refuse a frozen item as parent or item,at
+ * any depth,leaving an item to add with the caller. To change a tree,reach the
+ * item with the Mutable getters below,starting at its root: each gives its
+ * container its own copy of a shared child list,so only the path to a change is
+ * copied. The first duplicate walks the tree once to freeze it,without
+ * allocating; later duplicates of it cost O(1).
+ * Owners of shared lists are counted in the shares of the items with atomic
+ * operations,so trees that share lists can be read,changed and deleted in
+ * separate threads. Nothing else of item is written. */
+CJSON_PUBLIC(cJSON*) cJSON_DuplicateShared(const cJSON*item);
+//true if item is frozen by cJSON_DuplicateShared,see above
+CJSON_PUBLIC(cJSON_bool) cJSON_IsShared(const cJSON*const item);
+/* Like cJSON_GetArrayItem/cJSON_getObjectItem,but first give the container its own
+ * copy of a shared child list,so the returned item can be changed. Returns NULL if
+ * the container itself is frozen. */
+CJSON_PUBLIC(cJSON*) cJSON_GetArrayItemMutable(cJSON*array,int index);
+CJSON_PUBLIC(cJSON*) cJSON_GetObjectItemMutable(cJSON*object,const char*string);
+CJSON_PUBLIC(cJSON*) cJSON_GetObjectItemMutableCaseSensitive(cJSON*object,const char*string);
+
+/* Recursively compare two cJSON items for equality. If either a or b is NULL or invalid, they will be considered unequal.
+ * case_sensitive determines if object keys are treated case sensitive (1) or case insensitive (0);
+ * member order of objects does not matter. Arrays and objects are first told apart
+ * by their digests,so comparing a document again with an unequal one takes O(1).
+ * Neither item is written to. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON* const a,const cJSON*const b,const cJSON_bool case_sensitive);
+/* 64 bit digest of the subtree of item,0 for NULL. Items that cJSON_Compare finds
+ * equal in either mode have equal digests,regardless of member order. The digest
+ * is computed once and cached apart from the items,per thread; the mutating
+ * functions,cJSON_setNumberValue and cJSON_Delete drop the cached digests. The
+ * cache does not see changes made by writing to the members of an item. */
+CJSON_PUBLIC(unsigned long long) cJSON_Digest(const cJSON*const item);
+
+/* Minify a string,remove blank characters(such as ' ', '\t', '\r', '\n') and comments outside strings.
+ * The input pointer json cannot point to a read-only address area, such as a string constant.
+ * cJSON_MinifyWithLength works on a buffer that need not be '\0' terminated and returns
+ * the minified length; it does not write a terminator. */
 CJSON_PUBLIC(void) cJSON_Minify(char *json);
+CJSON_PUBLIC(size_t) cJSON_MinifyWithLength(char *json,size_t length);
+
+/* Snapshots flatten a tree into one position independent image (offsets instead of
+ * pointers) that can be written to a file and used read-only straight from mmap.
+ * cJSON_CreateSnapshot returns the image, free it with cJSON_free.
+ * cJSON_SnapshotOpen checks magic, version, byte order and size and returns the root;
+ * with verify it also checks the checksum and every offset, which reads the whole image.
+ * The accessors mirror the ones for cJSON items; array items are found in O(1),
+ * members of objects with 8 or more members through a hash index. */
+typedef struct cJSON_SnapshotItem cJSON_SnapshotItem;
+CJSON_PUBLIC(void*) cJSON_CreateSnapshot(const cJSON*const item,size_t*const length);
+CJSON_PUBLIC(const cJSON_SnapshotItem*) cJSON_SnapshotOpen(const void*const image,const size_t size,const cJSON_bool verify);
+CJSON_PUBLIC(int) cJSON_SnapshotGetArraySize(const cJSON_SnapshotItem*const array);
+CJSON_PUBLIC(const cJSON_SnapshotItem*) cJSON_SnapshotGetArrayItem(const cJSON_SnapshotItem*const array,const int index);
+CJSON_PUBLIC(const cJSON_SnapshotItem*) cJSON_SnapshotGetObjectItem(const cJSON_SnapshotItem*const object,const char*const string);
+CJSON_PUBLIC(const cJSON_SnapshotItem*) cJSON_SnapshotGetObjectItemCaseSensitive(const cJSON_SnapshotItem*const object,const char*const string);
+CJSON_PUBLIC(const char*) cJSON_SnapshotGetName(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(const char*) cJSON_SnapshotGetStringValue(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(double) cJSON_SnapshotGetNumberValue(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsInvalid(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsFalse(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsTrue(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsBool(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsNULL(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsNumber(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsString(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsArray(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsObject(const cJSON_SnapshotItem*const item);
+CJSON_PUBLIC(cJSON_bool) cJSON_SnapshotIsRaw(const cJSON_SnapshotItem*const item);
+
+/* Frozen documents are snapshots with prebuilt indexes that are never written again,
+ * so any number of threads may read them without locking through the snapshot accessors
+ * (object members are found through a hash index,array items in O(1)).
+ * A frozen document is reference counted: cJSON_Freeze returns it with one reference,
+ * cJSON_FrozenRetain adds one and cJSON_FrozenRelease drops one.
+ * A slot holds the current version for RCU style updates: cJSON_FrozenSlotAcquire
+ * returns the current version with a reference that the reader drops when done, and
+ * cJSON_FrozenSlotPublish installs a new version (taking over its reference) and drops
+ * the slot's reference to the old one once no reader can still acquire it. Readers
+ * never wait; a publisher waits only for acquisitions in progress. */
+typedef struct cJSON_Frozen cJSON_Frozen;
+typedef struct cJSON_FrozenSlot cJSON_FrozenSlot;
+CJSON_PUBLIC(cJSON_Frozen*) cJSON_Freeze(const cJSON*const item);
+CJSON_PUBLIC(const cJSON_SnapshotItem*) cJSON_FrozenGetRoot(const cJSON_Frozen*const frozen);
+CJSON_PUBLIC(cJSON_Frozen*) cJSON_FrozenRetain(cJSON_Frozen*const frozen);
+CJSON_PUBLIC(void) cJSON_FrozenRelease(cJSON_Frozen*const frozen);
+CJSON_PUBLIC(cJSON_FrozenSlot*) cJSON_CreateFrozenSlot(cJSON_Frozen*const initial);
+CJSON_PUBLIC(cJSON_Frozen*) cJSON_FrozenSlotAcquire(cJSON_FrozenSlot*const slot);
+CJSON_PUBLIC(void) cJSON_FrozenSlotPublish(cJSON_FrozenSlot*const slot,cJSON_Frozen*const next);
+CJSON_PUBLIC(void) cJSON_DeleteFrozenSlot(cJSON_FrozenSlot*const slot);
 
 //creating and adding items to an object at the same time
 //they return the added item or null on failure
@@ -213,15 +564,50 @@ CJSON_PUBLIC(cJSON*) cJSON_AddRawToObject(cJSON*const object,const char*const na
 CJSON_PUBLIC(cJSON*) cJSON_AddArrayToObject(cJSON*const object,const char*const name);
 CJSON_PUBLIC(cJSON*) cJSON_AddObjectToObject(cJSON*const object,const char*const name);
 
-#define cJSON_SetIntValue(object,number)((object)?(object)->valueint=(object)->valuedouble=(number):(number))
+//goes through cJSOn_setNumberHelper,so the text of a lazy number is dropped as well
+#define cJSON_SetIntValue(object,number)(((object)!=NULL)?(int)cJSOn_setNumberHelper(object,(double)(number)):(number))
 
 CJSON_PUBLIC(double)cJSOn_setNumberHelper(cJSON *object,double number);
-#define cJSON_setNumberValue(object,numeber)((oubject!=NULL)?cJSON_SetNumberHelper(object, (double)number) : (number))
+#define cJSON_setNumberValue(object,number)(((object)!=NULL)?cJSOn_setNumberHelper(object,(double)(number)):(number))
+
+/* Profiling counters,compiled in when cJSON is built with CJSON_PROFILE and free
+ * otherwise. Every thread counts per phase the calls,the cycles spent (time stamp
+ * counter ticks where there is one) and the bytes handled: whitespace skipped,
+ * strings and numbers parsed,bytes converted by strtod,bytes allocated for items
+ * and strings,and the size of print buffers after they grow. Phases nest: strtod
+ * is part of number and string allocations are part of string.
+ * cJSON_ProfileSnapshot copies the counters of the calling thread,including the
+ * work of the threads that parallel parses and prints ran for it,and returns false
+ * (with zeroed counters) when profiling is not compiled in. cJSON_PrintProfile
+ * renders a snapshot as JSON,free it with cJSON_free. */
+#define cJSON_ProfileWhitespace 0
+#define cJSON_ProfileString 1
+#define cJSON_ProfileNumber 2
+#define cJSON_ProfileStrtod 3
+#define cJSON_ProfileAllocate 4
+#define cJSON_ProfileEnsure 5
+#define cJSON_ProfilePhases 6
+
+typedef struct cJSON_ProfileCounter
+{
+    unsigned long long calls;
+    unsigned long long cycles;
+    unsigned long long bytes;
+}cJSON_ProfileCounter;
+
+typedef struct cJSON_Profile
+{
+    cJSON_ProfileCounter phase[cJSON_ProfilePhases];
+}cJSON_Profile;
+
+CJSON_PUBLIC(cJSON_bool)cJSON_ProfileSnapshot(cJSON_Profile *profile);
+CJSON_PUBLIC(void)cJSON_ProfileReset(void);
+CJSON_PUBLIC(char*)cJSON_PrintProfile(const cJSON_Profile *profile);
 
 CJSON_PUBLIC(void *)cJSON_malloc(size_t size);
 CJSON_PUBLIC(void) cJSON_free(void *object);
 
-#ifdef _cplusplus
+#ifdef __cplusplus
 }
 #endif
 
@@ -0,0 +1,377 @@
+#ifndef cJSON_hpp
+#define cJSON_hpp
+
+/* C++17 interface for cJSON. document owns a parsed tree and is move only,
+ * value is a non owning view of one item. Both are a single pointer wide and
+ * every member is inline,so they compile down to the same code as the C API. */
+
+#include"cJSON.h"
+
+#include<cmath>
+#include<cstddef>
+#include<iterator>
+#include<limits>
+#include<optional>
+#include<string_view>
+#include<type_traits>
+#include<utility>
+
+namespace cjson{
+
+class value;
+
+//forward iterator over the items of an array or object,following child/next
+class iterator{
+public:
+    using iterator_category=std::forward_iterator_tag;
+    using value_type=value;
+    using difference_type=std::ptrdiff_t;
+    using pointer=void;
+    using reference=value;
+
+    iterator() noexcept=default;
+    explicit iterator(const cJSON*item) noexcept:item_(item){}
+
+    inline value operator*() const noexcept;
+
+    iterator &operator++() noexcept{
+        item_=item_->next;
+        return *this;
+    }
+
+    iterator operator++(int) noexcept{
+        iterator previous=*this;
+        item_=item_->next;
+        return previous;
+    }
+
+    friend bool operator==(const iterator&a,const iterator&b) noexcept{
+        return a.item_==b.item_;
+    }
+
+    friend bool operator!=(const iterator&a,const iterator&b) noexcept{
+        return a.item_!=b.item_;
+    }
+
+private:
+    const cJSON *item_=nullptr;
+};
+
+class value{
+public:
+    value() noexcept=default;
+    explicit value(const cJSON*item) noexcept:item_(item){}
+
+    const cJSON *get() const noexcept{
+        return item_;
+    }
+
+    //false for the view of a missing item
+    explicit operator bool() const noexcept{
+        return item_!=nullptr;
+    }
+
+    int type() const noexcept{
+        return (item_!=nullptr)?(item_->type&0xFF):cJSON_Invalid;
+    }
+
+    bool is_null() const noexcept{ return type()==cJSON_NULL; }
+    bool is_false() const noexcept{ return type()==cJSON_False; }
+    bool is_true() const noexcept{ return type()==cJSON_True; }
+    bool is_bool() const noexcept{ return (type()&(cJSON_True|cJSON_False))!=0; }
+    bool is_number() const noexcept{ return type()==cJSON_Number; }
+    bool is_string() const noexcept{ return type()==cJSON_String; }
+    bool is_raw() const noexcept{ return type()==cJSON_Raw; }
+    bool is_array() const noexcept{ return type()==cJSON_Array; }
+    bool is_object() const noexcept{ return type()==cJSON_Object; }
+
+    //name of an object member,empty otherwise
+    std::string_view name() const noexcept{
+        return ((item_!=nullptr)&&(item_->string!=nullptr))?std::string_view(item_->string):std::string_view();
+    }
+
+    //number of items of an array or object
+    std::size_t size() const noexcept{
+        std::size_t count=0;
+        for(const cJSON *child=children();child!=nullptr;child=child->next){
+            count++;
+        }
+        return count;
+    }
+
+    bool empty() const noexcept{
+        return children()==nullptr;
+    }
+
+    iterator begin() const noexcept{
+        return iterator(children());
+    }
+
+    iterator end() const noexcept{
+        return iterator();
+    }
+
+    //object member with exactly this name,an empty view if there is none
+    value operator[](std::string_view key) const noexcept{
+        if(!is_object()){
+            return value();
+        }
+        for(const cJSON *child=item_->child;child!=nullptr;child=child->next){
+            if((child->string!=nullptr)&&name_equals(child->string,key)){
+                return value(child);
+            }
+        }
+        return value();
+    }
+
+    //a null key finds nothing
+    value operator[](const char*key) const noexcept{
+        return (key!=nullptr)?(*this)[std::string_view(key)]:value();
+    }
+
+    /* Array item at index,an empty view if there is none. Any integral index
+     * binds here,so v[0] is not ambiguous with the name lookups. */
+    template<typename Index,std::enable_if_t<std::is_integral_v<Index>&&!std::is_same_v<Index,bool>,int> =0>
+    value operator[](Index index) const noexcept{
+        if constexpr(std::is_signed_v<Index>){
+            if(index<0){
+                return value();
+            }
+        }
+        const cJSON *child=is_array()?item_->child:nullptr;
+        auto remaining=static_cast<std::make_unsigned_t<Index>>(index);
+        while((child!=nullptr)&&(remaining>0)){
+            remaining--;
+            child=child->next;
+        }
+        return value(child);
+    }
+
+    std::optional<value> find(std::string_view key) const noexcept{
+        value member=(*this)[key];
+        return member?std::optional<value>(member):std::nullopt;
+    }
+
+    bool contains(std::string_view key) const noexcept{
+        return static_cast<bool>((*this)[key]);
+    }
+
+    /* Typed accessors: the value if the item has the requested type,fallback
+     * otherwise. Strings are views into the tree. */
+    std::string_view as_string(std::string_view fallback={}) const noexcept{
+        return get<std::string_view>().value_or(fallback);
+    }
+
+    double as_double(double fallback=0) const noexcept{
+        return get<double>().value_or(fallback);
+    }
+
+    long long as_int64(long long fallback=0) const noexcept{
+        return get<long long>().value_or(fallback);
+    }
+
+    int as_int(int fallback=0) const noexcept{
+        return get<int>().value_or(fallback);
+    }
+
+    bool as_bool(bool fallback=false) const noexcept{
+        return get<bool>().value_or(fallback);
+    }
+
+    /* Checked conversion: std::nullopt if the item is missing or of another type.
+     * Numbers must fit the type,integral types also need a number without fraction. */
+    template<typename T>
+    std::optional<T> get() const noexcept{
+        if constexpr(std::is_same_v<T,bool>){
+            if(!is_bool()){
+                return std::nullopt;
+            }
+            return is_true();
+        }else if constexpr(std::is_floating_point_v<T>){
+            if(!is_number()){
+                return std::nullopt;
+            }
+            const double number=cJSON_GetNumberValue(item_);
+            //a number that overflowed to infinity or exceeds T does not fit either
+            if(!(std::fabs(number)<=static_cast<double>(std::numeric_limits<T>::max()))){
+                return std::nullopt;
+            }
+            return static_cast<T>(number);
+        }else if constexpr(std::is_integral_v<T>){
+            if(!is_number()){
+                return std::nullopt;
+            }
+            if((item_->type&cJSON_NumberIsLazy)!=0){
+                //the text of a lazy number keeps every digit of a 64 bit id
+                long long integer=0;
+                if(cJSON_GetInt64Value(item_,&integer)){
+                    if constexpr(std::is_signed_v<T>){
+                        if((integer<static_cast<long long>(std::numeric_limits<T>::min()))||(integer>static_cast<long long>(std::numeric_limits<T>::max()))){
+                            return std::nullopt;
+                        }
+                    }else if((integer<0)||(static_cast<unsigned long long>(integer)>std::numeric_limits<T>::max())){
+                        return std::nullopt;
+                    }
+                    return static_cast<T>(integer);
+                }
+            }
+            const double number=cJSON_GetNumberValue(item_);
+            //the upper bound is exclusive,max()+1 is a power of two and exact as double
+            const double upper=static_cast<double>(std::numeric_limits<T>::max()/2+1)*2.0;
+            if((std::floor(number)!=number)||(number<static_cast<double>(std::numeric_limits<T>::min()))||!(number<upper)){
+                return std::nullopt;
+            }
+            return static_cast<T>(number);
+        }else if constexpr(std::is_same_v<T,std::string_view>){
+            if((!is_string()&&!is_raw())||(item_->valuestring==nullptr)){
+                return std::nullopt;
+            }
+            return std::string_view(item_->valuestring);
+        }else if constexpr(std::is_same_v<T,const char*>){
+            if((!is_string()&&!is_raw())||(item_->valuestring==nullptr)){
+                return std::nullopt;
+            }
+            return static_cast<const char*>(item_->valuestring);
+        }else{
+            static_assert(std::is_same_v<T,value>,"cjson::value::get: unsupported type");
+            return *this;
+        }
+    }
+
+    //optional lookups of an object member
+    template<typename T>
+    std::optional<T> get(std::string_view key) const noexcept{
+        return (*this)[key].template get<T>();
+    }
+
+    //structural equality through cJSON_Compare,which writes to neither tree
+    friend bool operator==(const value&a,const value&b) noexcept{
+        return cJSON_Compare(a.item_,b.item_,true)!=0;
+    }
+
+    friend bool operator!=(const value&a,const value&b) noexcept{
+        return !(a==b);
+    }
+
+private:
+    //compare a '\0' terminated name with key without reading past either
+    static bool name_equals(const char*name,std::string_view key) noexcept{
+        for(const char c:key){
+            if((c=='\0')||(*name!=c)){
+                return false;
+            }
+            name++;
+        }
+        return *name=='\0';
+    }
+
+    const cJSON *children() const noexcept{
+        return (is_array()||is_object())?item_->child:nullptr;
+    }
+
+    const cJSON *item_=nullptr;
+};
+
+inline value iterator::operator*() const noexcept{
+    return value(item_);
+}
+
+//owner of a tree,deletes it with cJSON_Delete
+class document{
+public:
+    document() noexcept=default;
+    explicit document(cJSON*root) noexcept:root_(root){}
+
+    document(const document&)=delete;
+    document &operator=(const document&)=delete;
+
+    document(document&&other) noexcept:root_(other.release()){}
+
+    document &operator=(document&&other) noexcept{
+        if(this!=&other){
+            cJSON_Delete(root_);
+            root_=other.release();
+        }
+        return *this;
+    }
+
+    ~document(){
+        cJSON_Delete(root_);
+    }
+
+    /* Parse text,which need not be '\0' terminated. Only whitespace may follow
+     * the value,and a '\0' only as the last byte of text. On failure the document
+     * is empty and error_offset,if given,is the position of the error. */
+    static document parse(std::string_view text,int flags=0,std::size_t*error_offset=nullptr) noexcept{
+        const char *end=nullptr;
+        cJSON *root=cJSON_ParseWithFlags(text.data(),text.size(),&end,flags);
+        if(root!=nullptr){
+            const char *const text_end=text.data()+text.size();
+            while((end<text_end)&&((*end==' ')||(*end=='\t')||(*end=='\r')||(*end=='\n'))){
+                end++;
+            }
+            //a terminator counted in text may end it,nothing may follow one
+            if((end<text_end)&&!((*end=='\0')&&(end+1==text_end))){
+                cJSON_Delete(root);
+                root=nullptr;
+            }
+        }
+        if((root==nullptr)&&(error_offset!=nullptr)){
+            *error_offset=(end!=nullptr)?static_cast<std::size_t>(end-text.data()):0;
+        }
+        return document(root);
+    }
+
+    explicit operator bool() const noexcept{
+        return root_!=nullptr;
+    }
+
+    value root() const noexcept{
+        return value(root_);
+    }
+
+    operator value() const noexcept{
+        return value(root_);
+    }
+
+    cJSON *get() const noexcept{
+        return root_;
+    }
+
+    //give up ownership,the caller deletes the tree
+    cJSON *release() noexcept{
+        return std::exchange(root_,nullptr);
+    }
+
+    void reset(cJSON*root=nullptr) noexcept{
+        cJSON_Delete(std::exchange(root_,root));
+    }
+
+    value operator[](std::string_view key) const noexcept{
+        return root()[key];
+    }
+
+    value operator[](const char*key) const noexcept{
+        return root()[key];
+    }
+
+    template<typename Index,std::enable_if_t<std::is_integral_v<Index>&&!std::is_same_v<Index,bool>,int> =0>
+    value operator[](Index index) const noexcept{
+        return root()[index];
+    }
+
+    iterator begin() const noexcept{
+        return root().begin();
+    }
+
+    iterator end() const noexcept{
+        return root().end();
+    }
+
+private:
+    cJSON *root_=nullptr;
+};
+
+}
+
+#endif
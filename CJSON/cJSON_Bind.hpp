@@ -0,0 +1,766 @@
+#ifndef cJSON_Bind_hpp
+#define cJSON_Bind_hpp
+
+/* Compile time binding of C++ structs to JSON objects. A binding lists the
+ * members of a struct with their keys:
+ *
+ *     struct point{ double x; double y; std::optional<std::string> label; };
+ *     CJSON_BINDING(point,CJSON_FIELD(point,x),CJSON_FIELD(point,y),CJSON_FIELD(point,label))
+ *
+ * cjson::from_json fills a struct straight from the text and cjson::to_json
+ * writes it straight to a string,neither builds cJSON items. Supported member
+ * types are bool,integral and floating point numbers,std::string,std::optional,
+ * std::vector,other bound structs,and cjson::document for parts without a fixed
+ * shape,which are parsed by cJSON_ParseWithFlags. Members missing from the input
+ * keep their value unless they are declared with CJSON_REQUIRED,values of unknown
+ * keys are checked and skipped without being decoded. Numbers that do not fit the
+ * member type fail the parse.
+ * The text is read by a pull reader of its own rather than through the C parser:
+ * cJSON's parser has no event interface and builds every item as it reads it,so
+ * binding through it would allocate the very tree this avoids. */
+
+#include"cJSON.hpp"
+
+#include<array>
+#include<charconv>
+#include<cmath>
+#include<cstddef>
+#include<cstdint>
+#include<cstring>
+#include<limits>
+#include<optional>
+#include<string>
+#include<string_view>
+#include<tuple>
+#include<type_traits>
+#include<utility>
+#include<vector>
+
+namespace cjson{
+
+//specialize with a constexpr tuple of fields,usually through CJSON_BINDING
+template<typename T>
+struct binding;
+
+template<typename Class,typename Member>
+struct field_t{
+    using class_type=Class;
+    using member_type=Member;
+
+    std::string_view key;
+    Member Class::*member;
+    bool required;
+};
+
+template<typename Class,typename Member>
+constexpr field_t<Class,Member> field(std::string_view key,Member Class::*member,const bool required=false) noexcept{
+    return field_t<Class,Member>{key,member,required};
+}
+
+#define CJSON_FIELD(type,member) ::cjson::field(#member,&type::member)
+#define CJSON_REQUIRED(type,member) ::cjson::field(#member,&type::member,true)
+#define CJSON_BINDING(type,...) \
+    template<> struct cjson::binding<type>{ \
+        static constexpr auto fields=std::make_tuple(__VA_ARGS__); \
+    };
+
+namespace detail{
+
+template<typename T,typename=void>
+struct is_bound:std::false_type{};
+template<typename T>
+struct is_bound<T,std::void_t<decltype(binding<T>::fields)>>:std::true_type{};
+
+template<typename T>
+struct is_optional:std::false_type{};
+template<typename T>
+struct is_optional<std::optional<T>>:std::true_type{};
+
+template<typename T>
+struct is_vector:std::false_type{};
+template<typename T,typename Allocator>
+struct is_vector<std::vector<T,Allocator>>:std::true_type{};
+
+template<typename T>
+inline constexpr bool unsupported_type=false;
+
+/* Object layout computed at compile time from a binding: the keys in member
+ * order and the mask of required members. */
+template<typename T>
+struct layout{
+    static constexpr std::size_t count=std::tuple_size_v<std::decay_t<decltype(binding<T>::fields)>>;
+    static_assert(count<=64,"cjson: a binding has at most 64 members");
+
+    static constexpr std::array<std::string_view,count> keys=std::apply([](const auto&...fields){
+        return std::array<std::string_view,count>{fields.key...};
+    },binding<T>::fields);
+
+    static constexpr std::uint64_t required=std::apply([](const auto&...fields){
+        std::uint64_t mask=0;
+        std::size_t index=0;
+        ((mask|=(fields.required?(std::uint64_t)1<<index:0),index++),...);
+        return mask;
+    },binding<T>::fields);
+
+    //index of the member named key,count if there is none. The member after the
+    //previous one is tried first,since members usually arrive in declaration order.
+    static std::size_t find(std::string_view key,const std::size_t expected) noexcept{
+        if((expected<count)&&(keys[expected]==key)){
+            return expected;
+        }
+        for(std::size_t index=0;index<count;index++){
+            if(keys[index]==key){
+                return index;
+            }
+        }
+        return count;
+    }
+
+    //call function with the field at index
+    template<typename Function>
+    static void visit(const std::size_t index,Function&&function){
+        visit(index,function,std::make_index_sequence<count>());
+    }
+
+    template<typename Function,std::size_t...Index>
+    static void visit(const std::size_t index,Function&function,std::index_sequence<Index...>){
+        (void)(((index==Index)?(function(std::get<Index>(binding<T>::fields)),true):false)||...);
+    }
+};
+
+/* Longest text std::to_chars writes for a T: the sign and digits of an integer,
+ * or sign,significant digits,'.','e' and the exponent of a floating point number,
+ * counting the exponents of subnormals. */
+template<typename T>
+constexpr std::size_t chars_length() noexcept{
+    if constexpr(std::is_integral_v<T>){
+        return (std::size_t)std::numeric_limits<T>::digits10+3;
+    }else{
+        std::size_t exponent_digits=1;
+        for(int exponent=std::numeric_limits<T>::max_exponent10+std::numeric_limits<T>::max_digits10;exponent>=10;exponent/=10){
+            exponent_digits++;
+        }
+        return (std::size_t)std::numeric_limits<T>::max_digits10+exponent_digits+4;
+    }
+}
+
+inline bool is_whitespace(const char c) noexcept{
+    return (c==' ')||(c=='\t')||(c=='\r')||(c=='\n');
+}
+
+inline unsigned parse_hex4(const char*const input) noexcept{
+    unsigned h=0;
+    for(int i=0;i<4;i++){
+        const char c=input[i];
+        h<<=4;
+        if((c>='0')&&(c<='9')){
+            h+=(unsigned)(c-'0');
+        }else if((c>='A')&&(c<='F')){
+            h+=(unsigned)(10+c-'A');
+        }else if((c>='a')&&(c<='f')){
+            h+=(unsigned)(10+c-'a');
+        }else{
+            return 0x110000;//not a hex digit
+        }
+    }
+    return h;
+}
+
+inline void append_utf8(std::string&out,const unsigned long codepoint){
+    if(codepoint<0x80){
+        out+=(char)codepoint;
+    }else if(codepoint<0x800){
+        out+=(char)(0xC0|(codepoint>>6));
+        out+=(char)(0x80|(codepoint&0x3F));
+    }else if(codepoint<0x10000){
+        out+=(char)(0xE0|(codepoint>>12));
+        out+=(char)(0x80|((codepoint>>6)&0x3F));
+        out+=(char)(0x80|(codepoint&0x3F));
+    }else{
+        out+=(char)(0xF0|(codepoint>>18));
+        out+=(char)(0x80|((codepoint>>12)&0x3F));
+        out+=(char)(0x80|((codepoint>>6)&0x3F));
+        out+=(char)(0x80|(codepoint&0x3F));
+    }
+}
+
+//pull reader over a text that need not be '\0' terminated
+class reader{
+public:
+    reader(const char*begin,const char*end) noexcept:begin_(begin),position_(begin),end_(end){}
+
+    const char *position() const noexcept{
+        return position_;
+    }
+
+    //offset of the first error
+    std::size_t error_offset() const noexcept{
+        return (std::size_t)(((error_!=nullptr)?error_:position_)-begin_);
+    }
+
+    bool fail() noexcept{
+        if(error_==nullptr){
+            error_=position_;
+        }
+        return false;
+    }
+
+    void skip_whitespace() noexcept{
+        while((position_<end_)&&is_whitespace(*position_)){
+            position_++;
+        }
+    }
+
+    //only whitespace is left,a '\0' counted in the text may be its last byte
+    bool at_end() noexcept{
+        skip_whitespace();
+        return (position_==end_)||((*position_=='\0')&&(position_+1==end_));
+    }
+
+    bool peek(const char c) noexcept{
+        skip_whitespace();
+        return (position_<end_)&&(*position_==c);
+    }
+
+    bool consume(const char c) noexcept{
+        if(!peek(c)){
+            return false;
+        }
+        position_++;
+        return true;
+    }
+
+    bool consume_literal(std::string_view literal) noexcept{
+        skip_whitespace();
+        if(((std::size_t)(end_-position_)<literal.size())||(std::memcmp(position_,literal.data(),literal.size())!=0)){
+            return false;
+        }
+        position_+=literal.size();
+        return true;
+    }
+
+    //end of the string starting at the opening quote at position,nullptr if unterminated
+    const char *string_end(bool*const escaped) const noexcept{
+        const char *quote=position_+1;
+        for(;;){
+            quote=(const char*)std::memchr(quote,'\"',(std::size_t)(end_-quote));
+            if(quote==nullptr){
+                return nullptr;
+            }
+            //the quote ends the string unless an odd number of backslashes precede it
+            std::size_t backslashes=0;
+            while((quote-backslashes-1>position_)&&(quote[-(std::ptrdiff_t)backslashes-1]=='\\')){
+                backslashes++;
+            }
+            if((backslashes&1)==0){
+                break;
+            }
+            quote++;
+        }
+        if(escaped!=nullptr){
+            *escaped=std::memchr(position_+1,'\\',(std::size_t)(quote-position_-1))!=nullptr;
+        }
+        return quote;
+    }
+
+    /* Decode the escape sequence after the backslash at input into codepoint and
+     * leave input on its last character. On error position is moved there. */
+    bool read_escape(const char*&input,const char*const end,unsigned long&codepoint) noexcept{
+        input++;
+        switch(*input)
+        {
+        case 'b': codepoint='\b'; return true;
+        case 'f': codepoint='\f'; return true;
+        case 'n': codepoint='\n'; return true;
+        case 'r': codepoint='\r'; return true;
+        case 't': codepoint='\t'; return true;
+        case '\"':
+        case '\\':
+        case '/':
+            codepoint=(unsigned char)*input;
+            return true;
+        case 'u':
+            if(end-input<5){
+                break;
+            }
+            codepoint=parse_hex4(input+1);
+            input+=4;
+            if((codepoint>=0xDC00)&&(codepoint<=0xDFFF)){
+                break;
+            }
+            if((codepoint>=0xD800)&&(codepoint<=0xDBFF)){
+                //utf16 surrogate pair
+                unsigned long second=0;
+                if((end-input<7)||(input[1]!='\\')||(input[2]!='u')){
+                    break;
+                }
+                second=parse_hex4(input+3);
+                input+=6;
+                if((second<0xDC00)||(second>0xDFFF)){
+                    break;
+                }
+                codepoint=0x10000+(((codepoint&0x3FF)<<10)|(second&0x3FF));
+                return true;
+            }
+            if(codepoint<=0xFFFF){
+                return true;
+            }
+            break;
+        default:
+            break;
+        }
+        position_=input;
+        return fail();
+    }
+
+    /* Read a string. Without escapes the result is a view into the text,otherwise
+     * it is decoded into scratch. */
+    bool read_string(std::string_view&result,std::string&scratch){
+        bool escaped=false;
+        const char *end=nullptr;
+
+        if(!peek('\"')){
+            return fail();
+        }
+        end=string_end(&escaped);
+        if(end==nullptr){
+            return fail();
+        }
+        if(!escaped){
+            result=std::string_view(position_+1,(std::size_t)(end-position_-1));
+            position_=end+1;
+            return true;
+        }
+
+        scratch.clear();
+        for(const char *input=position_+1;input<end;input++){
+            unsigned long codepoint=0;
+            if(*input!='\\'){
+                scratch+=*input;
+                continue;
+            }
+            if(!read_escape(input,end,codepoint)){
+                return false;
+            }
+            append_utf8(scratch,codepoint);
+        }
+        result=scratch;
+        position_=end+1;
+        return true;
+    }
+
+    //pass over a string,checking its escapes; nothing is copied or written
+    bool skip_string() noexcept{
+        bool escaped=false;
+        const char *end=nullptr;
+        const char *input=nullptr;
+
+        if(!peek('\"')){
+            return fail();
+        }
+        end=string_end(&escaped);
+        if(end==nullptr){
+            return fail();
+        }
+        input=position_+1;
+        while(escaped&&((input=(const char*)std::memchr(input,'\\',(std::size_t)(end-input)))!=nullptr)){
+            unsigned long codepoint=0;
+            if(!read_escape(input,end,codepoint)){
+                return false;
+            }
+            input++;
+        }
+        position_=end+1;
+        return true;
+    }
+
+    //number token at position,checked against the JSON grammar
+    bool number_token(std::string_view&token) noexcept{
+        const char *input=position_;
+
+        skip_whitespace();
+        input=position_;
+        if((input<end_)&&(*input=='-')){
+            input++;
+        }
+        if((input<end_)&&(*input=='0')){
+            input++;
+        }else if((input<end_)&&(*input>='1')&&(*input<='9')){
+            while((input<end_)&&(*input>='0')&&(*input<='9')){
+                input++;
+            }
+        }else{
+            return fail();
+        }
+        if((input<end_)&&(*input=='.')){
+            input++;
+            if((input==end_)||(*input<'0')||(*input>'9')){
+                return fail();
+            }
+            while((input<end_)&&(*input>='0')&&(*input<='9')){
+                input++;
+            }
+        }
+        if((input<end_)&&((*input=='e')||(*input=='E'))){
+            input++;
+            if((input<end_)&&((*input=='+')||(*input=='-'))){
+                input++;
+            }
+            if((input==end_)||(*input<'0')||(*input>'9')){
+                return fail();
+            }
+            while((input<end_)&&(*input>='0')&&(*input<='9')){
+                input++;
+            }
+        }
+        token=std::string_view(position_,(std::size_t)(input-position_));
+        position_=input;
+        return true;
+    }
+
+    /* Skip any value,checked against the JSON grammar like the values that are
+     * read,so unknown members cannot hide invalid text. */
+    bool skip_value(const std::size_t depth){
+        std::string_view number;
+
+        skip_whitespace();
+        if(position_==end_){
+            return fail();
+        }
+        switch(*position_)
+        {
+        case '\"':
+            return skip_string();
+        case '[':
+            if(depth>=CJSON_NESTING_LIMIT){
+                return fail();
+            }
+            position_++;
+            if(consume(']')){
+                return true;
+            }
+            do{
+                if(!skip_value(depth+1)){
+                    return false;
+                }
+            }while(consume(','));
+            return consume(']')||fail();
+        case '{':
+            if(depth>=CJSON_NESTING_LIMIT){
+                return fail();
+            }
+            position_++;
+            if(consume('}')){
+                return true;
+            }
+            do{
+                if(!skip_string()||!consume(':')){
+                    return fail();
+                }
+                if(!skip_value(depth+1)){
+                    return false;
+                }
+            }while(consume(','));
+            return consume('}')||fail();
+        case 't':
+            return consume_literal("true")||fail();
+        case 'f':
+            return consume_literal("false")||fail();
+        case 'n':
+            return consume_literal("null")||fail();
+        default:
+            return number_token(number);
+        }
+    }
+
+    /* In strict mode,used by the schema parser,objects must not contain unknown
+     * or escaped keys,so that the caller can fall back to the generic parser. */
+    template<bool Strict=false,typename T>
+    bool read(T&value,const std::size_t depth){
+        if constexpr(std::is_same_v<T,bool>){
+            if(consume_literal("true")){
+                value=true;
+                return true;
+            }
+            if(consume_literal("false")){
+                value=false;
+                return true;
+            }
+            return fail();
+        }else if constexpr(std::is_integral_v<T>){
+            std::string_view token;
+            if(!number_token(token)){
+                return false;
+            }
+            T integer{};
+            const std::from_chars_result result=std::from_chars(token.data(),token.data()+token.size(),integer);
+            if((result.ec==std::errc())&&(result.ptr==token.data()+token.size())){
+                value=integer;
+                return true;
+            }
+            //fraction or exponent,accept it if the number is integral and fits
+            double number=0;
+            const std::from_chars_result real=std::from_chars(token.data(),token.data()+token.size(),number);
+            if((real.ec!=std::errc())||(std::floor(number)!=number)||(number<(double)std::numeric_limits<T>::min())||!(number<(double)(std::numeric_limits<T>::max()/2+1)*2.0)){
+                position_=token.data();
+                return fail();
+            }
+            value=(T)number;
+            return true;
+        }else if constexpr(std::is_floating_point_v<T>){
+            std::string_view token;
+            if(!number_token(token)){
+                return false;
+            }
+            T number{};
+            if(std::from_chars(token.data(),token.data()+token.size(),number).ec!=std::errc()){
+                //out of the range of T
+                position_=token.data();
+                return fail();
+            }
+            value=number;
+            return true;
+        }else if constexpr(std::is_same_v<T,std::string>){
+            std::string_view string;
+            if(!read_string(string,value)){
+                return false;
+            }
+            if(string.data()!=value.data()){
+                value.assign(string.data(),string.size());
+            }
+            if constexpr(Strict){
+                //a cJSON string ends at its first '\0',so the schema parser's do too
+                const std::size_t terminator=value.find('\0');
+                if(terminator!=std::string::npos){
+                    value.resize(terminator);
+                }
+            }
+            return true;
+        }else if constexpr(is_optional<T>::value){
+            if(consume_literal("null")){
+                value.reset();
+                return true;
+            }
+            if(!value.has_value()){
+                value.emplace();
+            }
+            return read<Strict>(*value,depth);
+        }else if constexpr(is_vector<T>::value){
+            value.clear();
+            if(depth>=CJSON_NESTING_LIMIT){
+                return fail();
+            }
+            if(!consume('[')){
+                return fail();
+            }
+            if(consume(']')){
+                return true;
+            }
+            do{
+                value.emplace_back();
+                if(!read<Strict>(value.back(),depth+1)){
+                    return false;
+                }
+            }while(consume(','));
+            return consume(']')||fail();
+        }else if constexpr(is_bound<T>::value){
+            return read_object<Strict>(value,depth);
+        }else if constexpr(std::is_same_v<T,document>){
+            skip_whitespace();
+            const char *const start=position_;
+            if(!skip_value(depth)){
+                return false;
+            }
+            value.reset(cJSON_ParseWithFlags(start,(std::size_t)(position_-start),nullptr,0));
+            if(!value){
+                position_=start;
+                return fail();
+            }
+            return true;
+        }else{
+            static_assert(unsupported_type<T>,"cjson: member type has no JSON mapping");
+            return false;
+        }
+    }
+
+    template<bool Strict,typename T>
+    bool read_object(T&value,const std::size_t depth){
+        std::string_view key;
+        std::uint64_t seen=0;
+        std::size_t expected=0;
+
+        if(depth>=CJSON_NESTING_LIMIT){
+            return fail();
+        }
+        if(!consume('{')){
+            return fail();
+        }
+        if(consume('}')){
+            return ((layout<T>::required&~seen)==0)||fail();
+        }
+        do{
+            std::size_t index=0;
+            bool success=true;
+
+            if(!read_string(key,key_scratch_)){
+                return fail();
+            }
+            if(Strict&&(key.data()==key_scratch_.data())){
+                return fail();
+            }
+            if(!consume(':')){
+                return fail();
+            }
+            index=layout<T>::find(key,expected);
+            if(index<layout<T>::count){
+                layout<T>::visit(index,[&](const auto&field){
+                    success=read<Strict>(value.*(field.member),depth+1);
+                });
+                seen|=(std::uint64_t)1<<index;
+                expected=index+1;
+            }else if(Strict){
+                return fail();
+            }else{
+                success=skip_value(depth+1);
+            }
+            if(!success){
+                return false;
+            }
+        }while(consume(','));
+
+        if(!consume('}')){
+            return fail();
+        }
+
+        return ((layout<T>::required&~seen)==0)||fail();
+    }
+
+private:
+    const char *begin_;
+    const char *position_;
+    const char *end_;
+    const char *error_=nullptr;
+    std::string key_scratch_;
+};
+
+class writer{
+public:
+    explicit writer(std::string&output) noexcept:output_(output){}
+
+    void write_string(std::string_view string){
+        const char *chunk=string.data();
+
+        output_+='\"';
+        for(const char &c:string){
+            const unsigned char byte=(unsigned char)c;
+            if((byte>=0x20)&&(byte!='\"')&&(byte!='\\')){
+                continue;
+            }
+            output_.append(chunk,(std::size_t)(&c-chunk));
+            chunk=&c+1;
+            switch(byte)
+            {
+            case '\"': output_+="\\\""; break;
+            case '\\': output_+="\\\\"; break;
+            case '\b': output_+="\\b"; break;
+            case '\f': output_+="\\f"; break;
+            case '\n': output_+="\\n"; break;
+            case '\r': output_+="\\r"; break;
+            case '\t': output_+="\\t"; break;
+            default:
+            {
+                static const char hex[]="0123456789abcdef";
+                output_+="\\u00";
+                output_+=hex[byte>>4];
+                output_+=hex[byte&0xF];
+                break;
+            }
+            }
+        }
+        output_.append(chunk,(std::size_t)(string.data()+string.size()-chunk));
+        output_+='\"';
+    }
+
+    template<typename T>
+    void write(const T&value){
+        if constexpr(std::is_same_v<T,bool>){
+            output_+=value?"true":"false";
+        }else if constexpr(std::is_arithmetic_v<T>){
+            char number[chars_length<T>()];
+            if constexpr(std::is_floating_point_v<T>){
+                //like cJSON,NaN and infinity are printed as null
+                if(!std::isfinite(value)){
+                    output_+="null";
+                    return;
+                }
+            }
+            output_.append(number,std::to_chars(number,number+sizeof(number),value).ptr);
+        }else if constexpr(std::is_same_v<T,std::string>||std::is_same_v<T,std::string_view>){
+            write_string(value);
+        }else if constexpr(is_optional<T>::value){
+            if(value.has_value()){
+                write(*value);
+            }else{
+                output_+="null";
+            }
+        }else if constexpr(is_vector<T>::value){
+            output_+='[';
+            for(std::size_t i=0;i<value.size();i++){
+                if(i>0){
+                    output_+=',';
+                }
+                write(value[i]);
+            }
+            output_+=']';
+        }else if constexpr(is_bound<T>::value){
+            bool first=true;
+            output_+='{';
+            std::apply([&](const auto&...fields){
+                ((output_+=(first?"":","),first=false,write_string(fields.key),output_+=':',write(value.*(fields.member))),...);
+            },binding<T>::fields);
+            output_+='}';
+        }else if constexpr(std::is_same_v<T,document>){
+            char *printed=value?cJSON_PrintUnformatted(value.get()):nullptr;
+            output_+=(printed!=nullptr)?printed:"null";
+            cJSON_free(printed);
+        }else{
+            static_assert(unsupported_type<T>,"cjson: member type has no JSON mapping");
+        }
+    }
+
+private:
+    std::string &output_;
+};
+
+}
+
+/* Fill value from json. Only whitespace may follow the value. On failure value
+ * may be partially filled and error_offset,if given,is the position of the error. */
+template<typename T>
+bool from_json(std::string_view json,T&value,std::size_t*const error_offset=nullptr){
+    detail::reader reader(json.data(),json.data()+json.size());
+    const bool success=reader.read(value,0)&&(reader.at_end()||reader.fail());
+
+    if(!success&&(error_offset!=nullptr)){
+        *error_offset=reader.error_offset();
+    }
+
+    return success;
+}
+
+//append the JSON text of value to output
+template<typename T>
+void to_json(const T&value,std::string&output){
+    detail::writer(output).write(value);
+}
+
+template<typename T>
+std::string to_json(const T&value){
+    std::string output;
+    to_json(value,output);
+    return output;
+}
+
+}
+
+#endif
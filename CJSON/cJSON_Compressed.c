@@ -0,0 +1,332 @@
+#if !defined(_CRT_SECURE_NO_DEPRECATE)&&defined(_MSC_VER)
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include<string.h>
+#include<limits.h>
+
+#if defined(CJSON_ZLIB)
+#include<zlib.h>
+#endif
+#if defined(CJSON_ZSTD)
+#include<zstd.h>
+#endif
+
+#include"cJSON_Compressed.h"
+
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+//compressed input is read in blocks of this size
+#ifndef CJSON_DECOMPRESS_BLOCK
+#define CJSON_DECOMPRESS_BLOCK 65536
+#endif
+
+enum{
+    FORMAT_UNKNOWN,//not detected yet
+    FORMAT_PLAIN,
+    FORMAT_GZIP,//gzip or zlib
+    FORMAT_ZSTD,
+    FORMAT_UNSUPPORTED
+};
+
+struct cJSON_Decompressor
+{
+    cJSON_StreamReader read;
+    void *context;
+    int fd;
+    unsigned char *input;
+    size_t input_length;
+    size_t input_offset;
+    cJSON_bool end_of_input;
+    cJSON_bool in_frame;//inside a gzip member or zstd frame
+    cJSON_bool failed;
+    int format;
+#if defined(CJSON_ZLIB)
+    z_stream zlib;
+    cJSON_bool zlib_ready;
+#endif
+#if defined(CJSON_ZSTD)
+    ZSTD_DStream *zstd;
+#endif
+};
+
+//read more compressed input behind what is buffered,false on error
+static cJSON_bool fill_input(cJSON_Decompressor*const decompressor){
+    size_t received=0;
+
+    if(decompressor->input_offset==decompressor->input_length){
+        decompressor->input_offset=0;
+        decompressor->input_length=0;
+    }
+    if(decompressor->end_of_input||(decompressor->input_length==CJSON_DECOMPRESS_BLOCK)){
+        return true;
+    }
+
+    received=decompressor->read(decompressor->context,(char*)decompressor->input+decompressor->input_length,CJSON_DECOMPRESS_BLOCK-decompressor->input_length);
+    if(received==(size_t)-1){
+        return false;
+    }
+    if(received==0){
+        decompressor->end_of_input=true;
+    }
+    decompressor->input_length+=received;
+
+    return true;
+}
+
+//pick the decoder from the magic bytes at the start of the input
+static cJSON_bool detect_format(cJSON_Decompressor*const decompressor){
+    const unsigned char *const magic=decompressor->input;
+    size_t length=0;
+
+    while((decompressor->input_length<4)&&!decompressor->end_of_input){
+        if(!fill_input(decompressor)){
+            return false;
+        }
+    }
+    length=decompressor->input_length;
+
+    decompressor->format=FORMAT_PLAIN;
+    if((length>=2)&&(magic[0]==0x1F)&&(magic[1]==0x8B)){
+        decompressor->format=FORMAT_GZIP;
+    }else if((length>=2)&&((magic[0]&0x0F)==8)&&((magic[1]&0x20)==0)&&((((unsigned int)magic[0]<<8)|magic[1])%31==0)){
+        //a zlib header without preset dictionary,which no JSON text starts with
+        decompressor->format=FORMAT_GZIP;
+    }else if((length>=4)&&(magic[0]==0x28)&&(magic[1]==0xB5)&&(magic[2]==0x2F)&&(magic[3]==0xFD)){
+        decompressor->format=FORMAT_ZSTD;
+    }
+
+#if defined(CJSON_ZLIB)
+    if(decompressor->format==FORMAT_GZIP){
+        //15+32 detects a gzip or zlib header
+        if(inflateInit2(&decompressor->zlib,15+32)!=Z_OK){
+            return false;
+        }
+        decompressor->zlib_ready=true;
+    }
+#else
+    if(decompressor->format==FORMAT_GZIP){
+        decompressor->format=FORMAT_UNSUPPORTED;
+    }
+#endif
+#if defined(CJSON_ZSTD)
+    if(decompressor->format==FORMAT_ZSTD){
+        decompressor->zstd=ZSTD_createDStream();
+        if((decompressor->zstd==NULL)||ZSTD_isError(ZSTD_initDStream(decompressor->zstd))){
+            return false;
+        }
+    }
+#else
+    if(decompressor->format==FORMAT_ZSTD){
+        decompressor->format=FORMAT_UNSUPPORTED;
+    }
+#endif
+
+    return decompressor->format!=FORMAT_UNSUPPORTED;
+}
+
+#if defined(CJSON_ZLIB)
+static size_t inflate_block(cJSON_Decompressor*const decompressor,char*const buffer,const size_t size){
+    z_stream *const zlib=&decompressor->zlib;
+    int status=Z_OK;
+    size_t produced=0;
+
+    if(!decompressor->in_frame){
+        if(decompressor->input_offset==decompressor->input_length){
+            return 0;
+        }
+        //the next member of concatenated gzip input
+        if(inflateReset(zlib)!=Z_OK){
+            return (size_t)-1;
+        }
+        decompressor->in_frame=true;
+    }
+
+    zlib->next_in=decompressor->input+decompressor->input_offset;
+    zlib->avail_in=(uInt)(decompressor->input_length-decompressor->input_offset);
+    zlib->next_out=(Bytef*)buffer;
+    zlib->avail_out=(uInt)((size>UINT_MAX)?UINT_MAX:size);
+    status=inflate(zlib,Z_NO_FLUSH);
+    decompressor->input_offset=decompressor->input_length-zlib->avail_in;
+    produced=(size_t)((char*)zlib->next_out-buffer);
+
+    if(status==Z_STREAM_END){
+        decompressor->in_frame=false;
+    }else if((status!=Z_OK)&&(status!=Z_BUF_ERROR)){
+        return (size_t)-1;
+    }
+
+    return produced;
+}
+#endif
+
+#if defined(CJSON_ZSTD)
+static size_t zstd_block(cJSON_Decompressor*const decompressor,char*const buffer,const size_t size){
+    ZSTD_inBuffer input;
+    ZSTD_outBuffer output;
+    size_t status=0;
+
+    if(!decompressor->in_frame&&(decompressor->input_offset==decompressor->input_length)){
+        return 0;
+    }
+
+    input.src=decompressor->input;
+    input.size=decompressor->input_length;
+    input.pos=decompressor->input_offset;
+    output.dst=buffer;
+    output.size=size;
+    output.pos=0;
+
+    status=ZSTD_decompressStream(decompressor->zstd,&output,&input);
+    if(ZSTD_isError(status)){
+        return (size_t)-1;
+    }
+    decompressor->input_offset=input.pos;
+    //0 at the end of a frame,otherwise the decoder waits for more
+    decompressor->in_frame=(status!=0);
+
+    return output.pos;
+}
+#endif
+
+static cJSON_Decompressor *create_decompressor(void){
+    cJSON_Decompressor *decompressor=(cJSON_Decompressor*)cJSON_malloc(sizeof(cJSON_Decompressor));
+    if(decompressor==NULL){
+        return NULL;
+    }
+    memset(decompressor,0,sizeof(cJSON_Decompressor));
+    decompressor->fd=-1;
+    decompressor->format=FORMAT_UNKNOWN;
+
+    decompressor->input=(unsigned char*)cJSON_malloc(CJSON_DECOMPRESS_BLOCK);
+    if(decompressor->input==NULL){
+        cJSON_free(decompressor);
+        return NULL;
+    }
+
+    return decompressor;
+}
+
+CJSON_PUBLIC(cJSON_Decompressor*)cJSON_CreateDecompressor(cJSON_StreamReader read,void*context){
+    cJSON_Decompressor *decompressor=NULL;
+
+    if(read==NULL){
+        return NULL;
+    }
+
+    decompressor=create_decompressor();
+    if(decompressor==NULL){
+        return NULL;
+    }
+    decompressor->read=read;
+    decompressor->context=context;
+
+    return decompressor;
+}
+
+CJSON_PUBLIC(cJSON_Decompressor*)cJSON_CreateDecompressorFd(int fd){
+    cJSON_Decompressor *decompressor=NULL;
+
+    if(fd<0){
+        return NULL;
+    }
+
+    decompressor=cJSON_CreateDecompressor(cJSON_StreamReadFd,NULL);
+    if(decompressor==NULL){
+        return NULL;
+    }
+    decompressor->fd=fd;
+    decompressor->context=&decompressor->fd;
+
+    return decompressor;
+}
+
+CJSON_PUBLIC(size_t)cJSON_DecompressorRead(void*context,char*buffer,size_t size){
+    cJSON_Decompressor *const decompressor=(cJSON_Decompressor*)context;
+
+    if((decompressor==NULL)||(buffer==NULL)||decompressor->failed){
+        return (size_t)-1;
+    }
+    if(size==0){
+        return 0;
+    }
+    if((decompressor->format==FORMAT_UNKNOWN)&&!detect_format(decompressor)){
+        goto fail;
+    }
+
+    for(;;){
+        size_t produced=0;
+
+        if(!fill_input(decompressor)){
+            goto fail;
+        }
+
+        switch(decompressor->format){
+            case FORMAT_PLAIN:
+                produced=decompressor->input_length-decompressor->input_offset;
+                if(produced>size){
+                    produced=size;
+                }
+                memcpy(buffer,decompressor->input+decompressor->input_offset,produced);
+                decompressor->input_offset+=produced;
+                break;
+#if defined(CJSON_ZLIB)
+            case FORMAT_GZIP:
+                produced=inflate_block(decompressor,buffer,size);
+                break;
+#endif
+#if defined(CJSON_ZSTD)
+            case FORMAT_ZSTD:
+                produced=zstd_block(decompressor,buffer,size);
+                break;
+#endif
+            default:
+                produced=(size_t)-1;
+                break;
+        }
+        if(produced==(size_t)-1){
+            goto fail;
+        }
+        if(produced>0){
+            return produced;
+        }
+        if(decompressor->end_of_input&&(decompressor->input_offset==decompressor->input_length)){
+            //input that ends inside a member or frame is truncated
+            if(decompressor->in_frame){
+                goto fail;
+            }
+            return 0;
+        }
+    }
+
+fail:
+    decompressor->failed=true;
+
+    return (size_t)-1;
+}
+
+CJSON_PUBLIC(void)cJSON_DeleteDecompressor(cJSON_Decompressor*decompressor){
+    if(decompressor==NULL){
+        return;
+    }
+#if defined(CJSON_ZLIB)
+    if(decompressor->zlib_ready){
+        inflateEnd(&decompressor->zlib);
+    }
+#endif
+#if defined(CJSON_ZSTD)
+    if(decompressor->zstd!=NULL){
+        ZSTD_freeDStream(decompressor->zstd);
+    }
+#endif
+    cJSON_free(decompressor->input);
+    cJSON_free(decompressor);
+}
@@ -0,0 +1,38 @@
+#ifndef cJSON_Compressed_h
+#define cJSON_Compressed_h
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include"cJSON.h"
+
+/* Decompressing readers for array and record streams. Build cJSON_Compressed.c
+ * with CJSON_ZLIB (link zlib) for gzip and zlib input and with CJSON_ZSTD (link
+ * libzstd) for zstd input. The format is detected from the first bytes; input
+ * that is not compressed is passed through,and a format that was not built in
+ * is a read error. Concatenated gzip members and zstd frames are read in turn.
+ *
+ * Data is decompressed a block at a time into the stream's window,so memory use
+ * is bounded by the block size and the largest record,never the whole input:
+ *
+ *     cJSON_Decompressor *input=cJSON_CreateDecompressorFd(fd);
+ *     cJSON_ArrayStream *records=cJSON_CreateRecordStreamReader(cJSON_DecompressorRead,input,0);
+ *     while((record=cJSON_ArrayStreamNext(records))!=NULL){ ... }
+ *     cJSON_DeleteArrayStream(records);
+ *     cJSON_DeleteDecompressor(input);
+ *
+ * The decompressor reads from a reader like those of array streams,or from a file
+ * descriptor,which it does not close. */
+typedef struct cJSON_Decompressor cJSON_Decompressor;
+CJSON_PUBLIC(cJSON_Decompressor*)cJSON_CreateDecompressor(cJSON_StreamReader read,void *context);
+CJSON_PUBLIC(cJSON_Decompressor*)cJSON_CreateDecompressorFd(int fd);
+//a cJSON_StreamReader,context is the decompressor
+CJSON_PUBLIC(size_t)cJSON_DecompressorRead(void *context,char *buffer,size_t size);
+CJSON_PUBLIC(void)cJSON_DeleteDecompressor(cJSON_Decompressor *decompressor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef cJSON_Schema_hpp
+#define cJSON_Schema_hpp
+
+/* Parsers specialized for a fixed message shape. The shape is a binding from
+ * cJSON_Bind.hpp,which covers this subset of JSON Schema:
+ *
+ *     "type"       boolean,integer,number,string,array,object (from the member type)
+ *     "properties" the members of a binding
+ *     "required"   members declared with CJSON_REQUIRED
+ *     "items"      the element type of a std::vector
+ *     null         allowed for std::optional members
+ *
+ * cjson::json_schema<T>() prints the schema a binding stands for,so a binding
+ * can be checked against the schema it was written from.
+ *
+ * cjson::parse_with_schema<T>() first runs the reader specialized for T at
+ * compile time: keys are matched against a precomputed layout,trying the member
+ * after the previous one first,and numbers are converted straight to the member
+ * type. It only accepts the exact shape,without unknown or escaped keys. Any
+ * other input is handed to cJSON_ParseWithFlags and the tree is mapped onto T,
+ * so the result does not depend on which path was taken. Both paths follow the
+ * tree there: a string ends at its first '\0',written as \u0000 or not,and only
+ * whitespace may follow the value,with a '\0' allowed as the last byte. */
+
+#include"cJSON_Bind.hpp"
+
+#include<cstddef>
+#include<cstdint>
+#include<string>
+#include<string_view>
+#include<type_traits>
+
+namespace cjson{
+
+namespace detail{
+
+template<typename T>
+bool read_tree(const value item,T&result){
+    if constexpr(std::is_same_v<T,bool>){
+        if(!item.is_bool()){
+            return false;
+        }
+        result=item.is_true();
+        return true;
+    }else if constexpr(std::is_arithmetic_v<T>){
+        const std::optional<T> number=item.get<T>();
+        if(!number){
+            return false;
+        }
+        result=*number;
+        return true;
+    }else if constexpr(std::is_same_v<T,std::string>){
+        if(!item.is_string()){
+            return false;
+        }
+        result.assign(item.as_string());
+        return true;
+    }else if constexpr(is_optional<T>::value){
+        if(item.is_null()){
+            result.reset();
+            return true;
+        }
+        if(!result.has_value()){
+            result.emplace();
+        }
+        return read_tree(item,*result);
+    }else if constexpr(is_vector<T>::value){
+        result.clear();
+        if(!item.is_array()){
+            return false;
+        }
+        for(const value element:item){
+            result.emplace_back();
+            if(!read_tree(element,result.back())){
+                return false;
+            }
+        }
+        return true;
+    }else if constexpr(is_bound<T>::value){
+        std::uint64_t seen=0;
+        std::size_t expected=0;
+        bool success=true;
+
+        if(!item.is_object()){
+            return false;
+        }
+        for(const value member:item){
+            const std::size_t index=layout<T>::find(member.name(),expected);
+            if(index==layout<T>::count){
+                continue;
+            }
+            layout<T>::visit(index,[&](const auto&field){
+                success=read_tree(member,result.*(field.member));
+            });
+            if(!success){
+                return false;
+            }
+            seen|=(std::uint64_t)1<<index;
+            expected=index+1;
+        }
+        return (layout<T>::required&~seen)==0;
+    }else if constexpr(std::is_same_v<T,document>){
+        result.reset(cJSON_Duplicate(item.get(),true));
+        return static_cast<bool>(result);
+    }else{
+        static_assert(unsupported_type<T>,"cjson: member type has no JSON mapping");
+        return false;
+    }
+}
+
+class schema_writer{
+public:
+    explicit schema_writer(std::string&output) noexcept:output_(output){}
+
+    template<typename T>
+    void write(const bool nullable=false){
+        if constexpr(is_optional<T>::value){
+            write<typename T::value_type>(true);
+        }else if constexpr(std::is_same_v<T,document>){
+            output_+="{}";
+        }else{
+            output_+="{\"type\":";
+            if(nullable){
+                output_+='[';
+            }
+            output_+=type_name<T>();
+            if(nullable){
+                output_+=",\"null\"]";
+            }
+            if constexpr(is_vector<T>::value){
+                output_+=",\"items\":";
+                write<typename T::value_type>();
+            }else if constexpr(is_bound<T>::value){
+                bool first=true;
+                output_+=",\"properties\":{";
+                std::apply([&](const auto&...fields){
+                    ((output_+=(first?"":","),first=false,writer(output_).write_string(fields.key),output_+=':',write<member_type<decltype(fields)>>()),...);
+                },binding<T>::fields);
+                output_+='}';
+                if(layout<T>::required!=0){
+                    first=true;
+                    output_+=",\"required\":[";
+                    std::apply([&](const auto&...fields){
+                        ((fields.required?(output_+=(first?"":","),first=false,writer(output_).write_string(fields.key)):void()),...);
+                    },binding<T>::fields);
+                    output_+=']';
+                }
+            }
+            output_+='}';
+        }
+    }
+
+private:
+    template<typename Field>
+    using member_type=typename std::decay_t<Field>::member_type;
+
+    template<typename T>
+    static const char *type_name() noexcept{
+        if constexpr(std::is_same_v<T,bool>){
+            return "\"boolean\"";
+        }else if constexpr(std::is_integral_v<T>){
+            return "\"integer\"";
+        }else if constexpr(std::is_floating_point_v<T>){
+            return "\"number\"";
+        }else if constexpr(std::is_same_v<T,std::string>){
+            return "\"string\"";
+        }else if constexpr(is_vector<T>::value){
+            return "\"array\"";
+        }else if constexpr(is_bound<T>::value){
+            return "\"object\"";
+        }else{
+            static_assert(unsupported_type<T>,"cjson: member type has no JSON mapping");
+            return "";
+        }
+    }
+
+    std::string &output_;
+};
+
+}
+
+/* Parse json into value through the reader specialized for T,falling back to
+ * cJSON_ParseWithFlags for input of another shape. On failure error_offset,if
+ * given,is the position of the error. */
+template<typename T>
+bool parse_with_schema(std::string_view json,T&value,std::size_t*const error_offset=nullptr){
+    {
+        detail::reader reader(json.data(),json.data()+json.size());
+        if(reader.read<true>(value,0)&&reader.at_end()){
+            return true;
+        }
+    }
+
+    const char *end=nullptr;
+    //lazy numbers keep every digit of a 64 bit member,as the reader does
+    document tree(cJSON_ParseWithFlags(json.data(),json.size(),&end,cJSON_ParseLazyNumbers));
+    if(tree){
+        //only whitespace may follow the value
+        detail::reader rest(end,json.data()+json.size());
+        if(!rest.at_end()){
+            end=rest.position();
+            tree.reset();
+        }
+    }
+    if(!tree){
+        if(error_offset!=nullptr){
+            *error_offset=(end!=nullptr)?(std::size_t)(end-json.data()):0;
+        }
+        return false;
+    }
+    if(!detail::read_tree(tree.root(),value)){
+        //the text is valid JSON of the wrong shape,which has no position
+        if(error_offset!=nullptr){
+            *error_offset=0;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+//the JSON Schema of the subset above that T stands for
+template<typename T>
+std::string json_schema(){
+    std::string output;
+    detail::schema_writer(output).write<T>();
+    return output;
+}
+
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef cJSON_test_h
+#define cJSON_test_h
+
+/* Each test is a plain program built against the library,for example
+ *   cc -std=gnu99 test_validate.c ../cJSON..c -lm -pthread
+ * The C++ tests link the library compiled as C:
+ *   cc -std=gnu99 -c ../cJSON..c -o cJSON.o
+ *   c++ -std=c++17 test_cpp.cpp cJSON.o -lm -pthread
+ * A test prints every check that fails and exits non-zero if there was one. */
+
+#include<stdio.h>
+#include<string.h>
+
+static int test_failures=0;
+
+#define check(condition) do{\
+    if(!(condition)){\
+        fprintf(stderr,"%s:%d: check failed: %s\n",__FILE__,__LINE__,#condition);\
+        test_failures++;\
+    }\
+}while(0)
+
+//exit status of main
+#define test_result() ((test_failures==0)?0:1)
+
+#endif
@@ -0,0 +1,101 @@
+#include"test.h"
+#include"../cJSON_Bind.hpp"
+
+#include<cstdint>
+#include<cstdlib>
+#include<limits>
+#include<optional>
+#include<string>
+#include<string_view>
+#include<vector>
+
+using namespace std::string_view_literals;
+
+struct point{
+    double x;
+    double y;
+    std::optional<std::string> label;
+};
+CJSON_BINDING(point,CJSON_REQUIRED(point,x),CJSON_REQUIRED(point,y),CJSON_FIELD(point,label))
+
+struct counters{
+    std::int8_t small;
+    std::int64_t big;
+    unsigned count;
+    std::vector<point> points;
+};
+CJSON_BINDING(counters,CJSON_FIELD(counters,small),CJSON_FIELD(counters,big),CJSON_FIELD(counters,count),CJSON_FIELD(counters,points))
+
+struct wide{
+    long double value;
+};
+CJSON_BINDING(wide,CJSON_FIELD(wide,value))
+
+static void test_trailing_bytes(){
+    point p{};
+    std::size_t error_offset=0;
+
+    check(cjson::from_json(R"({"x":1,"y":2} )"sv,p));
+    check(cjson::from_json("{\"x\":1,\"y\":2}\0"sv,p));
+    //a '\0' may only be the last byte
+    check(!cjson::from_json("{\"x\":1,\"y\":2}\0garbage"sv,p,&error_offset));
+    check(error_offset==13);
+    check(!cjson::from_json("{\"x\":1,\"y\":2}\0\0"sv,p));
+    check(!cjson::from_json(R"({"x":1,"y":2} x)"sv,p));
+}
+
+static void test_unknown_members(){
+    point p{};
+
+    check(cjson::from_json(R"({"x":1,"skip":{"a":["é😀\"\\",{"b":null}]},"y":2,"n":-1.5e3})"sv,p));
+    check((p.x==1)&&(p.y==2));
+    //skipped values are checked like read ones
+    check(!cjson::from_json(R"({"x":1,"y":2,"skip":"\x"})"sv,p));
+    check(!cjson::from_json(R"({"x":1,"y":2,"skip":"\u12"})"sv,p));
+    check(!cjson::from_json(R"({"x":1,"y":2,"skip":"\udc00"})"sv,p));
+    check(!cjson::from_json(R"({"x":1,"y":2,"skip":"\ud800x"})"sv,p));
+    check(!cjson::from_json(R"({"x":1,"y":2,"skip":[1,]})"sv,p));
+    check(!cjson::from_json(R"({"x":1,"y":2,"skip":01})"sv,p));
+    check(!cjson::from_json(R"({"x":1,"y":2,"\q":1})"sv,p));
+    //required members
+    check(!cjson::from_json(R"({"x":1})"sv,p));
+}
+
+static void test_numbers(){
+    counters c{};
+
+    check(cjson::from_json(R"({"small":-128,"big":9007199254740993,"count":2e0})"sv,c));
+    check((c.small==-128)&&(c.big==9007199254740993LL)&&(c.count==2));
+    check(!cjson::from_json(R"({"small":128})"sv,c));
+    check(!cjson::from_json(R"({"count":-1})"sv,c));
+    check(!cjson::from_json(R"({"count":2.5})"sv,c));
+    check(!cjson::from_json(R"({"big":1e19})"sv,c));
+    check(!cjson::from_json(R"({"points":[{"x":1e999,"y":0}]})"sv,c));
+    check(!cjson::from_json(R"({"small":1.})"sv,c));
+}
+
+//the widest values of a long double print in full and read back
+static void test_wide_numbers(){
+    const long double values[]={std::numeric_limits<long double>::lowest(),-std::numeric_limits<long double>::min(),std::numeric_limits<long double>::denorm_min()};
+
+    for(const long double value:values){
+        wide w{value};
+        wide back{};
+        const std::string text=cjson::to_json(w);
+        check(text.size()<64);
+        check(std::strtold(text.c_str()+9,nullptr)==value);
+        //from_chars reports subnormals as out of range
+        if(value!=std::numeric_limits<long double>::denorm_min()){
+            check(cjson::from_json(text,back)&&(back.value==value));
+        }
+    }
+}
+
+int main(){
+    test_trailing_bytes();
+    test_unknown_members();
+    test_numbers();
+    test_wide_numbers();
+
+    return test_result();
+}
@@ -0,0 +1,119 @@
+#include"test.h"
+#include"../cJSON.h"
+
+static const char rows[]=
+    "[{\"id\":1,\"name\":\"ann\",\"score\":1.5,\"ok\":true,\"geo\":{\"lat\":2}},"
+    "{\"id\":9007199254740993,\"name\":\"b\\u00e9\",\"score\":\"x\",\"ok\":false},"
+    "{\"id\":2.5,\"name\":null,\"ok\":null,\"score\":3},"
+    "{}]";
+
+static int row_valid(const cJSON_Column*const column,const size_t row){
+    return (column->validity[row/8]&(1U<<(row%8)))!=0;
+}
+
+static cJSON_Columns *create_columns(void){
+    cJSON_Columns *const columns=cJSON_CreateColumns(0);
+
+    check(cJSON_ColumnsAdd(columns,"/id",cJSON_ColumnInt64)==0);
+    check(cJSON_ColumnsAdd(columns,"/name",cJSON_ColumnString)==1);
+    check(cJSON_ColumnsAdd(columns,"/score",cJSON_ColumnDouble)==2);
+    check(cJSON_ColumnsAdd(columns,"/ok",cJSON_ColumnBool)==3);
+    check(cJSON_ColumnsAdd(columns,"/geo/lat",cJSON_ColumnDouble)==4);
+
+    return columns;
+}
+
+static void test_extract(void){
+    cJSON_Columns *const columns=create_columns();
+    cJSON_Column column;
+    const long long *ids=NULL;
+    const double *scores=NULL;
+
+    check(cJSON_ColumnsExtract(columns,rows,strlen(rows),NULL));
+    check(cJSON_ColumnsRows(columns)==4);
+
+    //64 bit ids keep every digit,2.5 is not an int64
+    check(cJSON_ColumnsGet(columns,0,&column));
+    ids=(const long long*)column.values;
+    check((column.type==cJSON_ColumnInt64)&&(column.length==4)&&(column.null_count==2));
+    check(row_valid(&column,0)&&row_valid(&column,1)&&!row_valid(&column,2)&&!row_valid(&column,3));
+    check((ids[0]==1)&&(ids[1]==9007199254740993LL));
+
+    //strings as offsets into UTF-8 data
+    check(cJSON_ColumnsGet(columns,1,&column));
+    check((column.null_count==2)&&(column.values==NULL));
+    check((column.offsets[0]==0)&&(column.offsets[1]==3)&&(column.offsets[2]==6)&&(column.offsets[3]==6)&&(column.offsets[4]==6));
+    check((column.data_length==6)&&(memcmp(column.data,"ann" "b\xC3\xA9",6)==0));
+
+    check(cJSON_ColumnsGet(columns,2,&column));
+    scores=(const double*)column.values;
+    check(row_valid(&column,0)&&!row_valid(&column,1)&&row_valid(&column,2)&&!row_valid(&column,3));
+    check((scores[0]==1.5)&&(scores[2]==3));
+
+    //booleans as bits,a null is not valid
+    check(cJSON_ColumnsGet(columns,3,&column));
+    check(row_valid(&column,0)&&row_valid(&column,1)&&!row_valid(&column,2));
+    check((((const unsigned char*)column.values)[0]&3)==1);
+
+    //nested paths
+    check(cJSON_ColumnsGet(columns,4,&column));
+    check((column.null_count==3)&&row_valid(&column,0)&&(((const double*)column.values)[0]==2));
+
+    check(!cJSON_ColumnsGet(columns,5,&column));
+    cJSON_DeleteColumns(columns);
+}
+
+//values of another type are null and reported with their row and column
+static void test_mismatches(void){
+    cJSON_Columns *const columns=create_columns();
+    const cJSON_ColumnMismatch *mismatches=NULL;
+    size_t count=0;
+
+    check(cJSON_ColumnsExtract(columns,rows,strlen(rows),NULL));
+    mismatches=cJSON_ColumnsMismatches(columns,&count);
+    check(count==2);
+    check((mismatches[0].row==1)&&(mismatches[0].column==2)&&(mismatches[0].type==cJSON_String));
+    check((mismatches[1].row==2)&&(mismatches[1].column==0)&&(mismatches[1].type==cJSON_Number));
+
+    cJSON_DeleteColumns(columns);
+}
+
+//extractions append rows,a failed one adds none,clearing starts over
+static void test_append_and_clear(void){
+    static const char invalid[]="[{\"id\":1},";
+    static const char more[]="[{\"id\":7}]";
+    cJSON_Columns *const columns=create_columns();
+    cJSON_Column column;
+    size_t error_offset=0;
+
+    check(cJSON_ColumnsExtract(columns,rows,strlen(rows),NULL));
+    check(!cJSON_ColumnsExtract(columns,invalid,strlen(invalid),&error_offset));
+    //an error at the end of the input points at its last byte
+    check(error_offset==strlen(invalid)-1);
+    check(cJSON_ColumnsRows(columns)==4);
+
+    check(cJSON_ColumnsExtract(columns,more,strlen(more),NULL));
+    check(cJSON_ColumnsRows(columns)==5);
+    check(cJSON_ColumnsGet(columns,0,&column));
+    check(row_valid(&column,4)&&(((const long long*)column.values)[4]==7));
+    check(cJSON_ColumnsGet(columns,1,&column));
+    check((column.length==5)&&(column.offsets[5]==6)&&!row_valid(&column,4));
+
+    //no columns after the first extraction
+    check(cJSON_ColumnsAdd(columns,"/late",cJSON_ColumnDouble)==-1);
+
+    cJSON_ColumnsClear(columns);
+    check(cJSON_ColumnsRows(columns)==0);
+    check(cJSON_ColumnsExtract(columns,more,strlen(more),NULL));
+    check(cJSON_ColumnsRows(columns)==1);
+
+    cJSON_DeleteColumns(columns);
+}
+
+int main(void){
+    test_extract();
+    test_mismatches();
+    test_append_and_clear();
+
+    return test_result();
+}
@@ -0,0 +1,120 @@
+#include"test.h"
+#include"../cJSON.h"
+
+#include<pthread.h>
+
+static void test_equal_documents(void){
+    cJSON *const a=cJSON_Parse("{\"name\":\"x\",\"list\":[1,2,{\"k\":0}],\"Flag\":true}");
+    cJSON *const reordered=cJSON_Parse("{\"Flag\":true,\"list\":[1,2,{\"k\":-0}],\"name\":\"x\"}");
+    cJSON *const folded=cJSON_Parse("{\"NAME\":\"x\",\"list\":[1,2,{\"K\":0}],\"flag\":true}");
+    cJSON *const swapped=cJSON_Parse("{\"name\":\"x\",\"list\":[2,1,{\"k\":0}],\"Flag\":true}");
+
+    //member order does not matter,array order does
+    check(cJSON_Compare(a,reordered,1));
+    check(cJSON_Digest(a)==cJSON_Digest(reordered));
+    check(!cJSON_Compare(a,swapped,1));
+    check(cJSON_Digest(a)!=cJSON_Digest(swapped));
+    //one digest serves both modes
+    check(!cJSON_Compare(a,folded,1));
+    check(cJSON_Compare(a,folded,0));
+    check(cJSON_Digest(a)==cJSON_Digest(folded));
+    //a cached digest gives the same answers
+    check(cJSON_Compare(reordered,a,1));
+    check(!cJSON_Compare(swapped,a,1));
+    check(!cJSON_Compare(a,NULL,1));
+    check(cJSON_Digest(NULL)==0);
+
+    cJSON_Delete(a);
+    cJSON_Delete(reordered);
+    cJSON_Delete(folded);
+    cJSON_Delete(swapped);
+}
+
+//a change anywhere below a compared item drops its cached digest
+static void test_changes(void){
+    cJSON *const a=cJSON_Parse("{\"deep\":{\"list\":[1,2]},\"n\":1}");
+    cJSON *const b=cJSON_Parse("{\"deep\":{\"list\":[1,2]},\"n\":1}");
+    cJSON *const list=cJSON_getObjectItem(cJSON_getObjectItem(b,"deep"),"list");
+    const unsigned long long digest=cJSON_Digest(b);
+
+    check(cJSON_Compare(a,b,1));
+    cJSON_AddItemToArray(list,cJSON_CreateNumber(3));
+    check(cJSON_Digest(b)!=digest);
+    check(!cJSON_Compare(a,b,1));
+    cJSON_DeleteItemFromArray(list,2);
+    check(cJSON_Digest(b)==digest);
+    check(cJSON_Compare(a,b,1));
+
+    cJSON_setNumberValue(cJSON_GetArrayItem(list,0),5);
+    check(!cJSON_Compare(a,b,1));
+    cJSON_setNumberValue(cJSON_GetArrayItem(list,0),1);
+    check(cJSON_Compare(a,b,1));
+
+    cJSON_ReplaceItemInObject(b,"n",cJSON_CreateString("1"));
+    check(!cJSON_Compare(a,b,1));
+    cJSON_ReplaceItemInObject(b,"n",cJSON_CreateNumber(1));
+    check(cJSON_Compare(a,b,1));
+
+    cJSON_Delete(cJSON_DetachItemFromObject(b,"deep"));
+    check(!cJSON_Compare(a,b,1));
+
+    cJSON_Delete(a);
+    cJSON_Delete(b);
+}
+
+//an item at the address of a deleted one is not taken for it
+static void test_reused_items(void){
+    int round=0;
+
+    for(round=0;round<100;round++){
+        cJSON *const a=cJSON_Parse((round%2==0)?"[1,2,3]":"[1,2,4]");
+        cJSON *const b=cJSON_Parse("[1,2,3]");
+
+        check(cJSON_Compare(a,b,1)==(round%2==0));
+        cJSON_Delete(a);
+        cJSON_Delete(b);
+    }
+}
+
+static cJSON *shared_document=NULL;
+
+static void *compare_in_thread(void*const other){
+    int round=0;
+
+    for(round=0;round<1000;round++){
+        if(!cJSON_Compare(shared_document,(const cJSON*)other,1)){
+            return other;
+        }
+    }
+
+    return NULL;
+}
+
+//threads comparing the same documents keep their own caches
+static void test_threads(void){
+    cJSON *const other=cJSON_Parse("{\"b\":[true,null],\"a\":1}");
+    pthread_t threads[4];
+    void *failed=NULL;
+    int index=0;
+
+    shared_document=cJSON_Parse("{\"a\":1,\"b\":[true,null]}");
+    for(index=0;index<4;index++){
+        check(pthread_create(&threads[index],NULL,compare_in_thread,other)==0);
+    }
+    for(index=0;index<4;index++){
+        check(pthread_join(threads[index],&failed)==0);
+        check(failed==NULL);
+    }
+
+    cJSON_Delete(shared_document);
+    cJSON_Delete(other);
+}
+
+int main(void){
+    test_equal_documents();
+    test_changes();
+    test_reused_items();
+    test_threads();
+
+    return test_result();
+}
@@ -0,0 +1,54 @@
+#include"test.h"
+#include"../cJSON.hpp"
+
+#include<string_view>
+
+using namespace std::string_view_literals;
+
+static void test_lookups(){
+    const cjson::document document=cjson::document::parse(R"({"a":[10,20,30],"b":{"c":"d"},"":1})");
+    const char *const missing=nullptr;
+
+    check(static_cast<bool>(document));
+    check(document["a"][1].as_int()==20);
+    check(document["a"][2u].as_int()==30);
+    check(document["a"][static_cast<unsigned char>(0)].as_int()==10);
+    check(!document["a"][-1]);
+    check(!document["a"][3]);
+    check(document["b"]["c"].as_string()=="d");
+    check(document[""].as_int()==1);
+    //a null key is a miss,not undefined behavior
+    check(!document[missing]);
+    check(!document["b"][missing]);
+    check(!document["a"]["c"]);
+}
+
+static void test_parse_end(){
+    std::size_t error_offset=0;
+
+    check(static_cast<bool>(cjson::document::parse("[1] \n"sv)));
+    //a terminator counted in the text may only be its last byte
+    check(static_cast<bool>(cjson::document::parse("[1]\0"sv)));
+    check(!cjson::document::parse("[1]\0x"sv,0,&error_offset));
+    check(error_offset==3);
+    check(!cjson::document::parse("[1]\0\0"sv));
+    check(!cjson::document::parse("[1] x"sv));
+    check(!cjson::document::parse("[01]"sv));
+}
+
+static void test_compare(){
+    const cjson::document a=cjson::document::parse(R"({"x":[1,2],"y":null})");
+    const cjson::document b=cjson::document::parse(R"({"y":null,"x":[1,2]})");
+    const cjson::document c=cjson::document::parse(R"({"y":null,"x":[2,1]})");
+
+    check(a.root()==b.root());
+    check(a.root()!=c.root());
+}
+
+int main(){
+    test_lookups();
+    test_parse_end();
+    test_compare();
+
+    return test_result();
+}
@@ -0,0 +1,103 @@
+#include"test.h"
+#include"../cJSON.h"
+
+static const char lazy_json[]="{\"id\":9007199254740993,\"pi\":3.14159265358979323846,\"small\":-42,\"exponent\":1.5E+3,\"list\":[0,-0.0,1e-2]}";
+
+static cJSON *parse_lazy(const char*const json){
+    return cJSON_ParseWithFlags(json,strlen(json),NULL,cJSON_ParseLazyNumbers);
+}
+
+static int prints_as(const cJSON*const item,const char*const expected){
+    char *const printed=cJSON_PrintUnformatted(item);
+    const int same=(printed!=NULL)&&(strcmp(printed,expected)==0);
+
+    if(!same){
+        fprintf(stderr,"printed %s,expected %s\n",(printed!=NULL)?printed:"NULL",expected);
+    }
+    cJSON_free(printed);
+    return same;
+}
+
+//numbers keep their text until read,and are printed as written
+static void test_kept_text(void){
+    cJSON *const tree=parse_lazy(lazy_json);
+    const cJSON *const pi=cJSON_getObjectItem(tree,"pi");
+    const cJSON *const small=cJSON_getObjectItem(tree,"small");
+    long long id=0;
+
+    check(tree!=NULL);
+    check((pi->type&cJSON_NumberIsLazy)!=0);
+    check((pi->type&cJSON_NumberIsConverted)==0);
+    check(prints_as(tree,lazy_json));
+
+    check(cJSON_GetNumberValue(pi)==3.14159265358979323846);
+    check((pi->type&cJSON_NumberIsConverted)!=0);
+    check(cJSON_GetNumberValue(small)==-42);
+    check(small->valueint==-42);
+    check(cJSON_GetNumberValue(cJSON_getObjectItem(tree,"exponent"))==1500);
+    //reading does not change how the number is printed
+    check(prints_as(tree,lazy_json));
+
+    //every digit of a 64 bit id,which a double cannot hold
+    check(cJSON_GetInt64Value(cJSON_getObjectItem(tree,"id"),&id));
+    check(id==9007199254740993LL);
+    check(!cJSON_GetInt64Value(pi,&id));
+
+    cJSON_Delete(tree);
+}
+
+//setting a number drops its text
+static void test_set_number(void){
+    cJSON *const tree=parse_lazy(lazy_json);
+    cJSON *const pi=cJSON_getObjectItem(tree,"pi");
+
+    cJSON_setNumberValue(pi,2.5);
+    check((pi->type&cJSON_NumberIsLazy)==0);
+    check(cJSON_GetNumberValue(pi)==2.5);
+    cJSON_SetIntValue(cJSON_getObjectItem(tree,"small"),7);
+    check(prints_as(tree,"{\"id\":9007199254740993,\"pi\":2.5,\"small\":7,\"exponent\":1.5E+3,\"list\":[0,-0.0,1e-2]}"));
+
+    cJSON_Delete(tree);
+}
+
+//the lazy tree equals the converted one and copies keep the text
+static void test_same_values(void){
+    cJSON *const lazy=parse_lazy(lazy_json);
+    cJSON *const eager=cJSON_Parse(lazy_json);
+    cJSON *const copy=cJSON_Duplicate(lazy,1);
+
+    check(cJSON_Compare(lazy,eager,1));
+    check(cJSON_Compare(copy,eager,1));
+    check(prints_as(copy,lazy_json));
+
+    cJSON_Delete(copy);
+    cJSON_Delete(eager);
+    cJSON_Delete(lazy);
+}
+
+//numbers the parser rejects are rejected with or without the flag
+static void test_invalid_numbers(void){
+    static const char *const inputs[]={"[-]","[1.]","[.5]","[1e]","[1e+]","[+1]","[-a]","[1.5e-3]","[-0]","[12]"};
+    size_t index=0;
+
+    for(index=0;index<sizeof(inputs)/sizeof(inputs[0]);index++){
+        cJSON *const lazy=parse_lazy(inputs[index]);
+        cJSON *const eager=cJSON_ParseWithFlags(inputs[index],strlen(inputs[index]),NULL,0);
+
+        if((lazy==NULL)!=(eager==NULL)){
+            fprintf(stderr,"%s is parsed differently\n",inputs[index]);
+        }
+        check((lazy==NULL)==(eager==NULL));
+        cJSON_Delete(lazy);
+        cJSON_Delete(eager);
+    }
+}
+
+int main(void){
+    test_kept_text();
+    test_set_number();
+    test_same_values();
+    test_invalid_numbers();
+
+    return test_result();
+}
@@ -0,0 +1,121 @@
+/* Parallel and serial prints give the same bytes. Build cJSON with
+ * -DCJSON_PARALLEL for the threads to be used,without it every print is serial. */
+#include"test.h"
+#include"../cJSON.h"
+
+#include<pthread.h>
+#include<stdlib.h>
+
+//wide enough to be split,with large containers inside the chunks
+static cJSON *create_document(void){
+    cJSON *const root=cJSON_CreateObject();
+    cJSON *const rows=cJSON_CreateArray();
+    int index=0;
+
+    for(index=0;index<20000;index++){
+        cJSON *const row=cJSON_CreateObject();
+        char name[32];
+
+        snprintf(name,sizeof(name),"row \"%d\"\n",index);
+        cJSON_AddNumberToObject(row,"id",index);
+        cJSON_AddStringToObject(row,"name",name);
+        cJSON_AddItemToObject(row,"flag",cJSON_CreateBool(index%3==0));
+        if(index%5000==7){
+            cJSON *const wide=cJSON_CreateArray();
+            int element=0;
+
+            for(element=0;element<5000;element++){
+                cJSON_AddItemToArray(wide,(element%2==0)?cJSON_CreateNumber(element*0.25):cJSON_CreateString("caf\xC3\xA9"));
+            }
+            cJSON_AddItemToObject(row,"wide",wide);
+        }
+        cJSON_AddItemToArray(rows,row);
+    }
+    cJSON_AddItemToObject(root,"rows",rows);
+    cJSON_AddItemToObject(root,"empty",cJSON_CreateArray());
+
+    return root;
+}
+
+static void check_same_print(const cJSON*const document,const cJSON_bool format,const int threads){
+    char *const serial=format?cJSON_Print(document):cJSON_PrintUnformatted(document);
+    char *const parallel=cJSON_PrintParallel(document,format,threads);
+
+    check((serial!=NULL)&&(parallel!=NULL));
+    if((serial!=NULL)&&(parallel!=NULL)&&(strcmp(serial,parallel)!=0)){
+        fprintf(stderr,"%s:%d: %d threads,format %d: the prints differ\n",__FILE__,__LINE__,threads,format);
+        test_failures++;
+    }
+    cJSON_free(serial);
+    cJSON_free(parallel);
+}
+
+static void test_same_bytes(const cJSON*const document){
+    static const int threads[]={0,1,2,3,4,8,16};
+    size_t index=0;
+
+    //every print after the first reuses the threads of the pool
+    for(index=0;index<sizeof(threads)/sizeof(threads[0]);index++){
+        check_same_print(document,0,threads[index]);
+        check_same_print(document,1,threads[index]);
+    }
+}
+
+//a tree parsed in parallel prints as the one parsed serially
+static void test_parsed_in_parallel(const cJSON*const document){
+    char *const text=cJSON_PrintUnformatted(document);
+    cJSON *const serial=cJSON_Parse(text);
+    cJSON *const parallel=cJSON_ParseParallel(text,strlen(text),NULL,0,4);
+
+    check(cJSON_Compare(serial,parallel,1));
+    test_same_bytes(parallel);
+
+    cJSON_Delete(serial);
+    cJSON_Delete(parallel);
+    cJSON_free(text);
+}
+
+static void *print_in_thread(void*const document){
+    int round=0;
+
+    for(round=0;round<4;round++){
+        char *const serial=cJSON_PrintUnformatted((const cJSON*)document);
+        char *const parallel=cJSON_PrintParallel((const cJSON*)document,0,4);
+        const int same=(serial!=NULL)&&(parallel!=NULL)&&(strcmp(serial,parallel)==0);
+
+        cJSON_free(serial);
+        cJSON_free(parallel);
+        if(!same){
+            return document;
+        }
+    }
+
+    return NULL;
+}
+
+//several threads share the pool at once
+static void test_concurrent_prints(cJSON*const document){
+    pthread_t threads[4];
+    void *failed=NULL;
+    int index=0;
+
+    for(index=0;index<4;index++){
+        check(pthread_create(&threads[index],NULL,print_in_thread,document)==0);
+    }
+    for(index=0;index<4;index++){
+        check(pthread_join(threads[index],&failed)==0);
+        check(failed==NULL);
+    }
+}
+
+int main(void){
+    cJSON *const document=create_document();
+
+    check(document!=NULL);
+    test_same_bytes(document);
+    test_parsed_in_parallel(document);
+    test_concurrent_prints(document);
+    cJSON_Delete(document);
+
+    return test_result();
+}
@@ -0,0 +1,88 @@
+#include"test.h"
+#include"../cJSON.h"
+
+#include<pthread.h>
+#include<stdlib.h>
+
+static const char pool_json[]="{\"name\":\"pool\",\"values\":[1,2,3,{\"nested\":\"a string longer than the small classes of the pool,so it goes to malloc instead of a chunk,which the pool has to count as well\"}]}";
+
+static size_t counted_allocations=0;
+
+static void *counting_malloc(size_t size){
+    counted_allocations++;
+    return malloc(size);
+}
+
+static cJSON_Hooks counting_hooks={counting_malloc,free};
+
+//whether cJSON_InitHooks took the counting hooks,which are left installed
+static int hooks_switch(void){
+    cJSON *item=NULL;
+
+    counted_allocations=0;
+    cJSON_InitHooks(&counting_hooks);
+    item=cJSON_CreateNull();
+    cJSON_Delete(item);
+
+    return counted_allocations!=0;
+}
+
+//the hooks stay pooled while an item or the thread's chunks are held
+static void test_hooks_rejected(void){
+    cJSON *tree=NULL;
+
+    cJSON_InitPooledHooks();
+    tree=cJSON_Parse(pool_json);
+    check(tree!=NULL);
+    check(!hooks_switch());
+    cJSON_Delete(tree);
+    check(!hooks_switch());
+
+    cJSON_PoolReleaseThread();
+    check(hooks_switch());
+    cJSON_InitHooks(NULL);
+}
+
+#define POOL_TREES 100
+
+static void *parse_trees(void*const trees){
+    int index=0;
+
+    for(index=0;index<POOL_TREES;index++){
+        ((cJSON**)trees)[index]=cJSON_Parse(pool_json);
+    }
+
+    return NULL;
+}
+
+//a thread that ends with its items in use elsewhere leaves its chunks to the last free
+static void test_thread_exit(void){
+    cJSON *trees[POOL_TREES];
+    pthread_t thread;
+    int index=0;
+
+    cJSON_InitPooledHooks();
+    check(pthread_create(&thread,NULL,parse_trees,trees)==0);
+    check(pthread_join(thread,NULL)==0);
+    for(index=0;index<POOL_TREES;index++){
+        char *const printed=cJSON_PrintUnformatted(trees[index]);
+        check((printed!=NULL)&&(strcmp(printed,pool_json)==0));
+        cJSON_free(printed);
+    }
+    check(!hooks_switch());
+
+    for(index=0;index<POOL_TREES;index++){
+        cJSON_Delete(trees[index]);
+    }
+    //returns the last batch of the ended thread's blocks and this thread's own chunks
+    cJSON_PoolReleaseThread();
+    check(hooks_switch());
+    cJSON_InitHooks(NULL);
+}
+
+int main(void){
+    test_hooks_rejected();
+    test_thread_exit();
+
+    return test_result();
+}
@@ -0,0 +1,143 @@
+#include"test.h"
+#include"../cJSON.h"
+
+static const char records[]=
+    "{\"id\":1,\"user\":{\"name\":\"ann\"},\"price\":10.5,\"kind\":\"a\"}\n"
+    "{\"id\":2,\"user\":{\"name\":\"bob\"},\"price\":4,\"kind\":\"b\"}\n"
+    "\n"
+    "{\"id\":3,\"user\":{\"name\":\"cat\"},\"price\":null,\"kind\":\"a\"}\n"
+    "{\"id\":4,\"price\":20,\"kind\":\"a\",\"note\":\"\\\"kind\\\":\\\"b\\\"\"}\n";
+
+//runs and deletes query,the result has to print as expected
+static int query_gives(cJSON_Query*const query,const char*const json,const char*const expected){
+    size_t error_offset=0;
+    cJSON *const result=cJSON_QueryRun(query,json,strlen(json),1,&error_offset);
+    char *const printed=cJSON_PrintUnformatted(result);
+    const int same=(printed!=NULL)&&(strcmp(printed,expected)==0);
+
+    if(!same){
+        fprintf(stderr,"the query gave %s,expected %s\n",(printed!=NULL)?printed:"NULL",expected);
+    }
+    cJSON_free(printed);
+    cJSON_Delete(result);
+    cJSON_DeleteQuery(query);
+    return same;
+}
+
+static void test_where_select(void){
+    cJSON *const five=cJSON_CreateNumber(5);
+    cJSON *const b=cJSON_CreateString("b");
+    cJSON_Query *query=cJSON_CreateQuery(0);
+
+    check(cJSON_QueryWhere(query,"/price",cJSON_QueryGreater,five));
+    check(cJSON_QuerySelect(query,"/id"));
+    check(cJSON_QuerySelect(query,"/user/name"));
+    check(query_gives(query,records,"[{\"/id\":1,\"/user/name\":\"ann\"},{\"/id\":4}]"));
+
+    //the text "kind":"b" inside a string of record 4 does not match
+    query=cJSON_CreateQuery(0);
+    check(cJSON_QueryWhere(query,"/kind",cJSON_QueryEqual,b));
+    check(query_gives(query,records,"[{\"id\":2,\"user\":{\"name\":\"bob\"},\"price\":4,\"kind\":\"b\"}]"));
+
+    query=cJSON_CreateQuery(0);
+    check(cJSON_QueryWhere(query,"/user",cJSON_QueryExists,NULL));
+    check(cJSON_QueryWhere(query,"/kind",cJSON_QueryNotEqual,b));
+    check(cJSON_QuerySelect(query,"/id"));
+    check(query_gives(query,records,"[{\"/id\":1},{\"/id\":3}]"));
+
+    cJSON_Delete(five);
+    cJSON_Delete(b);
+}
+
+static void test_aggregates(void){
+    cJSON_Query *query=cJSON_CreateQuery(0);
+
+    check(cJSON_QueryAggregate(query,cJSON_QueryCount,NULL));
+    check(cJSON_QueryAggregate(query,cJSON_QueryCount,"/price"));
+    check(cJSON_QueryAggregate(query,cJSON_QuerySum,"/price"));
+    check(cJSON_QueryAggregate(query,cJSON_QueryMin,"/price"));
+    check(cJSON_QueryAggregate(query,cJSON_QueryMax,"/price"));
+    check(query_gives(query,records,"{\"count\":4,\"count(/price)\":3,\"sum(/price)\":34.5,\"min(/price)\":4,\"max(/price)\":20}"));
+
+    //no number was seen
+    query=cJSON_CreateQuery(0);
+    check(cJSON_QueryAggregate(query,cJSON_QuerySum,"/missing"));
+    check(query_gives(query,records,"{\"sum(/missing)\":null}"));
+}
+
+static void test_group_by(void){
+    cJSON_Query *query=cJSON_CreateQuery(0);
+
+    check(cJSON_QueryGroupBy(query,"/kind"));
+    check(cJSON_QueryAggregate(query,cJSON_QueryCount,NULL));
+    check(cJSON_QueryAggregate(query,cJSON_QuerySum,"/price"));
+    check(query_gives(query,records,"[{\"key\":\"a\",\"count\":3,\"sum(/price)\":30.5},{\"key\":\"b\",\"count\":1,\"sum(/price)\":4}]"));
+
+    //records without a value are grouped with null
+    query=cJSON_CreateQuery(0);
+    check(cJSON_QueryGroupBy(query,"/user/name"));
+    check(cJSON_QueryAggregate(query,cJSON_QueryCount,NULL));
+    check(query_gives(query,records,"[{\"key\":\"ann\",\"count\":1},{\"key\":\"bob\",\"count\":1},{\"key\":\"cat\",\"count\":1},{\"key\":null,\"count\":1}]"));
+}
+
+//an invalid record fails the query at its offset,even when nothing is read from it
+static void test_invalid_record(void){
+    static const char invalid[]="{\"id\":1}\n{\"id\":2,\"skipped\":[1,}\n";
+    cJSON_Query *const query=cJSON_CreateQuery(0);
+    size_t error_offset=0;
+
+    check(cJSON_QuerySelect(query,"/id"));
+    check(cJSON_QueryRun(query,invalid,strlen(invalid),1,&error_offset)==NULL);
+    //at the '}' that ends the array early
+    check(error_offset==(size_t)(strstr(invalid,",}")-invalid)+1);
+    cJSON_DeleteQuery(query);
+}
+
+typedef struct
+{
+    const char *json;
+    size_t offset;
+}reader_state;
+
+//a few bytes at a time,so records are split across reads
+static size_t read_pieces(void*const context,char*const buffer,size_t size){
+    reader_state *const state=(reader_state*)context;
+    const size_t left=strlen(state->json)-state->offset;
+
+    size=(size<7)?size:7;
+    size=(size<left)?size:left;
+    memcpy(buffer,state->json+state->offset,size);
+    state->offset+=size;
+    return size;
+}
+
+//a reader and several threads give the same result as one pass over the buffer
+static void test_reader_and_threads(void){
+    cJSON_Query *const query=cJSON_CreateQuery(0);
+    reader_state state={records,0};
+    cJSON *expected=NULL;
+    cJSON *result=NULL;
+
+    check(cJSON_QuerySelect(query,"/user/name"));
+    expected=cJSON_QueryRun(query,records,strlen(records),1,NULL);
+    check(expected!=NULL);
+    result=cJSON_QueryRunReader(query,read_pieces,&state,1,NULL);
+    check(cJSON_Compare(result,expected,1));
+    cJSON_Delete(result);
+    result=cJSON_QueryRun(query,records,strlen(records),4,NULL);
+    check(cJSON_Compare(result,expected,1));
+    cJSON_Delete(result);
+
+    cJSON_Delete(expected);
+    cJSON_DeleteQuery(query);
+}
+
+int main(void){
+    test_where_select();
+    test_aggregates();
+    test_group_by();
+    test_invalid_record();
+    test_reader_and_threads();
+
+    return test_result();
+}
@@ -0,0 +1,85 @@
+#include"test.h"
+#include"../cJSON_Schema.hpp"
+
+#include<cstdint>
+#include<optional>
+#include<string>
+#include<string_view>
+#include<vector>
+
+using namespace std::string_view_literals;
+
+struct item{
+    std::int64_t id;
+    std::string name;
+    std::optional<double> price;
+    std::vector<int> tags;
+};
+CJSON_BINDING(item,CJSON_REQUIRED(item,id),CJSON_FIELD(item,name),CJSON_FIELD(item,price),CJSON_FIELD(item,tags))
+
+static bool same(const item&a,const item&b){
+    return (a.id==b.id)&&(a.name==b.name)&&(a.price==b.price)&&(a.tags==b.tags);
+}
+
+/* The fast path takes the exact shape,an unknown member sends the same values
+ * through the tree. Both must give the same result. */
+static void check_paths_agree(const std::string&members){
+    item fast{};
+    item tree{};
+    const bool fast_success=cjson::parse_with_schema("{"+members+"}",fast);
+    const bool tree_success=cjson::parse_with_schema("{\"unknown\":0,"+members+"}",tree);
+
+    if((fast_success!=tree_success)||(fast_success&&!same(fast,tree))){
+        fprintf(stderr,"%s:%d: paths differ for {%s}\n",__FILE__,__LINE__,members.c_str());
+        test_failures++;
+    }
+}
+
+static void test_paths(){
+    check_paths_agree(R"("id":1,"name":"a","price":2.5,"tags":[1,2])");
+    check_paths_agree(R"("id":9007199254740993,"name":"big")");
+    check_paths_agree(R"("id":1,"name":"a\u0000b")");
+    check_paths_agree(R"("id":1,"name":"é😀\"\\")");
+    check_paths_agree(R"("id":1,"price":null)");
+    check_paths_agree(R"("id":1,"price":1e999)");
+    check_paths_agree(R"("id":1.5)");
+    check_paths_agree(R"("id":01)");
+    check_paths_agree(R"("name":"no id")");
+    check_paths_agree(R"("id":1,"tags":[1,"x"])");
+    check_paths_agree(R"("id":1,"name":"\x")");
+    check_paths_agree(std::string("\"id\":1,\"name\":\"a\0b\"",20));
+}
+
+static void test_strings(){
+    item value{};
+
+    check(cjson::parse_with_schema(R"({"id":1,"name":"a\u0000b"})"sv,value));
+    check(value.name=="a");
+}
+
+static void test_trailing_bytes(){
+    item value{};
+    std::size_t error_offset=0;
+
+    check(cjson::parse_with_schema("{\"id\":1}\0"sv,value));
+    check(cjson::parse_with_schema("{\"unknown\":0,\"id\":1}\0"sv,value));
+    //a '\0' may only be the last byte,on the fast path and through the tree
+    check(!cjson::parse_with_schema("{\"id\":1}\0garbage"sv,value,&error_offset));
+    check(error_offset==8);
+    check(!cjson::parse_with_schema("{\"unknown\":0,\"id\":1}\0garbage"sv,value,&error_offset));
+    check(error_offset==20);
+    check(!cjson::parse_with_schema("{\"id\":1} x"sv,value));
+}
+
+static void test_schema_text(){
+    check(cjson::json_schema<item>()==R"({"type":"object","properties":{"id":{"type":"integer"},"name":{"type":"string"},"price":{"type":["number","null"]},"tags":{"type":"array","items":{"type":"integer"}}},"required":["id"]})");
+}
+
+int main(){
+    test_paths();
+    test_strings();
+    test_trailing_bytes();
+    test_schema_text();
+
+    return test_result();
+}
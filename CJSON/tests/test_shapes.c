@@ -0,0 +1,105 @@
+#include"test.h"
+#include"../cJSON.h"
+
+static double field_number(const cJSON*const object,cJSON_Field*const field){
+    return cJSON_GetNumberValue(cJSON_GetFieldItem(object,field));
+}
+
+//rows of one shape are read by index,other shapes and absent keys still work
+static void test_rows(void){
+    static const char rows_json[]="[{\"host\":\"a\",\"port\":1},{\"host\":\"b\",\"port\":2},{\"port\":3,\"host\":\"c\"},{\"host\":\"d\"},{}]";
+    static const char *const hosts[]={"a","b","c","d",NULL};
+    static const double ports[]={1,2,3,0,0};
+    cJSON_Parser *const parser=cJSON_CreateParser(0,0);
+    const cJSON *const rows=cJSON_ParserParse(parser,rows_json,sizeof(rows_json)-1,NULL);
+    cJSON_Field host=cJSON_FieldInit("host");
+    cJSON_Field port=cJSON_FieldInit("port");
+    const cJSON *row=NULL;
+    int round=0;
+    int index=0;
+
+    check(rows!=NULL);
+    check((rows->child->type&cJSON_HasShape)!=0);
+    //the second round only hits the cache for the repeated shape
+    for(round=0;round<2;round++){
+        for(row=rows->child,index=0;row!=NULL;row=row->next,index++){
+            const cJSON *const value=cJSON_GetFieldItem(row,&host);
+            if(hosts[index]==NULL){
+                check(value==NULL);
+            }else{
+                check((value!=NULL)&&(strcmp(value->valuestring,hosts[index])==0));
+            }
+            if(ports[index]==0){
+                check(cJSON_GetFieldItem(row,&port)==NULL);
+            }else{
+                check(field_number(row,&port)==ports[index]);
+            }
+        }
+    }
+    check(cJSON_GetFieldItem(rows,&host)==NULL);
+    check(cJSON_GetFieldItem(NULL,&host)==NULL);
+
+    cJSON_DeleteParser(parser);
+}
+
+//objects without a shape are searched by name
+static void test_without_shape(void){
+    cJSON *const tree=cJSON_Parse("{\"host\":\"a\",\"port\":1}");
+    cJSON_Field port=cJSON_FieldInit("port");
+    cJSON_Field missing=cJSON_FieldInit("missing");
+
+    check((tree->type&cJSON_HasShape)==0);
+    check(field_number(tree,&port)==1);
+    check(cJSON_GetFieldItem(tree,&missing)==NULL);
+
+    cJSON_Delete(tree);
+}
+
+//a field used with a deleted parser is not fooled by a shape at the same address
+static void test_parser_generations(void){
+    static const char first_json[]="{\"a\":1,\"b\":2}";
+    static const char second_json[]="{\"b\":3,\"a\":4}";
+    cJSON_Field b=cJSON_FieldInit("b");
+    cJSON_Parser *parser=cJSON_CreateParser(0,0);
+    int round=0;
+
+    check(field_number(cJSON_ParserParse(parser,first_json,sizeof(first_json)-1,NULL),&b)==2);
+    for(round=0;round<8;round++){
+        cJSON_DeleteParser(parser);
+        parser=cJSON_CreateParser(0,0);
+        if((round%2)==0){
+            check(field_number(cJSON_ParserParse(parser,second_json,sizeof(second_json)-1,NULL),&b)==3);
+        }else{
+            check(field_number(cJSON_ParserParse(parser,first_json,sizeof(first_json)-1,NULL),&b)==2);
+        }
+    }
+
+    cJSON_DeleteParser(parser);
+}
+
+//keys too long to intern give no shape,the field falls back to the search
+static void test_long_keys(void){
+    char json[256];
+    char key[100];
+    cJSON_Parser *const parser=cJSON_CreateParser(0,0);
+    cJSON_Field field=cJSON_FieldInit(key);
+    const cJSON *tree=NULL;
+
+    memset(key,'k',sizeof(key)-1);
+    key[sizeof(key)-1]='\0';
+    snprintf(json,sizeof(json),"{\"%s\":7}",key);
+    tree=cJSON_ParserParse(parser,json,strlen(json),NULL);
+    check(field_number(tree,&field)==7);
+    check(field_number(tree,&field)==7);
+
+    cJSON_DeleteParser(parser);
+}
+
+int main(void){
+    test_rows();
+    test_without_shape();
+    test_parser_generations();
+    test_long_keys();
+
+    return test_result();
+}
@@ -0,0 +1,153 @@
+#include"test.h"
+#include"../cJSON.h"
+
+#include<pthread.h>
+#include<stdlib.h>
+
+static const char base_json[]="{\"x\":{\"y\":[1,2]},\"z\":\"text\"}";
+
+static int prints_as(const cJSON*const item,const char*const expected){
+    char *const printed=cJSON_PrintUnformatted(item);
+    const int same=(printed!=NULL)&&(strcmp(printed,expected)==0);
+
+    if(!same){
+        fprintf(stderr,"printed %s,expected %s\n",(printed!=NULL)?printed:"NULL",expected);
+    }
+    cJSON_free(printed);
+    return same;
+}
+
+//items below the duplicated one are frozen at any depth and refuse changes
+static void test_nested_items_frozen(void){
+    cJSON *const original=cJSON_Parse(base_json);
+    cJSON *const copy=cJSON_DuplicateShared(original);
+    cJSON *const y=cJSON_getObjectItem(cJSON_getObjectItem(copy,"x"),"y");
+    cJSON *const number=cJSON_CreateNumber(3);
+
+    check(copy!=NULL);
+    check(!cJSON_IsShared(original));
+    check(!cJSON_IsShared(copy));
+    check(cJSON_IsShared(cJSON_getObjectItem(original,"x")));
+    check(cJSON_IsShared(y));
+    check(cJSON_IsShared(cJSON_GetArrayItem(y,1)));
+
+    cJSON_AddItemToArray(y,number);
+    check(cJSON_GetArraySize(y)==2);
+    cJSON_InsertItemInArray(y,0,number);
+    check(cJSON_GetArraySize(y)==2);
+    check(!cJSON_ReplaceItemViaPointer(y,cJSON_GetArrayItem(y,0),number));
+    check(cJSON_DetachItemFromArray(y,0)==NULL);
+    cJSON_DeleteItemFromObject(cJSON_getObjectItem(copy,"x"),"y");
+    cJSON_setNumberValue(cJSON_GetArrayItem(y,0),5);
+    check(cJSON_GetNumberValue(cJSON_GetArrayItem(y,0))==1);
+    cJSON_Delete(number);
+
+    check(prints_as(original,base_json));
+    check(prints_as(copy,base_json));
+
+    cJSON_Delete(original);
+    check(prints_as(copy,base_json));
+    cJSON_Delete(copy);
+}
+
+//the Mutable getters copy the path to a change and nothing else
+static void test_path_copy(void){
+    cJSON *const original=cJSON_Parse(base_json);
+    cJSON *const copy=cJSON_DuplicateShared(original);
+    cJSON *x=NULL;
+    cJSON *y=NULL;
+
+    x=cJSON_GetObjectItemMutable(copy,"x");
+    y=cJSON_GetObjectItemMutable(x,"y");
+    check(!cJSON_IsShared(x));
+    check(!cJSON_IsShared(y));
+    cJSON_AddItemToArray(y,cJSON_CreateNumber(3));
+    cJSON_setNumberValue(cJSON_GetArrayItemMutable(y,0),7);
+
+    check(prints_as(original,base_json));
+    check(prints_as(copy,"{\"x\":{\"y\":[7,2,3]},\"z\":\"text\"}"));
+    //the sibling off the path is still the original's
+    check(cJSON_getObjectItem(copy,"z")!=cJSON_getObjectItem(original,"z"));
+    check(cJSON_IsShared(cJSON_getObjectItem(original,"z")));
+
+    //the original changes the same way,through its own copies
+    cJSON_ReplaceItemInArray(cJSON_GetObjectItemMutable(cJSON_GetObjectItemMutable(original,"x"),"y"),1,cJSON_CreateString("two"));
+    cJSON_DeleteItemFromObject(original,"z");
+    check(prints_as(original,"{\"x\":{\"y\":[1,\"two\"]}}"));
+    check(prints_as(copy,"{\"x\":{\"y\":[7,2,3]},\"z\":\"text\"}"));
+
+    cJSON_Delete(copy);
+    cJSON_Delete(original);
+}
+
+//once the other trees are gone the last owner takes its lists back
+static void test_take_back(void){
+    cJSON *const original=cJSON_Parse(base_json);
+    cJSON *const first=cJSON_DuplicateShared(original);
+    cJSON *const second=cJSON_DuplicateShared(original);
+    const cJSON *const x=cJSON_getObjectItem(original,"x");
+    cJSON *y=NULL;
+
+    check(cJSON_getObjectItem(first,"x")==x);
+    check(cJSON_getObjectItem(second,"x")==x);
+    cJSON_Delete(first);
+    cJSON_Delete(second);
+
+    //no copy is made,the items are thawed along the path
+    check(cJSON_GetObjectItemMutable(original,"x")==x);
+    y=cJSON_GetObjectItemMutable(cJSON_GetObjectItemMutable(original,"x"),"y");
+    check(!cJSON_IsShared(y));
+    cJSON_AddItemToArray(y,cJSON_CreateNumber(3));
+    check(prints_as(original,"{\"x\":{\"y\":[1,2,3]},\"z\":\"text\"}"));
+
+    cJSON_Delete(original);
+}
+
+#define SHARED_THREADS 8
+#define SHARED_ROUNDS 200
+
+static void *change_duplicates(void*const original){
+    int round=0;
+
+    for(round=0;round<SHARED_ROUNDS;round++){
+        cJSON *const copy=cJSON_DuplicateShared((const cJSON*)original);
+        cJSON *const y=cJSON_GetObjectItemMutable(cJSON_GetObjectItemMutable(copy,"x"),"y");
+
+        cJSON_AddItemToArray(y,cJSON_CreateNumber(round));
+        cJSON_DeleteItemFromArray(y,0);
+        if((cJSON_GetArraySize(y)!=2)||(cJSON_GetNumberValue(cJSON_GetArrayItem(y,1))!=round)){
+            return original;
+        }
+        cJSON_Delete(copy);
+    }
+
+    return NULL;
+}
+
+//trees sharing lists are changed and deleted in separate threads
+static void test_threads(void){
+    cJSON *const original=cJSON_Parse(base_json);
+    pthread_t threads[SHARED_THREADS];
+    void *failed=NULL;
+    int index=0;
+
+    for(index=0;index<SHARED_THREADS;index++){
+        check(pthread_create(&threads[index],NULL,change_duplicates,original)==0);
+    }
+    for(index=0;index<SHARED_THREADS;index++){
+        check(pthread_join(threads[index],&failed)==0);
+        check(failed==NULL);
+    }
+    check(prints_as(original,base_json));
+
+    cJSON_Delete(original);
+}
+
+int main(void){
+    test_nested_items_frozen();
+    test_path_copy();
+    test_take_back();
+    test_threads();
+
+    return test_result();
+}
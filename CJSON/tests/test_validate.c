@@ -0,0 +1,67 @@
+#include"test.h"
+#include"../cJSON.h"
+
+//cJSON_Validate and cJSON_Parse agree on every input,numbers follow RFC 8259;
+//the parses count the '\0' so that it can be required
+static void check_agree(const char*const json,const cJSON_bool valid){
+    size_t error_offset=0;
+    cJSON *const parsed=cJSON_ParseWithFlags(json,strlen(json)+1,NULL,cJSON_ParseRequireNullTerminated);
+    cJSON *const lazy=cJSON_ParseWithFlags(json,strlen(json)+1,NULL,cJSON_ParseRequireNullTerminated|cJSON_ParseLazyNumbers);
+
+    if((cJSON_Validate(json,strlen(json),&error_offset)!=valid)||((parsed!=NULL)!=valid)||((lazy!=NULL)!=valid)){
+        fprintf(stderr,"%s:%d: %s is not %s everywhere\n",__FILE__,__LINE__,json,valid?"valid":"invalid");
+        test_failures++;
+    }
+    cJSON_Delete(parsed);
+    cJSON_Delete(lazy);
+}
+
+static void test_number_grammar(void){
+    static const char *const valid[]={"0","-0","1","-1","10","0.5","-0.5","1e5","1E5","1e+5","1e-5","1.5e-3","0.0e0","[1,2.5,-3e2]","{\"a\":0}",
+        "123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890"};
+    static const char *const invalid[]={"01","-01","00","1.","-.5",".5","+1","1e","1e+","1E-","1.e3","0x1","1ee2","1e5x","1.5.5","-","--1",
+        "[1.]","{\"a\":01}","[01,2]","[1,2.]","1f","Infinity","NaN","-Infinity"};
+    size_t i=0;
+
+    for(i=0;i<sizeof(valid)/sizeof(valid[0]);i++){
+        check_agree(valid[i],1);
+    }
+    for(i=0;i<sizeof(invalid)/sizeof(invalid[0]);i++){
+        check_agree(invalid[i],0);
+    }
+}
+
+static void test_number_values(void){
+    cJSON *item=cJSON_Parse("[-0.5,1e3,123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890]");
+    cJSON *lazy=cJSON_ParseWithFlags("[1e3]",5,NULL,cJSON_ParseLazyNumbers);
+
+    check(item!=NULL);
+    check(cJSON_GetNumberValue(cJSON_GetArrayItem(item,0))==-0.5);
+    check(cJSON_GetNumberValue(cJSON_GetArrayItem(item,1))==1000);
+    check(cJSON_GetNumberValue(cJSON_GetArrayItem(item,2))>1.2e89);
+    check(lazy!=NULL);
+    check(cJSON_GetNumberValue(cJSON_GetArrayItem(lazy,0))==1000);
+    cJSON_Delete(item);
+    cJSON_Delete(lazy);
+}
+
+static void test_error_offsets(void){
+    size_t error_offset=0;
+
+    check(!cJSON_Validate("[1,01]",6,&error_offset));
+    check(error_offset==3);
+    check(!cJSON_Validate("{\"a\":1.}",8,&error_offset));
+    check(error_offset==5);
+    check(!cJSON_Validate("[1] x",5,&error_offset));
+    check(error_offset==4);
+    //no terminator is needed
+    check(cJSON_Validate("[1,2]xyz",5,&error_offset));
+}
+
+int main(void){
+    test_number_grammar();
+    test_number_values();
+    test_error_offsets();
+
+    return test_result();
+}